@@ -1,10 +1,25 @@
 ﻿#include "app.h"
 #include "file_parser.h"
+#include "query.h"
+#include "collation.h"
+#include "sorter.h"
+#include "formatting.h"
+#include "data_printers.h"
+#include "async_output.h"
+#include "menu_snapshot.h"
+#include "delta_saver.h"
+#include "menu_archive.h"
+#include "mapped_snapshot.h"
+#include "menu_diff.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <iomanip>
+#include <cmath>
 #include <cstdlib> // Для system()
+#include <future>
+#include <map>
+#include <tuple>
 
 // Конструктор с инъекцией зависимостей
 RestaurantMenuApp::RestaurantMenuApp(
@@ -20,7 +35,11 @@ RestaurantMenuApp::RestaurantMenuApp(
 	, printer_(std::move(printer))
 	, fileParser_(std::move(fileParser))
 	, userInputParser_(std::move(userInputParser))
-	, invalidCount_(0) {
+	, invalidCount_(0)
+	, pageSize_(20)
+	, currentPage_(0)
+	, batchMode_(false)
+	, errorCount_(0) {
 	initializeCommands();
 }
 
@@ -28,13 +47,31 @@ RestaurantMenuApp::RestaurantMenuApp(
 void RestaurantMenuApp::initializeCommands() {
 	// Регистрация команд без аргументов
 	commandsMap_["help"] = [this](const std::string&) { cmdHelp(); };
-	commandsMap_["print"] = [this](const std::string&) { cmdPrint(); };
+	commandsMap_["print"] = [this](const std::string& args) { cmdPrint(args); };
 	commandsMap_["clear"] = [this](const std::string&) { cmdClear(); };
 
 	// Регистрация команд с аргументами
 	commandsMap_["add"] = [this](const std::string& args) { cmdAdd(args); };
 	commandsMap_["delete"] = [this](const std::string& args) { cmdDelete(args); };
 	commandsMap_["save"] = [this](const std::string& args) { cmdSave(args); };
+	commandsMap_["find"] = [this](const std::string& args) { cmdFind(args); };
+	commandsMap_["sort"] = [this](const std::string& args) { cmdSort(args); };
+	commandsMap_["view"] = [this](const std::string& args) { cmdView(args); };
+	commandsMap_["unview"] = [this](const std::string& args) { cmdUnview(args); };
+	commandsMap_["stats"] = [this](const std::string&) { cmdStats(); };
+	commandsMap_["next"] = [this](const std::string&) { cmdNext(); };
+	commandsMap_["prev"] = [this](const std::string&) { cmdPrev(); };
+	commandsMap_["pagesize"] = [this](const std::string& args) { cmdPageSize(args); };
+	commandsMap_["wal"] = [this](const std::string& args) { cmdWal(args); };
+	commandsMap_["consolidate"] = [this](const std::string& args) { cmdConsolidate(args); };
+	commandsMap_["archive"] = [this](const std::string& args) { cmdArchive(args); };
+	commandsMap_["watch"] = [this](const std::string& args) { cmdWatch(args); };
+	commandsMap_["diff"] = [this](const std::string& args) { cmdDiff(args); };
+	commandsMap_["merge"] = [this](const std::string& args) { cmdMerge(args); };
+	commandsMap_["load"] = [this](const std::string& args) { cmdLoad(args); };
+	commandsMap_["begin"] = [this](const std::string&) { cmdBegin(); };
+	commandsMap_["commit"] = [this](const std::string&) { cmdCommit(); };
+	commandsMap_["rollback"] = [this](const std::string&) { cmdRollback(); };
 }
 
 /// Обработчик команды help
@@ -42,9 +79,107 @@ void RestaurantMenuApp::cmdHelp(const std::string&) {
 	showHelp();
 }
 
-/// Обработчик команды print
-void RestaurantMenuApp::cmdPrint(const std::string&) {
-	printMenu();
+// Разбирает номер страницы или размер страницы: только цифры, больше нуля
+static bool parsePositive(const std::string& text, size_t& value) {
+	if (text.empty() || text.size() > 9 || !std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+		return false;
+	}
+	value = static_cast<size_t>(std::stoul(text));
+	return value > 0;
+}
+
+/// Обработчик команды print: "print", "print N", "print представление", "print представление N"
+void RestaurantMenuApp::cmdPrint(const std::string& args) {
+	std::istringstream iss(args);
+	std::string first, second;
+	iss >> first >> second;
+
+	size_t page = 0;
+	if (first.empty()) {
+		printMenu();
+	}
+	else if (parsePositive(first, page)) {
+		printPage("", page);
+	}
+	else if (second.empty()) {
+		printView(first);
+	}
+	else if (parsePositive(second, page)) {
+		printPage(first, page);
+	}
+	else {
+		reportError() << "неверный номер страницы \"" << second << "\"" << std::endl;
+	}
+}
+
+/// Обработчик команды next
+void RestaurantMenuApp::cmdNext(const std::string&) {
+	if (currentPage_ == 0) {
+		reportError() << "постраничный вывод не начат. Пример: print 1" << std::endl;
+		return;
+	}
+	printPage(pagedView_, currentPage_ + 1);
+}
+
+/// Обработчик команды prev
+void RestaurantMenuApp::cmdPrev(const std::string&) {
+	if (currentPage_ <= 1) {
+		reportError() << "предыдущей страницы нет" << std::endl;
+		return;
+	}
+	printPage(pagedView_, currentPage_ - 1);
+}
+
+/// Обработчик команды wal: "wal путь", "wal", "wal compact", "wal off"
+void RestaurantMenuApp::cmdWal(const std::string& args) {
+	std::string argument = StringUtils::trim(args);
+	if (argument.empty()) {
+		if (!wal_) {
+			std::cout << "Журнал изменений выключен. Включить: wal путь" << std::endl;
+			return;
+		}
+		WriteAheadLog::Status status = wal_->getStatus();
+		std::cout << "Журнал изменений: поколение " << status.generation << ", записей " << status.records
+			<< ", байт " << status.bytes << ", фиксаций на диск " << status.commits
+			<< (status.compacting ? ", идет уплотнение" : "") << std::endl;
+	}
+	else if (argument == "off") {
+		if (wal_) {
+			wal_.reset();
+			std::cout << "Журнал изменений закрыт" << std::endl;
+		}
+	}
+	else if (argument == "compact") {
+		if (!wal_) {
+			reportError() << "журнал изменений выключен" << std::endl;
+			return;
+		}
+		wal_->compact(storage_->getDishes());
+		std::cout << "Уплотнение журнала запущено в фоне" << std::endl;
+	}
+	else if (wal_) {
+		reportError() << "журнал изменений уже включен. Сначала: wal off" << std::endl;
+	}
+	else {
+		openWal(argument);
+	}
+}
+
+/// Обработчик команды pagesize
+void RestaurantMenuApp::cmdPageSize(const std::string& args) {
+	std::string text = StringUtils::trim(args);
+	size_t size = 0;
+	if (text.empty()) {
+		std::cout << "Размер страницы: " << pageSize_ << std::endl;
+	}
+	else if (parsePositive(text, size)) {
+		pageSize_ = size;
+		currentPage_ = 0;
+		std::cout << "Размер страницы: " << pageSize_ << std::endl;
+	}
+	else {
+		reportError() << "размер страницы должен быть положительным числом" << std::endl;
+	}
 }
 
 /// Обработчик команды clear
@@ -64,19 +199,130 @@ void RestaurantMenuApp::cmdDelete(const std::string& args) {
 
 /// Обработчик команды save
 void RestaurantMenuApp::cmdSave(const std::string& args) {
-	saveMenu(args);
+	// Флаги --binary, --delta, --archive и --background могут стоять до или после имени файла
+	std::istringstream iss(args);
+	std::string token, filename;
+	bool binary = false;
+	bool background = false;
+	bool delta = false;
+	bool archive = false;
+	while (iss >> token) {
+		if (token == "--binary") binary = true;
+		else if (token == "--background") background = true;
+		else if (token == "--delta") delta = true;
+		else if (token == "--archive") archive = true;
+		else filename = filename.empty() ? token : filename + " " + token;
+	}
+
+	if (archive) {
+		if (background || binary || delta) {
+			reportError() << "--archive не сочетается с --binary, --delta и --background" << std::endl;
+			return;
+		}
+		saveArchive(filename);
+		return;
+	}
+
+	if (delta) {
+		if (background || binary) {
+			reportError() << "--delta не сочетается с --binary и --background" << std::endl;
+			return;
+		}
+		saveDelta(filename);
+		return;
+	}
+	saveMenu(filename, binary, background);
+}
+
+/// Обработчик команды find
+void RestaurantMenuApp::cmdFind(const std::string& args) {
+	findDishes(args);
+}
+
+/// Обработчик команды sort
+void RestaurantMenuApp::cmdSort(const std::string& args) {
+	printSorted(args);
+}
+
+/// Обработчик команды view
+void RestaurantMenuApp::cmdView(const std::string& args) {
+	defineView(args);
+}
+
+/// Обработчик команды unview
+void RestaurantMenuApp::cmdUnview(const std::string& args) {
+	std::string name = StringUtils::trim(args);
+	if (storage_->dropView(name)) {
+		std::cout << "Представление \"" << name << "\" удалено" << std::endl;
+	}
+	else {
+		reportError() << "представление \"" << name << "\" не найдено" << std::endl;
+	}
+}
+
+/// Обработчик команды stats
+void RestaurantMenuApp::cmdStats(const std::string&) {
+	printer_->printStats(storage_->getStats());
 }
 
 // Загружает меню из указанного файла
 void RestaurantMenuApp::loadMenu(const std::string& filename) {
 	// Очищаем предыдущее меню перед загрузкой нового
 	clearMenu();
-	fileParser_->parseFile(filename, *storage_, invalidCount_);
-	sorter_->sortAlphabetically(const_cast<std::vector<Dish>&>(storage_->getDishes()));
+	// Путь журнала изменений восстанавливается из снимка и журнала, двоичный снимок
+	// распознается по сигнатуре, остальные файлы читаются как текст
+	if (WriteAheadLog::exists(filename)) {
+		openWal(filename);
+	}
+	else if (MenuSnapshot::isSnapshot(filename)) {
+		// Вместе со снимком применяются его наборы изменений; дальнейшие save --delta продолжат их
+		size_t deltas = deltaSaver_.load(filename, *storage_);
+		std::cout << "Загружен двоичный снимок: " << storage_->getDishesCount() << " блюд";
+		if (deltas > 0) std::cout << " (применено наборов изменений: " << deltas << ")";
+		std::cout << std::endl;
+	}
+	else if (MenuArchive::isArchive(filename)) {
+		MenuArchive::load(filename, *storage_);
+		std::cout << "Загружен архив меню: " << storage_->getDishesCount() << " блюд" << std::endl;
+	}
+	else {
+		fileParser_->parseFile(filename, *storage_, invalidCount_);
+		menuFile_ = filename;
+	}
+	storage_->sortByName();
+}
+
+/// Обработчик команды load: заменяет меню содержимым файла (текст, снимок, архив или журнал изменений)
+void RestaurantMenuApp::cmdLoad(const std::string& args) {
+	std::string filename = StringUtils::trim(args);
+	if (filename.empty()) {
+		reportError() << "укажите файл меню. Пример: load menu.txt" << std::endl;
+		return;
+	}
+
+	// В пакетном режиме журнал загрузки по каждому блюду не выводится
+	if (batchMode_) fileParser_->setLog(nullptr);
+	try {
+		loadMenu(filename);
+		std::cout << "Загружено блюд: " << storage_->getDishesCount() << ", невалидных строк: " << invalidCount_ << std::endl;
+	}
+	catch (const std::exception& e) {
+		reportError() << "не удалось загрузить " << filename << ": " << e.what() << std::endl;
+	}
+	fileParser_->setLog(&std::cout);
 }
 
 // Очищает текущее загруженное меню
 void RestaurantMenuApp::clearMenu() {
+	// Отложенные правки относятся к прежнему меню и к новому не применяются
+	abandonTransaction();
+	if (wal_) {
+		wal_.reset();
+		std::cout << "Журнал изменений закрыт" << std::endl;
+	}
+	deltaSaver_.reset();
+	watcher_.stop();
+	menuFile_.clear();
 	storage_->clear();
 	invalidCount_ = 0;
 }
@@ -95,21 +341,94 @@ void RestaurantMenuApp::runInteractive() {
 
 	while (true) {
 		std::cout << std::endl << "Введите команду: ";
-		std::getline(std::cin, input);
+		AsyncOutput::drainConsole();
+		// Конец ввода (закрытый канал) завершает режим так же, как exit
+		if (!std::getline(std::cin, input)) input = "exit";
 
 		if (input == "exit") {
+			abandonTransaction();
+			reportBackgroundSaves(true);
 			std::cout << "Выход из интерактивного режима..." << std::endl;
 			break;
 		}
 
+		// Команда выполняется уже над меню с правками, сделанными в файле, пока приложение ждало ввода
+		applyFileChanges();
 		processCommand(input);
+		reportBackgroundSaves();
+		maintainWal();
 	}
 }
 
+// Выполняет сценарий: тот же разбор команд, что и в интерактивном режиме, но без приглашений
+int RestaurantMenuApp::runBatch(std::istream& input) {
+	batchMode_ = true;
+	errorCount_ = 0;
+	std::string line;
+	while (std::getline(input, line)) {
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		std::string command = StringUtils::trim(line);
+		if (command.empty() || command[0] == '#') continue;
+		if (command == "exit") break;
+
+		applyFileChanges();
+		processCommand(command);
+		reportBackgroundSaves();
+		maintainWal();
+	}
+	abandonTransaction();
+	reportBackgroundSaves(true);
+	batchMode_ = false;
+	return errorCount_ == 0 ? 0 : 1;
+}
+
+// Начинает сообщение об ошибке и учитывает ее
+std::ostream& RestaurantMenuApp::reportError() const {
+	errorCount_++;
+	return std::cout << "ERROR: ";
+}
+
 // Обрабатывает введенную пользователем команду
 void RestaurantMenuApp::processCommand(const std::string& command) {
 	if (command.empty()) return;
 
+	// Опция --format=имя действует только на эту команду: принтер подменяется на время ее выполнения.
+	// Опцией считается только отдельное слово вне кавычек, чтобы не задеть название блюда
+	const std::string option = "--format=";
+	size_t position = std::string::npos;
+	bool quoted = false;
+	for (size_t i = 0; i < command.size(); ++i) {
+		if (command[i] == '"') {
+			quoted = !quoted;
+		}
+		else if (!quoted && (i == 0 || command[i - 1] == ' ') && command.compare(i, option.size(), option) == 0) {
+			position = i;
+			break;
+		}
+	}
+	if (position != std::string::npos) {
+		size_t end = command.find(' ', position);
+		std::string format = command.substr(position + option.size(), end == std::string::npos ? std::string::npos : end - position - option.size());
+		std::unique_ptr<IMenuPrinter> commandPrinter = PrinterFormats::create(format);
+		if (!commandPrinter) {
+			reportError() << "неизвестный формат \"" << format << "\". Доступны: " << PrinterFormats::names() << std::endl;
+			return;
+		}
+
+		std::string rest = command.substr(0, position) + (end == std::string::npos ? "" : command.substr(end + 1));
+		std::swap(printer_, commandPrinter);
+		dispatchCommand(StringUtils::trim(rest));
+		std::swap(printer_, commandPrinter);
+		return;
+	}
+
+	dispatchCommand(command);
+}
+
+// Выполняет команду из карты или фильтрацию
+void RestaurantMenuApp::dispatchCommand(const std::string& command) {
+	if (command.empty()) return;
+
 	std::istringstream iss(command);
 	std::string cmd;
 	iss >> cmd;
@@ -164,108 +483,189 @@ void RestaurantMenuApp::processUserInput(const std::string& input) {
 			printer_->printFilteredDishes(filtered, "Блюда, готовящиеся быстрее " + time.toString());
 		}
 		else {
-			std::cout << "Некорректные критерии фильтрации!" << std::endl;
+			reportError() << "некорректные критерии фильтрации!" << std::endl;
 		}
 	}
 	else {
-		std::cout << "ОШИБКА: " << errorMessage << std::endl;
+		reportError() << errorMessage << std::endl;
 		std::cout << "Неизвестная команда или некорректный ввод! Введите 'help' для справки." << std::endl;
 	}
 }
 
 // Добавляет новое блюдо в меню
 void RestaurantMenuApp::addDish(const std::string& dishData) {
-	// Создаем временный парсер для извлечения значений
-	MenuFileParser parser;
 	std::string name;
 	double price = 0.0;
 	Time time;
 
-	if (parser.extractValuesWithRegex(dishData, name, price, time)) {
+	if (lineParser_.extractValuesWithRegex(dishData, name, price, time)) {
 		// Дополнительная проверка: название не должно быть пустым (двойная проверка для надежности)
 		if (name.empty()) {
-			std::cout << "ERROR: название блюда не может быть пустым!" << std::endl;
+			reportError() << "название блюда не может быть пустым!" << std::endl;
 			return;
 		}
 
 		if (price <= 0) {
-			std::cout << "ERROR: цена должна быть положительной!" << std::endl;
+			reportError() << "цена должна быть положительной!" << std::endl;
+			return;
+		}
+
+		std::string message = "Блюдо добавлено: " + name + " (цена: ";
+		DishFormat::appendPrice(message, price);
+		message += ", время: ";
+		DishFormat::appendTime(message, time);
+		message += ")";
+
+		// В транзакции блюдо только откладывается: хранилище и сортировка не затрагиваются до commit
+		if (transaction_) {
+			transaction_->add(name, price, time);
+			std::cout << message << " - до commit" << std::endl;
 			return;
 		}
 
 		// Передаём полный объект Time
 		storage_->addDish(name, price, time);
-		std::cout << "Блюдо добавлено: " << name << " (цена: " << price << ", время: " << time.toString() << ")" << std::endl;
+		if (wal_) wal_->logAdd(name, price, time);
+		if (syncWal()) std::cout << message << std::endl;
 
-		// Пересортируем меню по алфавиту
-		sorter_->sortAlphabetically(const_cast<std::vector<Dish>&>(storage_->getDishes()));
+		// Меню уже отсортировано по алфавиту: новое блюдо переносится на свое место сдвигом, без полной сортировки
+		storage_->sortByName();
 	}
 	else {
-		std::cout << "ERROR: неверный формат данных! Используйте: \"Название блюда\" цена время" << std::endl;
+		reportError() << "неверный формат данных! Используйте: \"Название блюда\" цена время" << std::endl;
 		std::cout << "Пример: add \"Пицца Маргарита\" 12.50 00:30" << std::endl;
 	}
 }
 
 // Удаляет блюдо из меню
 void RestaurantMenuApp::deleteDish(const std::string& dishData) {
-	std::string trimmedData = dishData;
-
 	// Проверяем, есть ли кавычки в данных
 	if (dishData.find('"') == std::string::npos) {
 		// Если кавычек нет, удаляем только по названию
 		std::string name = dishData;
-		size_t removedCount = storage_->getDishesCount();
-
-		// Создаем временное хранилище для блюд, которые не нужно удалять
-		std::vector<Dish> remainingDishes;
-		for (const auto& dish : storage_->getDishes()) {
-			if (dish.name != name) {
-				remainingDishes.push_back(dish);
-			}
+		if (transaction_) {
+			transaction_->removeName(name);
+			std::cout << "Удаление блюд с названием \"" << name << "\" - до commit" << std::endl;
+			return;
 		}
+		size_t removedCount = removeDishesByName(name);
 
-		// Очищаем основное хранилище и добавляем обратно только нужные блюда
-		storage_->clear();
-		for (const auto& dish : remainingDishes) {
-			storage_->addDish(dish.name, dish.price, dish.time);
+		if (removedCount > 0) {
+			std::cout << "Удалено блюд с названием \"" << name << "\": " << removedCount << std::endl;
+			return;
 		}
 
-		size_t newCount = storage_->getDishesCount();
-		if (newCount < removedCount) {
-			std::cout << "Удалено блюд с названием \"" << name << "\": " << (removedCount - newCount) << std::endl;
+		std::cout << "WARNING: Блюда с названием \"" << name << "\" не найдены" << std::endl;
+
+		// Предлагаем похожие названия и удаляем выбранное после подтверждения
+		std::vector<std::string> suggestions = suggestNames(name);
+		if (suggestions.empty()) return;
+
+		std::cout << "Возможно, вы имели в виду:" << std::endl;
+		for (size_t i = 0; i < suggestions.size(); ++i) {
+			std::cout << "  " << (i + 1) << ". " << suggestions[i] << std::endl;
 		}
-		else {
-			std::cout << "WARNING: Блюда с названием \"" << name << "\" не найдены" << std::endl;
+		// В пакетном режиме спросить некого: похожее блюдо без подтверждения не удаляется
+		if (batchMode_) return;
+		std::cout << "Введите номер блюда для удаления или n для отмены: ";
+
+		std::string answer;
+		AsyncOutput::drainConsole();
+		std::getline(std::cin, answer);
+		answer = StringUtils::trim(answer);
+
+		size_t choice = StringUtils::isOnlyDigits(answer) && answer.size() < 4 ? std::stoul(answer) : 0;
+		if (choice == 0 || choice > suggestions.size()) {
+			std::cout << "Удаление отменено." << std::endl;
+			return;
 		}
+
+		const std::string& chosen = suggestions[choice - 1];
+		std::cout << "Удалено блюд с названием \"" << chosen << "\": " << removeDishesByName(chosen) << std::endl;
 	}
 	else {
 		// Если есть кавычки, используем полный парсинг
-		MenuFileParser parser;
 		std::string name;
 		double price = 0.0;
 		Time time;
 
-		if (parser.extractValuesWithRegex(dishData, name, price, time)) {
-			if (storage_->removeDish(name, price, time)) {
-				std::cout << "Блюдо удалено: " << name << std::endl;
+		if (lineParser_.extractValuesWithRegex(dishData, name, price, time)) {
+			if (transaction_) {
+				transaction_->remove(name, price, time);
+				std::cout << "Удаление блюда " << name << " - до commit" << std::endl;
+			}
+			else if (storage_->removeDish(name, price, time)) {
+				if (wal_) wal_->logRemove(name, price, time);
+				if (syncWal()) std::cout << "Блюдо удалено: " << name << std::endl;
 			}
 			else {
 				std::cout << "WARNING: Блюдо не найдено: " << name << std::endl;
+				printSuggestions(name);
 			}
 		}
 		else {
-			std::cout << "ERROR: неверный формат данных! Используйте: delete <Название блюда> или delete \"Название\" цена время" << std::endl;
+			reportError() << "неверный формат данных! Используйте: delete <Название блюда> или delete \"Название\" цена время" << std::endl;
 		}
 	}
 }
 
+// Удаляет все блюда с указанным названием и возвращает их количество
+size_t RestaurantMenuApp::removeDishesByName(const std::string& name) {
+	size_t initialCount = storage_->getDishesCount();
+
+	// Собираем различные варианты блюда и удаляем каждый из хранилища
+	std::vector<std::pair<double, Time>> variants;
+	for (const auto& dish : storage_->getDishes()) {
+		if (dish.name == name) {
+			variants.emplace_back(dish.price, dish.time);
+		}
+	}
+	for (const auto& variant : variants) {
+		storage_->removeDish(name, variant.first, variant.second);
+	}
+	// Удаление всех вариантов - одна запись журнала
+	if (wal_ && !variants.empty()) {
+		wal_->logRemoveName(name);
+		syncWal();
+	}
+
+	return initialCount - storage_->getDishesCount();
+}
+
+// Возвращает названия, похожие на введенное с опечатками
+std::vector<std::string> RestaurantMenuApp::suggestNames(const std::string& text) const {
+	const size_t maxSuggestions = 5;
+	// Для коротких названий допускаем одну опечатку, для остальных - две
+	size_t maxDistance = Collation::primaryWeights(text).size() <= 4 ? 1 : 2;
+	return storage_->findSimilarNames(text, maxDistance, maxSuggestions);
+}
+
+// Выводит похожие названия одной строкой, если они есть
+void RestaurantMenuApp::printSuggestions(const std::string& text) const {
+	std::vector<std::string> suggestions = suggestNames(text);
+	if (suggestions.empty()) return;
+
+	std::cout << "Возможно, вы имели в виду: ";
+	for (size_t i = 0; i < suggestions.size(); ++i) {
+		std::cout << (i > 0 ? ", " : "") << "\"" << suggestions[i] << "\"";
+	}
+	std::cout << std::endl;
+}
+
 // Сохраняет текущее меню в файл
-void RestaurantMenuApp::saveMenu(const std::string& filename) const {
-	if (filename == "menu.txt") {
+void RestaurantMenuApp::saveMenu(const std::string& filename, bool binary, bool background) {
+	saveDishes(storage_->getDishes(), filename, binary, background);
+}
+
+// Записывает блюда в файл; все записи полного меню идут через эту функцию
+void RestaurantMenuApp::saveDishes(const std::vector<Dish>& dishes, const std::string& filename, bool binary, bool background) {
+	// В пакетном режиме сценарий сам указал файл, подтверждение не запрашивается
+	if (filename == "menu.txt" && !batchMode_) {
 		std::cout << "WARNING: вы пытаетесь сохранить в файл menu.txt. Это перезапишет исходный файл меню." << std::endl;
 		std::cout << "Продолжить? (y/n): ";
 
 		std::string answer;
+		AsyncOutput::drainConsole();
 		std::getline(std::cin, answer);
 
 		if (answer != "y" && answer != "Y") {
@@ -274,17 +674,684 @@ void RestaurantMenuApp::saveMenu(const std::string& filename) const {
 		}
 	}
 
+	// Полная запись заменяет базу разностных сохранений этого файла
+	deltaSaver_.forget(filename);
+
+	// Фоновое сохранение пишет копию меню: последующие команды на сохраняемые данные не влияют
+	if (background) {
+		saver_.start(dishes, filename, binary);
+		std::cout << "Сохранение в " << filename << " выполняется в фоне" << std::endl;
+		return;
+	}
+
+	waitForBackgroundSave(filename);
 	try {
-		storage_->saveToFile(filename);
-		std::cout << "Меню успешно сохранено в файл: " << filename << std::endl;
+		if (binary) {
+			MenuSnapshot::save(dishes, filename);
+		}
+		else {
+			MenuTextFile::save(dishes, filename);
+		}
+		// Собственное сохранение в отслеживаемый файл не должно читаться как правка
+		if (filename == watcher_.path()) watcher_.rebase();
+		std::cout << "Меню успешно сохранено в " << (binary ? "двоичный снимок: " : "файл: ") << filename << std::endl;
 	}
 	catch (const std::exception& e) {
-		std::cout << "ERROR: Ошибка при сохранении: " << e.what() << std::endl;
+		reportError() << "Ошибка при сохранении: " << e.what() << std::endl;
+	}
+}
+
+// Синхронная запись после фоновой в тот же файл: иначе более старая копия меню могла бы заменить новую
+void RestaurantMenuApp::waitForBackgroundSave(const std::string& filename) {
+	if (!saver_.isSaving(filename)) return;
+	std::cout << "Ожидание фонового сохранения в " << filename << "..." << std::endl;
+	saver_.wait();
+}
+
+// Сохраняет меню набором изменений или, если нужно, полной базой
+void RestaurantMenuApp::saveDelta(const std::string& filename) {
+	waitForBackgroundSave(filename);
+	try {
+		size_t written = 0;
+		switch (deltaSaver_.save(*storage_, filename, written)) {
+		case DeltaSaver::Result::Full:
+			std::cout << "Записана база " << filename << ": " << written << " блюд" << std::endl;
+			break;
+		case DeltaSaver::Result::Delta:
+			std::cout << "Записан набор изменений для " << filename << ": " << written << " изменений" << std::endl;
+			break;
+		case DeltaSaver::Result::Unchanged:
+			std::cout << "Изменений с прошлого сохранения нет" << std::endl;
+			break;
+		case DeltaSaver::Result::Consolidated:
+			std::cout << "Наборы изменений объединены с базой " << filename << ": " << written << " блюд" << std::endl;
+			break;
+		}
+	}
+	catch (const std::exception& e) {
+		reportError() << "Ошибка при сохранении: " << e.what() << std::endl;
+	}
+}
+
+/// Обработчик команды consolidate: объединяет базу с наборами изменений
+void RestaurantMenuApp::cmdConsolidate(const std::string& args) {
+	std::string filename = StringUtils::trim(args);
+	try {
+		size_t applied = DeltaSaver::consolidate(filename);
+		// База сменилась: следующее разностное сохранение начнется с полной записи
+		deltaSaver_.reset();
+		std::cout << "База " << filename << " объединена с наборами изменений: " << applied << std::endl;
+	}
+	catch (const std::exception& e) {
+		reportError() << e.what() << std::endl;
+	}
+}
+
+// Выводит блюда снимка по условию; Dish создаются только для подходящих строк
+void RestaurantMenuApp::printMapped(const std::string& args) const {
+	std::istringstream iss(args);
+	std::string filename, condition;
+	iss >> filename;
+	std::getline(iss, condition);
+	if (filename.empty()) {
+		reportError() << "укажите файл снимка. Пример: /map menu.bin <10.00" << std::endl;
+		return;
+	}
+
+	DishPredicate predicate = DishPredicate::any();
+	std::string errorMessage;
+	if (!StringUtils::trim(condition).empty() && !parseViewCondition(condition, predicate, errorMessage)) {
+		reportError() << errorMessage << ". Пример: /map menu.bin >50" << std::endl;
+		return;
+	}
+
+	try {
+		MappedSnapshot snapshot(filename);
+		std::vector<size_t> rows = snapshot.select(predicate);
+		printer_->printFilteredDishes(snapshot.dishes(rows), "Снимок " + filename + " (только чтение): " +
+			std::to_string(rows.size()) + " из " + std::to_string(snapshot.size()) + " блюд");
+	}
+	catch (const std::exception& e) {
+		reportError() << e.what() << std::endl;
+	}
+}
+
+// Сохраняет меню в колоночный архив
+void RestaurantMenuApp::saveArchive(const std::string& filename) {
+	waitForBackgroundSave(filename);
+	deltaSaver_.forget(filename);
+	try {
+		MenuArchive::save(storage_->getDishes(), filename);
+		std::cout << "Меню успешно сохранено в архив: " << filename << std::endl;
+	}
+	catch (const std::exception& e) {
+		reportError() << "Ошибка при сохранении: " << e.what() << std::endl;
+	}
+}
+
+/// Обработчик команды archive: "archive файл условия" заменяет меню блюдами архива,
+/// удовлетворяющими условию; блоки архива, в которых таких блюд нет, не читаются
+void RestaurantMenuApp::cmdArchive(const std::string& args) {
+	std::istringstream iss(args);
+	std::string filename, condition;
+	iss >> filename;
+	std::getline(iss, condition);
+	if (filename.empty()) {
+		reportError() << "укажите файл архива. Пример: archive menu.rma <10.00 <00:20" << std::endl;
+		return;
+	}
+
+	// Без условия загружается весь архив
+	DishPredicate predicate = DishPredicate::any();
+	std::string errorMessage;
+	if (!StringUtils::trim(condition).empty() && !parseViewCondition(condition, predicate, errorMessage)) {
+		reportError() << errorMessage << ". Пример: archive menu.rma >50" << std::endl;
+		return;
+	}
+	if (!MenuArchive::isArchive(filename)) {
+		reportError() << filename << " не является архивом меню" << std::endl;
+		return;
+	}
+
+	clearMenu();
+	try {
+		MenuArchive::LoadStats stats = MenuArchive::load(filename, *storage_, predicate);
+		storage_->sortByName();
+		std::cout << "Загружено блюд: " << stats.rowsLoaded << " (прочитано блоков " << stats.blocksRead
+			<< " из " << stats.blocks << ", просмотрено строк: " << stats.rowsScanned << ")" << std::endl;
+	}
+	catch (const std::exception& e) {
+		reportError() << e.what() << std::endl;
+	}
+}
+
+// Включает журнал изменений; существующий журнал заменяет текущее меню восстановленным
+void RestaurantMenuApp::openWal(const std::string& base) {
+	try {
+		WriteAheadLog::Recovery recovery;
+		wal_ = std::make_unique<WriteAheadLog>(base, *storage_, recovery);
+		if (recovery.found) {
+			abandonTransaction();
+			invalidCount_ = 0;
+			storage_->sortByName();
+			std::cout << "Меню восстановлено из журнала " << base << ": снимок " << recovery.snapshotDishes
+				<< " блюд, применено изменений: " << recovery.replayed << std::endl;
+			if (recovery.tornTail) {
+				std::cout << "WARNING: конец журнала оборван (сбой во время записи), неполная запись отброшена" << std::endl;
+			}
+		}
+		else {
+			std::cout << "Журнал изменений создан: " << base << std::endl;
+		}
+	}
+	catch (const std::exception& e) {
+		wal_.reset();
+		reportError() << "не удалось открыть журнал изменений: " << e.what() << std::endl;
+	}
+}
+
+/// Обработчик команды watch: "watch" - отслеживать загруженный файл или показать состояние, "watch off" - перестать
+void RestaurantMenuApp::cmdWatch(const std::string& args) {
+	std::string mode = StringUtils::trim(args);
+	if (mode == "off") {
+		if (watcher_.active()) std::cout << "Отслеживание файла " << watcher_.path() << " остановлено" << std::endl;
+		watcher_.stop();
+		return;
+	}
+	if (!mode.empty()) {
+		reportError() << "неизвестный режим \"" << mode << "\". Используйте: watch или watch off" << std::endl;
+		return;
+	}
+	if (watcher_.active()) {
+		std::cout << "Отслеживается файл " << watcher_.path() << ": правки применяются перед каждой командой" << std::endl;
+		return;
+	}
+	if (menuFile_.empty()) {
+		reportError() << "отслеживать можно только загруженный текстовый файл меню" << std::endl;
+		return;
+	}
+
+	try {
+		watcher_.watch(menuFile_);
+		std::cout << "Отслеживается файл " << menuFile_ << ": правки применяются перед каждой командой" << std::endl;
+	}
+	catch (const std::exception& e) {
+		reportError() << e.what() << std::endl;
+	}
+}
+
+// Количество копий блюда в отсортированном по алфавиту меню с тем же сравнением, что у removeDish
+static size_t countCopies(const std::vector<Dish>& dishes, const Dish& dish) {
+	auto range = std::equal_range(dishes.begin(), dishes.end(), dish, [](const Dish& a, const Dish& b) {
+		return Collation::compare(a.sortKey, b.sortKey) < 0;
+	});
+	return static_cast<size_t>(std::count_if(range.first, range.second, [&](const Dish& other) {
+		return other.name == dish.name && std::fabs(other.price - dish.price) < 0.001 && other.time == dish.time;
+	}));
+}
+
+/// Обработчик команды begin
+void RestaurantMenuApp::cmdBegin(const std::string&) {
+	if (beginTransaction()) {
+		std::cout << "Транзакция начата: add и delete применяются при commit" << std::endl;
+	}
+	else {
+		reportError() << "транзакция уже начата" << std::endl;
+	}
+}
+
+/// Обработчик команды commit
+void RestaurantMenuApp::cmdCommit(const std::string&) {
+	if (!commitTransaction()) {
+		reportError() << "транзакция не начата (begin)" << std::endl;
+	}
+}
+
+/// Обработчик команды rollback
+void RestaurantMenuApp::cmdRollback(const std::string&) {
+	const size_t pending = transaction_ ? transaction_->size() : 0;
+	if (rollbackTransaction()) {
+		std::cout << "Транзакция отменена, отброшено изменений: " << pending << std::endl;
+	}
+	else {
+		reportError() << "транзакция не начата (begin)" << std::endl;
+	}
+}
+
+// Начинает транзакцию
+bool RestaurantMenuApp::beginTransaction() {
+	if (transaction_) return false;
+	transaction_ = std::make_unique<MenuTransaction>();
+	return true;
+}
+
+// Фиксирует транзакцию: журнал получает итоговые удаления и добавления, хранилище уплотняется
+// и сливается с отсортированными добавлениями за один проход, без сортировки всего меню
+bool RestaurantMenuApp::commitTransaction() {
+	if (!transaction_) return false;
+	std::unique_ptr<MenuTransaction> transaction = std::move(transaction_);
+	std::vector<Dish> added = transaction->takeAdded();
+
+	// Удаления применяются к меню до транзакции, поэтому в журнале они идут перед добавлениями
+	if (wal_) {
+		for (const auto& name : transaction->removedNames()) wal_->logRemoveName(name);
+		for (const auto& dish : transaction->removed()) wal_->logRemove(dish.name, dish.price, dish.time);
+		for (const auto& dish : added) wal_->logAdd(dish.name, dish.price, dish.time);
+	}
+
+	const size_t addedCount = added.size();
+	std::function<bool(const Dish&)> removes;
+	if (transaction->hasRemovals()) {
+		removes = [&transaction](const Dish& dish) { return transaction->removes(dish); };
+	}
+	const size_t removedCount = storage_->applyBatch(std::move(added), removes);
+
+	// Записи транзакции фиксируются одним fsync, пока хранилище применяет пакет
+	syncWal();
+	std::cout << "Транзакция зафиксирована: добавлено блюд " << addedCount << ", удалено " << removedCount << std::endl;
+	return true;
+}
+
+// Отменяет транзакцию: буферы просто освобождаются
+bool RestaurantMenuApp::rollbackTransaction() {
+	if (!transaction_) return false;
+	transaction_.reset();
+	return true;
+}
+
+// Отбрасывает незафиксированную транзакцию при выходе или замене меню
+void RestaurantMenuApp::abandonTransaction() {
+	if (!transaction_) return;
+	reportError() << "транзакция не зафиксирована (commit), отброшено изменений: " << transaction_->size() << std::endl;
+	transaction_.reset();
+}
+
+// Применяет разницу строк файла: сначала удаления, затем добавления и одна сортировка в конце.
+// Хранилище обновляет индексы, представления и статистику на каждом изменении, журнал изменений получает те же записи
+void RestaurantMenuApp::applyFileChanges() {
+	if (!watcher_.active()) return;
+	// Собственное фоновое сохранение в отслеживаемый файл - не правка: пока оно идет, файл не проверяется,
+	// а завершенное сначала перебазирует отслеживание (результат публикуется вместе со снятием отметки isSaving)
+	if (saver_.isSaving(watcher_.path())) return;
+	reportBackgroundSaves();
+
+	MenuFileWatcher::Changes changes;
+	try {
+		if (!watcher_.poll(changes)) return;
+	}
+	catch (const std::exception& e) {
+		reportError() << e.what() << ". Отслеживание файла остановлено" << std::endl;
+		watcher_.stop();
+		return;
+	}
+
+	// removeDish убирает все одинаковые блюда, поэтому копии, оставшиеся в файле, возвращаются
+	std::map<std::tuple<std::string, double, long long>, std::pair<const Dish*, size_t>> removedGroups;
+	for (const auto& dish : changes.removed) {
+		auto& group = removedGroups[std::make_tuple(dish.name, dish.price, dish.totalMinutes())];
+		group.first = &dish;
+		group.second++;
+	}
+
+	std::vector<const Dish*> restored;
+	size_t removedCount = 0;
+	for (const auto& entry : removedGroups) {
+		const Dish& dish = *entry.second.first;
+		const size_t copies = countCopies(storage_->getDishes(), dish);
+		if (copies == 0) continue;
+		storage_->removeDish(dish.name, dish.price, dish.time);
+		if (wal_) wal_->logRemove(dish.name, dish.price, dish.time);
+		const size_t removed = std::min(copies, entry.second.second);
+		removedCount += removed;
+		for (size_t i = removed; i < copies; ++i) restored.push_back(&dish);
+	}
+
+	for (const Dish* dish : restored) {
+		storage_->addDish(dish->name, dish->price, dish->time);
+		if (wal_) wal_->logAdd(dish->name, dish->price, dish->time);
+	}
+	for (const auto& dish : changes.added) {
+		storage_->addDish(dish.name, dish.price, dish.time);
+		if (wal_) wal_->logAdd(dish.name, dish.price, dish.time);
+	}
+	invalidCount_ = std::max(0, invalidCount_ + changes.invalidAdded - changes.invalidRemoved);
+	storage_->sortByName();
+	syncWal();
+
+	std::cout << "Файл " << watcher_.path() << " изменен: добавлено блюд " << changes.added.size()
+		<< ", удалено " << removedCount << " (сравнено строк: " << changes.linesCompared << ")" << std::endl;
+}
+
+// Загружает два файла меню параллельно: первый в отдельном потоке, второй в текущем
+static void loadBoth(const std::string& firstFile, const std::string& secondFile,
+	std::vector<Dish>& first, std::vector<Dish>& second) {
+	int firstInvalid = 0;
+	int secondInvalid = 0;
+	std::future<std::vector<Dish>> pending = std::async(std::launch::async, [&]() {
+		return MenuDiff::loadSorted(firstFile, firstInvalid);
+	});
+	try {
+		second = MenuDiff::loadSorted(secondFile, secondInvalid);
+	}
+	catch (...) {
+		pending.wait();
+		throw;
+	}
+	first = pending.get();
+	if (firstInvalid > 0) std::cout << "WARNING: в " << firstFile << " пропущено невалидных строк: " << firstInvalid << std::endl;
+	if (secondInvalid > 0) std::cout << "WARNING: в " << secondFile << " пропущено невалидных строк: " << secondInvalid << std::endl;
+}
+
+/// Обработчик команды diff: "diff файлA файлB" - добавленные, удаленные и изменившиеся блюда
+void RestaurantMenuApp::cmdDiff(const std::string& args) {
+	std::istringstream iss(args);
+	std::string firstFile, secondFile, extra;
+	iss >> firstFile >> secondFile >> extra;
+	if (secondFile.empty() || !extra.empty()) {
+		reportError() << "укажите два файла. Пример: diff menu_old.txt menu.txt" << std::endl;
+		return;
+	}
+
+	try {
+		std::vector<Dish> first, second;
+		loadBoth(firstFile, secondFile, first, second);
+		MenuDiff::Result diff = MenuDiff::compare(first, second);
+
+		std::cout << "Сравнение " << firstFile << " -> " << secondFile << ": без изменений " << diff.unchanged
+			<< ", добавлено " << diff.added.size() << ", удалено " << diff.removed.size()
+			<< ", изменено " << diff.changed.size() << std::endl;
+
+		std::vector<Dish> rows;
+		if (!diff.added.empty()) {
+			for (size_t j : diff.added) rows.push_back(second[j]);
+			printer_->printFilteredDishes(rows, "Добавлены:");
+		}
+		if (!diff.removed.empty()) {
+			rows.clear();
+			for (size_t i : diff.removed) rows.push_back(first[i]);
+			printer_->printFilteredDishes(rows, "Удалены:");
+		}
+		if (!diff.changed.empty()) {
+			std::cout << std::endl << "Изменены:" << std::endl;
+			std::string line;
+			for (const auto& pair : diff.changed) {
+				const Dish& before = first[pair.first];
+				const Dish& after = second[pair.second];
+				line.assign("  ");
+				line.append(before.name);
+				line.append(": ");
+				DishFormat::appendPrice(line, before.price);
+				line.push_back(' ');
+				DishFormat::appendTime(line, before.time);
+				line.append(" -> ");
+				DishFormat::appendPrice(line, after.price);
+				line.push_back(' ');
+				DishFormat::appendTime(line, after.time);
+				std::cout << line << std::endl;
+			}
+		}
+	}
+	catch (const std::exception& e) {
+		reportError() << e.what() << std::endl;
+	}
+}
+
+/// Обработчик команды merge: "merge файлA файлB [--prefer=политика] [--out=файл]"
+void RestaurantMenuApp::cmdMerge(const std::string& args) {
+	std::istringstream iss(args);
+	std::string token, outFile;
+	std::vector<std::string> files;
+	MenuDiff::Policy policy = MenuDiff::Policy::Second;
+	std::string policyName = "second";
+	while (iss >> token) {
+		if (token.compare(0, 9, "--prefer=") == 0) {
+			policyName = token.substr(9);
+			if (!MenuDiff::parsePolicy(policyName, policy)) {
+				reportError() << "неизвестная политика \"" << policyName << "\". Доступны: first, second, both, cheaper" << std::endl;
+				return;
+			}
+		}
+		else if (token.compare(0, 6, "--out=") == 0) {
+			outFile = token.substr(6);
+		}
+		else {
+			files.push_back(token);
+		}
+	}
+	if (files.size() != 2) {
+		reportError() << "укажите два файла. Пример: merge menu.txt update.txt --prefer=cheaper --out=new.txt" << std::endl;
+		return;
+	}
+
+	try {
+		std::vector<Dish> first, second;
+		loadBoth(files[0], files[1], first, second);
+		MenuDiff::Result diff = MenuDiff::compare(first, second);
+		std::vector<Dish> merged = MenuDiff::merge(first, second, diff, policy);
+
+		printer_->printFilteredDishes(merged, "Слияние " + files[0] + " + " + files[1] + " (политика " + policyName +
+			", конфликтов: " + std::to_string(diff.changed.size()) + "):");
+		if (!outFile.empty()) {
+			saveDishes(merged, outFile);
+		}
+	}
+	catch (const std::exception& e) {
+		reportError() << e.what() << std::endl;
+	}
+}
+
+// Сообщает об ошибках журнала и уплотняет его в фоне, когда поколение разрослось
+void RestaurantMenuApp::maintainWal() {
+	if (!wal_) return;
+	std::string error = wal_->takeError();
+	if (!error.empty()) {
+		reportError() << "журнал изменений: " << error << std::endl;
+	}
+	if (wal_->needsCompaction()) {
+		wal_->compact(storage_->getDishes());
+	}
+}
+
+// Изменение подтверждается пользователю только после fsync его записей. Поток фиксации
+// подхватывает записи сразу, поэтому команда с несколькими изменениями (commit, watch)
+// ждет один общий fsync, а не по одному на запись
+bool RestaurantMenuApp::syncWal() {
+	if (!wal_ || wal_->sync()) return true;
+	reportError() << "журнал изменений: " << wal_->takeError() << std::endl;
+	return false;
+}
+
+// Сообщает о завершенных фоновых сохранениях
+void RestaurantMenuApp::reportBackgroundSaves(bool wait) {
+	if (wait && saver_.pending() > 0) {
+		std::cout << "Ожидание завершения фонового сохранения..." << std::endl;
+		saver_.wait();
+	}
+	for (const auto& result : saver_.takeResults()) {
+		if (result.error.empty()) {
+			if (result.filename == watcher_.path()) watcher_.rebase();
+			std::cout << "Фоновое сохранение завершено: " << result.filename << " (" << result.count << " блюд)" << std::endl;
+		}
+		else {
+			reportError() << "фоновое сохранение в " << result.filename << " не удалось: " << result.error << std::endl;
+		}
+	}
+}
+
+// Ищет блюда по части названия: сначала совпадения по началу, затем по подстроке
+void RestaurantMenuApp::findDishes(const std::string& text) const {
+	const size_t maxNames = 20;
+	std::string fragment = StringUtils::trim(text);
+	if (fragment.empty()) {
+		reportError() << "укажите часть названия. Пример: find пицца" << std::endl;
+		return;
+	}
+
+	std::vector<std::string> names = storage_->findNamesByPrefix(fragment, maxNames);
+	if (names.size() < maxNames) {
+		for (const auto& name : storage_->findNamesBySubstring(fragment, maxNames)) {
+			if (names.size() == maxNames) break;
+			if (std::find(names.begin(), names.end(), name) == names.end()) {
+				names.push_back(name);
+			}
+		}
+	}
+
+	if (names.empty()) {
+		std::cout << "WARNING: Блюда, содержащие \"" << fragment << "\", не найдены" << std::endl;
+		printSuggestions(fragment);
+		return;
+	}
+
+	// Строки каждого названия планировщик находит индексом названий хранилища двоичным поиском
+	DishPredicate predicate;
+	predicate.kind = PredicateKind::Or;
+	for (const auto& name : names) {
+		predicate.children.push_back(DishPredicate::nameEquals(name));
+	}
+	auto found = MenuQuery().where(predicate).execute(storage_->getDishes(), storage_->getIndexes());
+	printer_->printFilteredDishes(found, "Результаты поиска \"" + fragment + "\":");
+}
+
+// Выводит копию меню в выбранном порядке; само хранилище остается отсортированным по алфавиту
+void RestaurantMenuApp::printSorted(const std::string& order) const {
+	std::string name = StringUtils::trim(order);
+	SorterRegistry::SortFunction sort = SorterRegistry::find(name);
+	if (!sort) {
+		reportError() << "неизвестный порядок \"" << name << "\". Доступные порядки:" << std::endl;
+		for (const auto& entry : SorterRegistry::entries()) {
+			std::cout << "  " << std::left << std::setw(12) << entry.name << " - " << entry.description << std::endl;
+		}
+		return;
+	}
+
+	std::vector<Dish> dishes = storage_->getDishes();
+	sort(dishes);
+	printer_->printFilteredDishes(dishes, "Меню, порядок \"" + name + "\":");
+}
+
+// Создает представление по строке "имя условия" или выводит список представлений
+void RestaurantMenuApp::defineView(const std::string& definition) {
+	std::istringstream iss(definition);
+	std::string name;
+	iss >> name;
+
+	if (name.empty()) {
+		std::vector<std::string> names = storage_->getViewNames();
+		if (names.empty()) {
+			std::cout << "Представления не заданы. Пример: view быстрые <10.00 <00:20" << std::endl;
+			return;
+		}
+		std::cout << "Представления:" << std::endl;
+		for (const auto& viewName : names) {
+			size_t size = 0;
+			storage_->getViewSize(viewName, size);
+			std::cout << "  " << viewName << " (" << size << " блюд)" << std::endl;
+		}
+		return;
+	}
+
+	std::string condition;
+	std::getline(iss, condition);
+	DishPredicate predicate;
+	std::string errorMessage;
+	if (!parseViewCondition(condition, predicate, errorMessage)) {
+		reportError() << errorMessage << ". Пример: view премиум >50" << std::endl;
+		return;
+	}
+
+	storage_->defineView(name, predicate);
+	size_t size = 0;
+	storage_->getViewSize(name, size);
+	std::cout << "Представление \"" << name << "\" создано (" << size << " блюд)" << std::endl;
+}
+
+// Разбирает условие представления: "<цена", ">цена", "<чч:мм", ">чч:мм"; без знака - "меньше"
+bool RestaurantMenuApp::parseViewCondition(const std::string& text, DishPredicate& predicate, std::string& errorMessage) const {
+	std::istringstream iss(text);
+	std::string token;
+	char pendingOperator = 0;
+	predicate = DishPredicate::any();
+
+	while (iss >> token) {
+		char op = pendingOperator ? pendingOperator : '<';
+		pendingOperator = 0;
+		if (token[0] == '<' || token[0] == '>') {
+			op = token[0];
+			token.erase(0, 1);
+			// Знак записан отдельно от значения
+			if (token.empty()) {
+				pendingOperator = op;
+				continue;
+			}
+		}
+
+		TimeParser timeParser;
+		NumberParser numberParser;
+		if (token.find(':') != std::string::npos && timeParser.parse(token)) {
+			Time time = timeParser.getResult();
+			predicate.children.push_back(op == '<' ? DishPredicate::timeBelow(time) : DishPredicate::timeAbove(time));
+		}
+		else if (numberParser.parse(token)) {
+			double price = numberParser.getResult();
+			predicate.children.push_back(op == '<' ? DishPredicate::priceBelow(price) : DishPredicate::priceAbove(price));
+		}
+		else {
+			errorMessage = "не удалось разобрать условие \"" + token + "\"";
+			return false;
+		}
+	}
+
+	if (pendingOperator) {
+		errorMessage = "после знака сравнения нет значения";
+		return false;
+	}
+	if (predicate.children.empty()) {
+		errorMessage = "не указано условие представления";
+		return false;
+	}
+	return true;
+}
+
+// Выводит строки представления
+void RestaurantMenuApp::printView(const std::string& name) const {
+	std::vector<Dish> rows;
+	if (!storage_->getView(name, rows)) {
+		reportError() << "представление \"" << name << "\" не найдено. Список представлений: view" << std::endl;
+		return;
+	}
+	printer_->printFilteredDishes(rows, "Представление \"" + name + "\":");
+}
+
+// Выводит страницу меню (пустое имя) или представления и запоминает ее для next/prev
+void RestaurantMenuApp::printPage(const std::string& viewName, size_t page) {
+	size_t total = 0;
+	if (viewName.empty()) {
+		// Меню листается прямо из хранилища, без копирования строк
+		total = storage_->getDishesCount();
+		printer_->printPage(storage_->getDishes(), page, pageSize_, "=== МЕНЮ РЕСТОРАНА ===");
+	}
+	else {
+		// Из представления копируется только запрошенная страница
+		std::vector<Dish> rows;
+		if (!storage_->getViewSize(viewName, total)) {
+			reportError() << "представление \"" << viewName << "\" не найдено. Список представлений: view" << std::endl;
+			return;
+		}
+		if (page > 0) storage_->getViewRows(viewName, (page - 1) * pageSize_, pageSize_, rows);
+		printer_->printPageRows(rows, page, pageSize_, total, "Представление \"" + viewName + "\":");
+	}
+
+	size_t pageCount = (total + pageSize_ - 1) / pageSize_;
+	if (page <= pageCount) {
+		pagedView_ = viewName;
+		currentPage_ = page;
 	}
 }
 
 // Очищает консоль
 void RestaurantMenuApp::clearConsole() const {
+	AsyncOutput::drainConsole();
 	system("cls");
 }
 
@@ -293,11 +1360,35 @@ void RestaurantMenuApp::showHelp() const {
 	std::cout << std::endl << "ДОСТУПНЫЕ КОМАНДЫ:" << std::endl;
 	std::cout << "  help                         - показать эту справку" << std::endl;
 	std::cout << "  print                        - вывести меню" << std::endl;
+	std::cout << "  print представление          - вывести именованное представление" << std::endl;
+	std::cout << "  print N / print имя N        - вывести страницу N меню или представления" << std::endl;
+	std::cout << "  next / prev                  - следующая / предыдущая страница" << std::endl;
+	std::cout << "  pagesize N                   - задать количество блюд на странице" << std::endl;
+	std::cout << "  команда --format=ndjson      - вывод команды в формате csv, json, ndjson или table" << std::endl;
 	std::cout << "  clear                        - очистить консоль" << std::endl;
+	std::cout << "  load имя_файла               - заменить меню содержимым файла" << std::endl;
 	std::cout << "  add \"Название\" цена время    - добавить блюдо" << std::endl;
 	std::cout << "  delete Название              - удалить все блюда с таким названием" << std::endl;
 	std::cout << "  delete \"Название\" цена время - удалить конкретное блюдо" << std::endl;
+	std::cout << "  begin / commit / rollback    - отложить add и delete / применить их одним проходом / отменить" << std::endl;
 	std::cout << "  save имя_файла               - сохранить меню в файл" << std::endl;
+	std::cout << "  save --binary имя_файла      - сохранить двоичный снимок (загружается автоматически)" << std::endl;
+	std::cout << "  save --background имя_файла  - сохранить в фоне, не прерывая работу" << std::endl;
+	std::cout << "  save --delta имя_файла       - сохранить только изменения с прошлого сохранения" << std::endl;
+	std::cout << "  save --archive имя_файла     - сохранить сжатый колоночный архив (загружается автоматически)" << std::endl;
+	std::cout << "  consolidate имя_файла        - объединить базу с наборами изменений" << std::endl;
+	std::cout << "  archive имя_файла [условия]  - загрузить из архива только блюда по условию (<цена, >чч:мм)" << std::endl;
+	std::cout << "  watch / watch off            - применять правки загруженного файла перед каждой командой" << std::endl;
+	std::cout << "  wal путь / wal / wal off     - включить журнал изменений / состояние / выключить" << std::endl;
+	std::cout << "  wal compact                  - уплотнить журнал в новый снимок (в фоне)" << std::endl;
+	std::cout << "  diff файлA файлB             - добавленные, удаленные и изменившиеся блюда" << std::endl;
+	std::cout << "  merge файлA файлB [--prefer=first|second|both|cheaper] [--out=файл] - слить два меню" << std::endl;
+	std::cout << "  find текст                   - найти блюда по части названия" << std::endl;
+	std::cout << "  stats                        - статистика меню: цены, время, квантили" << std::endl;
+	std::cout << "  sort порядок                 - вывести меню в порядке name/price/time/..." << std::endl;
+	std::cout << "  view имя условия             - создать представление (<цена, >цена, <чч:мм, >чч:мм)" << std::endl;
+	std::cout << "  view                         - список представлений" << std::endl;
+	std::cout << "  unview имя                   - удалить представление" << std::endl;
 	std::cout << "  exit                         - выйти в меню выбора файла" << std::endl;
 	std::cout << std::endl << "ФИЛЬТРАЦИЯ:" << std::endl;
 	std::cout << "  цена                         - блюда дешевле указанной суммы" << std::endl;
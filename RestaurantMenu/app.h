@@ -4,6 +4,14 @@
 
 #include "interfaces.h"
 #include "parsers.h"
+#include "menu_files.h"
+#include "write_ahead_log.h"
+#include "delta_saver.h"
+#include "menu_watcher.h"
+#include "file_parser.h"
+#include "menu_transaction.h"
+#include <istream>
+#include <ostream>
 #include <memory>
 #include <string>
 #include <map>
@@ -26,6 +34,18 @@ private:
 	std::unique_ptr<IFileParser> fileParser_;        ///< Парсер файлов
 	std::unique_ptr<UserInputParser> userInputParser_; ///< Парсер пользовательского ввода
 	int invalidCount_;                               ///< Счетчик невалидных записей
+	size_t pageSize_;                                ///< Количество блюд на странице
+	size_t currentPage_;                             ///< Текущая страница постраничного вывода (0 - не начат)
+	std::string pagedView_;                          ///< Представление, которое листается (пустое - все меню)
+	BackgroundSaver saver_;                          ///< Фоновые сохранения (save --background)
+	std::unique_ptr<WriteAheadLog> wal_;             ///< Журнал изменений (пустой, если не включен)
+	DeltaSaver deltaSaver_;                          ///< Разностные сохранения (save --delta)
+	std::string menuFile_;                           ///< Загруженный текстовый файл меню (пустой - загружен не текст)
+	MenuFileWatcher watcher_;                        ///< Отслеживание изменений загруженного файла (watch)
+	MenuFileParser lineParser_;                      ///< Разбор аргументов add/delete (регулярные выражения компилируются один раз)
+	bool batchMode_;                                 ///< Пакетный режим: без приглашений и подтверждений
+	std::unique_ptr<MenuTransaction> transaction_;   ///< Открытая транзакция (пустой, если begin не было)
+	mutable size_t errorCount_;                      ///< Количество команд, завершившихся ошибкой
 
 	std::map<std::string, std::function<void(const std::string&)>> commandsMap_; ///< Карта команд
 
@@ -40,6 +60,24 @@ private:
 	void cmdAdd(const std::string& args);
 	void cmdDelete(const std::string& args);
 	void cmdSave(const std::string& args);
+	void cmdFind(const std::string& args);
+	void cmdSort(const std::string& args);
+	void cmdView(const std::string& args);
+	void cmdUnview(const std::string& args);
+	void cmdStats(const std::string& args = "");
+	void cmdNext(const std::string& args = "");
+	void cmdPrev(const std::string& args = "");
+	void cmdPageSize(const std::string& args);
+	void cmdWal(const std::string& args);
+	void cmdConsolidate(const std::string& args);
+	void cmdArchive(const std::string& args);
+	void cmdWatch(const std::string& args);
+	void cmdDiff(const std::string& args);
+	void cmdMerge(const std::string& args);
+	void cmdLoad(const std::string& args);
+	void cmdBegin(const std::string& args = "");
+	void cmdCommit(const std::string& args = "");
+	void cmdRollback(const std::string& args = "");
 
 public:
 	/// Конструктор с инъекцией зависимостей
@@ -66,7 +104,34 @@ public:
 	/// Обрабатывает команды управления
 	void processCommand(const std::string& command);
 
+	/// Выполняет команды из потока без приглашений и подтверждений (пустые строки и строки с # пропускаются,
+	/// exit завершает). Возвращает код завершения: 0 - все команды успешны, 1 - были ошибки
+	int runBatch(std::istream& input);
+
+	/// Начинает транзакцию: add и delete откладываются до commit. Возвращает false, если транзакция уже открыта
+	bool beginTransaction();
+
+	/// Применяет отложенные изменения одним проходом по хранилищу и одним слиянием добавленных блюд.
+	/// Возвращает false, если транзакция не открыта
+	bool commitTransaction();
+
+	/// Отбрасывает отложенные изменения; хранилище не затрагивается. Возвращает false, если транзакция не открыта
+	bool rollbackTransaction();
+
+	/// Открыта ли транзакция
+	bool inTransaction() const { return transaction_ != nullptr; }
+
+	/// Выводит блюда двоичного снимка, удовлетворяющие условию, прямо из отображенного в память
+	/// файла, не загружая меню: "файл [условия]"
+	void printMapped(const std::string& args) const;
+
 private:
+	/// Начинает сообщение об ошибке команды ("ERROR: ") и учитывает ее в коде завершения пакета
+	std::ostream& reportError() const;
+
+	/// Выполняет команду из карты команд или фильтрацию по введенным критериям
+	void dispatchCommand(const std::string& command);
+
 	/// Обрабатывает ввод для фильтрации
 	void processUserInput(const std::string& input);
 
@@ -76,8 +141,66 @@ private:
 	/// Удаляет блюдо
 	void deleteDish(const std::string& dishData);
 
+	/// Удаляет все блюда с указанным названием и возвращает их количество
+	size_t removeDishesByName(const std::string& name);
+
+	/// Возвращает названия, похожие на введенное с опечатками
+	std::vector<std::string> suggestNames(const std::string& text) const;
+
+	/// Выводит похожие названия, если они есть
+	void printSuggestions(const std::string& text) const;
+
 	/// Сохраняет меню в файл
-	void saveMenu(const std::string& filename) const;
+	void saveMenu(const std::string& filename, bool binary = false, bool background = false);
+
+	/// Сохраняет блюда в файл с подтверждением перезаписи menu.txt, ожиданием фоновых сохранений
+	/// в тот же файл и учетом отслеживаемого файла (общий путь save и merge --out)
+	void saveDishes(const std::vector<Dish>& dishes, const std::string& filename, bool binary = false, bool background = false);
+
+	/// Дожидается фоновых сохранений в файл перед синхронной записью в него
+	void waitForBackgroundSave(const std::string& filename);
+
+	/// Сохраняет меню набором изменений (save --delta)
+	void saveDelta(const std::string& filename);
+
+	/// Сохраняет меню в колоночный архив (save --archive)
+	void saveArchive(const std::string& filename);
+
+	/// Включает журнал изменений по пути base, восстанавливая меню, если журнал уже есть
+	void openWal(const std::string& base);
+
+	/// Отбрасывает незафиксированную транзакцию (выход, загрузка другого меню) с сообщением об ошибке
+	void abandonTransaction();
+
+	/// Применяет к меню изменения отслеживаемого файла, если он изменился
+	void applyFileChanges();
+
+	/// Сообщает об ошибках журнала и запускает уплотнение, когда текущее поколение разрослось
+	void maintainWal();
+
+	/// Дожидается, пока записанные изменения окажутся в журнале на диске; false - ошибка записи (уже выведена)
+	bool syncWal();
+
+	/// Сообщает о завершенных фоновых сохранениях; wait - сначала дождаться незавершенных
+	void reportBackgroundSaves(bool wait = false);
+
+	/// Ищет блюда по части названия
+	void findDishes(const std::string& text) const;
+
+	/// Выводит меню в порядке из реестра сортировщиков
+	void printSorted(const std::string& order) const;
+
+	/// Создает представление или выводит список представлений
+	void defineView(const std::string& definition);
+
+	/// Разбирает условие представления в предикат запроса
+	bool parseViewCondition(const std::string& text, DishPredicate& predicate, std::string& errorMessage) const;
+
+	/// Выводит именованное представление
+	void printView(const std::string& name) const;
+
+	/// Выводит страницу меню или представления и запоминает ее для next/prev
+	void printPage(const std::string& viewName, size_t page);
 
 	/// Очищает консоль
 	void clearConsole() const;
@@ -0,0 +1,120 @@
+﻿#include "async_output.h"
+#include <algorithm>
+#include <iostream>
+
+AsyncOutput* AsyncOutput::active_ = nullptr;
+
+// Подменяет streambuf потока и запускает писателя
+AsyncOutput::AsyncOutput(std::ostream& stream, size_t bufferSize, size_t queueLimit)
+	: stream_(stream)
+	, target_(stream.rdbuf())
+	, local_(bufferSize > 0 ? bufferSize : 1)
+	, queueLimit_(queueLimit)
+	, submitted_(0)
+	, written_(0)
+	, stop_(false)
+	, writer_(&AsyncOutput::writerLoop, this) {
+	setp(local_.data(), local_.data() + local_.size());
+	stream_.rdbuf(this);
+	if (&stream_ == &std::cout) active_ = this;
+}
+
+// Дописывает остаток, возвращает потоку исходный streambuf и завершает писателя
+AsyncOutput::~AsyncOutput() {
+	drain();
+	stream_.rdbuf(target_);
+	if (active_ == this) active_ = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	ready_.notify_one();
+	writer_.join();
+}
+
+// Копирует заполненную часть локального буфера в очередь писателя.
+// Если писатель отстал больше чем на queueLimit_ байт, поток команд ждет его
+void AsyncOutput::handOff() {
+	const size_t size = static_cast<size_t>(pptr() - pbase());
+	if (size == 0) return;
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		progress_.wait(lock, [this] { return queued_.size() < queueLimit_; });
+		queued_.append(pbase(), size);
+		submitted_ += size;
+	}
+	ready_.notify_one();
+	setp(local_.data(), local_.data() + local_.size());
+}
+
+// Писатель забирает очередь целиком (обмен буферов) и пишет ее без блокировки
+void AsyncOutput::writerLoop() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		ready_.wait(lock, [this] { return stop_ || !queued_.empty(); });
+		if (queued_.empty()) return;
+
+		writing_.swap(queued_);
+		lock.unlock();
+		target_->sputn(writing_.data(), static_cast<std::streamsize>(writing_.size()));
+		target_->pubsync();
+		lock.lock();
+
+		written_ += writing_.size();
+		writing_.clear();
+		progress_.notify_all();
+	}
+}
+
+// std::endl после каждой строки ответа не должен будить писателя: текст уйдет при заполнении
+// буфера или в drain(), который вызывается перед каждым ожиданием ввода
+int AsyncOutput::sync() {
+	return 0;
+}
+
+AsyncOutput::int_type AsyncOutput::overflow(int_type ch) {
+	handOff();
+	if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+		*pptr() = traits_type::to_char_type(ch);
+		pbump(1);
+	}
+	return traits_type::not_eof(ch);
+}
+
+std::streamsize AsyncOutput::xsputn(const char* s, std::streamsize count) {
+	const size_t size = static_cast<size_t>(count);
+	const size_t room = static_cast<size_t>(epptr() - pptr());
+	if (size <= room) {
+		std::copy(s, s + size, pptr());
+		pbump(static_cast<int>(size));
+		return count;
+	}
+
+	// Блок больше свободного места: сначала отдаем накопленное, затем сам блок
+	handOff();
+	if (size < local_.size()) {
+		std::copy(s, s + size, pptr());
+		pbump(static_cast<int>(size));
+		return count;
+	}
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		progress_.wait(lock, [this] { return queued_.size() < queueLimit_; });
+		queued_.append(s, size);
+		submitted_ += size;
+	}
+	ready_.notify_one();
+	return count;
+}
+
+// Ждет, пока писатель запишет все переданное до этого момента
+void AsyncOutput::drain() {
+	handOff();
+	std::unique_lock<std::mutex> lock(mutex_);
+	const uint64_t target = submitted_;
+	progress_.wait(lock, [this, target] { return written_ >= target; });
+}
+
+void AsyncOutput::drainConsole() {
+	if (active_ != nullptr) active_->drain();
+}
\ No newline at end of file
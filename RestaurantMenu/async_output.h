@@ -0,0 +1,74 @@
+﻿#pragma once
+#ifndef ASYNC_OUTPUT_H
+#define ASYNC_OUTPUT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Асинхронный вывод с двойной буферизацией: поток команд пишет в локальный буфер
+/// (только копирование байт), при заполнении или drain() буфер передается отдельному
+/// потоку-писателю, который выводит его в исходный streambuf. flush() (и std::endl) буфер
+/// не передает, поэтому строка вывода не стоит ни пробуждения писателя, ни системного вызова.
+/// Медленный терминал или канал задерживает только писателя. Порядок вывода сохраняется; drain()
+/// дожидается записи всего текста и служит точкой синхронизации перед вводом, system("cls") и выходом.
+/// На время жизни объект подменяет streambuf указанного потока и восстанавливает его при уничтожении.
+class AsyncOutput : public std::streambuf {
+private:
+	std::ostream& stream_;              ///< Поток, в котором подменен streambuf
+	std::streambuf* target_;            ///< Исходный streambuf, в который пишет писатель
+	std::vector<char> local_;           ///< Буфер потока команд (область put)
+	std::string queued_;                ///< Текст, переданный писателю, но еще не взятый им
+	std::string writing_;               ///< Текст, который писатель выводит сейчас
+	size_t queueLimit_;                 ///< Предел очереди, после которого поток команд ждет писателя
+	uint64_t submitted_;                ///< Всего передано байт
+	uint64_t written_;                  ///< Всего записано байт
+	bool stop_;                         ///< Признак завершения писателя
+	std::mutex mutex_;
+	std::condition_variable ready_;     ///< Появились данные или запрошена остановка
+	std::condition_variable progress_;  ///< Писатель записал очередной блок
+
+	std::thread writer_;                ///< Поток-писатель (объявлен последним: стартует после остальных полей)
+
+	static AsyncOutput* active_;        ///< Установленный на консоль экземпляр для drainConsole()
+
+	/// Передает заполненную часть локального буфера писателю
+	void handOff();
+
+	/// Цикл потока-писателя
+	void writerLoop();
+
+protected:
+	/// Локальный буфер заполнен: передаем его писателю и продолжаем запись
+	int_type overflow(int_type ch) override;
+
+	/// Запись блока символов; крупные блоки передаются писателю без промежуточного копирования в локальный буфер
+	std::streamsize xsputn(const char* s, std::streamsize count) override;
+
+	/// flush() потока: текст остается в локальном буфере до заполнения или drain()
+	int sync() override;
+
+public:
+	/// Подменяет streambuf потока stream; bufferSize - размер локального буфера,
+	/// queueLimit - сколько байт может ждать писателя, прежде чем поток команд остановится
+	explicit AsyncOutput(std::ostream& stream, size_t bufferSize = 1 << 16, size_t queueLimit = 1 << 24);
+
+	/// Дописывает все, восстанавливает исходный streambuf и останавливает писателя
+	~AsyncOutput() override;
+
+	AsyncOutput(const AsyncOutput&) = delete;
+	AsyncOutput& operator=(const AsyncOutput&) = delete;
+
+	/// Передает текст писателю и ждет, пока он будет записан в исходный поток
+	void drain();
+
+	/// Точка синхронизации консоли: drain() для экземпляра, установленного на std::cout, если он есть
+	static void drainConsole();
+};
+
+#endif // ASYNC_OUTPUT_H
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "storage.h"
 #include "parsers.h"
 #include "printer.h"
+#include "data_printers.h"
 #include "file_parser.h"
 #include <sstream>
 #include <iostream>
@@ -21,9 +22,6 @@ RestaurantMenuAppBuilder::RestaurantMenuAppBuilder() {
 	sorter_ = std::make_unique<MenuSorter>();
 	log.str(""); log << "   MenuSorter создан" << std::endl; std::cout << log.str();
 
-	filter_ = std::make_unique<MenuFilter>(std::make_unique<MenuSorter>());
-	log.str(""); log << "   MenuFilter создан" << std::endl; std::cout << log.str();
-
 	printer_ = std::make_unique<MenuPrinter>();
 	log.str(""); log << "   MenuPrinter создан" << std::endl; std::cout << log.str();
 
@@ -76,6 +74,21 @@ RestaurantMenuAppBuilder& RestaurantMenuAppBuilder::setPrinter(std::unique_ptr<I
 	return *this;
 }
 
+/// Устанавливает принтер по названию формата вывода
+RestaurantMenuAppBuilder& RestaurantMenuAppBuilder::setPrinterFormat(const std::string& format) {
+	std::stringstream log;
+	log << "Builder: Установка формата вывода " << format << std::endl;
+	std::cout << log.str();
+
+	std::unique_ptr<IMenuPrinter> printer = PrinterFormats::create(format);
+	if (!printer) {
+		std::cout << "ERROR: неизвестный формат \"" << format << "\". Доступны: " << PrinterFormats::names() << std::endl;
+		return *this;
+	}
+	printer_ = std::move(printer);
+	return *this;
+}
+
 /// Устанавливает пользовательскую реализацию парсера файлов
 RestaurantMenuAppBuilder& RestaurantMenuAppBuilder::setFileParser(std::unique_ptr<IFileParser> fileParser) {
 	std::stringstream log;
@@ -102,6 +115,16 @@ std::unique_ptr<RestaurantMenuApp> RestaurantMenuAppBuilder::build() {
 	log << "Builder: Создание приложения RestaurantMenuApp..." << std::endl;
 	std::cout << log.str();
 
+	// Фильтр по умолчанию создается для итогового хранилища, чтобы запросы брали готовые столбцы из него
+	if (!filter_) {
+		filter_ = std::make_unique<MenuFilter>(std::make_unique<MenuSorter>(), storage_.get());
+		log.str(""); log << "   MenuFilter создан" << std::endl; std::cout << log.str();
+	}
+
+	// Кэш результатов оборачивает выбранный фильтр и следит за версией выбранного хранилища
+	filter_ = std::make_unique<CachedMenuFilter>(std::move(filter_), *storage_);
+	log.str(""); log << "   CachedMenuFilter подключен" << std::endl; std::cout << log.str();
+
 	// Создаем приложение, передавая владение всеми компонентами
 	auto app = std::make_unique<RestaurantMenuApp>(
 		std::move(storage_),
@@ -31,6 +31,10 @@ public:
 	/// Устанавливает пользовательский принтер меню
 	RestaurantMenuAppBuilder& setPrinter(std::unique_ptr<IMenuPrinter> printer);
 
+	/// Устанавливает принтер по названию формата: table, csv, json, ndjson.
+	/// Неизвестный формат оставляет текущий принтер
+	RestaurantMenuAppBuilder& setPrinterFormat(const std::string& format);
+
 	/// Устанавливает пользовательский парсер файлов
 	RestaurantMenuAppBuilder& setFileParser(std::unique_ptr<IFileParser> fileParser);
 
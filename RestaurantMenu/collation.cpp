@@ -0,0 +1,176 @@
+﻿#include "collation.h"
+#include <array>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define COLLATION_HAS_SSE2 1
+#endif
+
+// ==================== ВЕСА СИМВОЛОВ ====================
+//
+// Первичный вес занимает один байт:
+//   0x01-0x7F - ASCII, латинские буквы приведены к нижнему регистру;
+//   0x80-0xA0 - кириллица А..Я без учета регистра, Ё сразу после Е;
+//   0xF0      - прочие символы (порядок между ними определяют исходные байты).
+// Нулевой байт разделяет первичные веса и исходное название, поэтому
+// более короткое название всегда оказывается раньше своего продолжения.
+
+static const unsigned char kCyrillicBase = 0x80;   ///< Вес буквы "А"
+static const unsigned char kYoWeight = 0x86;       ///< Вес буквы "Ё" (между Е и Ж)
+static const unsigned char kOtherWeight = 0xF0;    ///< Вес прочих символов
+
+// Вес кириллической буквы по ее номеру в алфавите без Ё (0 - А, 31 - Я)
+static unsigned char cyrillicWeight(unsigned int index) {
+	return static_cast<unsigned char>(kCyrillicBase + index + (index >= 6 ? 1 : 0));
+}
+
+// Вес символа ASCII
+static unsigned char asciiWeight(unsigned char c) {
+	return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + 0x20) : c;
+}
+
+// Таблица весов для однобайтовой кодировки CP1251
+static const std::array<unsigned char, 256>& cp1251Weights() {
+	static const std::array<unsigned char, 256> table = [] {
+		std::array<unsigned char, 256> t{};
+		for (unsigned int c = 0; c < 256; ++c) {
+			if (c < 0x80) t[c] = asciiWeight(static_cast<unsigned char>(c));
+			else if (c >= 0xC0) t[c] = cyrillicWeight(c & 0x1F);
+			else if (c == 0xA8 || c == 0xB8) t[c] = kYoWeight;
+			else t[c] = kOtherWeight;
+		}
+		return t;
+	}();
+	return table;
+}
+
+// Вес символа Юникода (для названий в UTF-8)
+static unsigned char codePointWeight(unsigned int cp) {
+	if (cp < 0x80) return asciiWeight(static_cast<unsigned char>(cp));
+	if (cp >= 0x410 && cp <= 0x44F) return cyrillicWeight((cp - 0x410) & 0x1F);
+	if (cp == 0x401 || cp == 0x451) return kYoWeight;
+	return kOtherWeight;
+}
+
+#ifdef COLLATION_HAS_SSE2
+// Вычисляет веса 16 байт CP1251 одной SIMD-операцией.
+// Возвращает false, если в блоке есть байты 0x80-0xBF (Ё, ё и прочие) - их обрабатывает таблица.
+static bool cp1251WeightsBlock(const unsigned char* src, unsigned char* dst) {
+	const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+	const __m128i isAscii = _mm_cmpgt_epi8(v, _mm_set1_epi8(-1));
+	const __m128i isCyrillic = _mm_and_si128(
+		_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(0xBF))),
+		_mm_cmplt_epi8(v, _mm_setzero_si128()));
+
+	if (_mm_movemask_epi8(_mm_or_si128(isAscii, isCyrillic)) != 0xFFFF) {
+		return false;
+	}
+
+	// ASCII: A-Z -> a-z
+	const __m128i isUpper = _mm_and_si128(
+		_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+		_mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+	const __m128i ascii = _mm_add_epi8(v, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+
+	// Кириллица: номер буквы в младших 5 битах, после Е вес сдвигается на единицу ради Ё
+	const __m128i index = _mm_and_si128(v, _mm_set1_epi8(0x1F));
+	const __m128i afterYo = _mm_and_si128(_mm_cmpgt_epi8(index, _mm_set1_epi8(5)), _mm_set1_epi8(1));
+	const __m128i cyrillic = _mm_add_epi8(
+		_mm_add_epi8(index, _mm_set1_epi8(static_cast<char>(kCyrillicBase))), afterYo);
+
+	const __m128i result = _mm_or_si128(_mm_and_si128(isAscii, ascii), _mm_andnot_si128(isAscii, cyrillic));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), result);
+	return true;
+}
+#endif
+
+// Заполняет первичные веса для названия в CP1251 (dst имеет длину src)
+static void cp1251PrimaryWeights(const unsigned char* src, size_t size, unsigned char* dst) {
+	const auto& table = cp1251Weights();
+	size_t i = 0;
+
+#ifdef COLLATION_HAS_SSE2
+	for (; i + 16 <= size; i += 16) {
+		if (!cp1251WeightsBlock(src + i, dst + i)) {
+			for (size_t j = i; j < i + 16; ++j) dst[j] = table[src[j]];
+		}
+	}
+#endif
+
+	for (; i < size; ++i) {
+		dst[i] = table[src[i]];
+	}
+}
+
+// ==================== РЕАЛИЗАЦИЯ COLLATION ====================
+
+/// Проверяет, является ли строка корректным UTF-8 с многобайтовыми символами
+bool Collation::isMultibyteUtf8(const std::string& str) {
+	bool hasMultibyte = false;
+	size_t i = 0;
+	while (i < str.size()) {
+		unsigned char c = static_cast<unsigned char>(str[i]);
+		size_t length;
+		if (c < 0x80) length = 1;
+		else if ((c & 0xE0) == 0xC0 && c >= 0xC2) length = 2;
+		else if ((c & 0xF0) == 0xE0) length = 3;
+		else if ((c & 0xF8) == 0xF0 && c <= 0xF4) length = 4;
+		else return false;
+
+		if (i + length > str.size()) return false;
+		for (size_t j = 1; j < length; ++j) {
+			if ((static_cast<unsigned char>(str[i + j]) & 0xC0) != 0x80) return false;
+		}
+
+		hasMultibyte = hasMultibyte || length > 1;
+		i += length;
+	}
+	return hasMultibyte;
+}
+
+/// Заполняет первичные веса символов названия
+static void appendPrimaryWeights(const std::string& name, std::string& key) {
+	if (Collation::isMultibyteUtf8(name)) {
+		// UTF-8: один вес на кодовую точку
+		size_t i = 0;
+		while (i < name.size()) {
+			unsigned char c = static_cast<unsigned char>(name[i]);
+			unsigned int cp;
+			size_t length;
+			if (c < 0x80) { cp = c; length = 1; }
+			else if (c < 0xE0) { cp = c & 0x1F; length = 2; }
+			else if (c < 0xF0) { cp = c & 0x0F; length = 3; }
+			else { cp = c & 0x07; length = 4; }
+			for (size_t j = 1; j < length; ++j) {
+				cp = (cp << 6) | (static_cast<unsigned char>(name[i + j]) & 0x3F);
+			}
+			key.push_back(static_cast<char>(codePointWeight(cp)));
+			i += length;
+		}
+	}
+	else if (!name.empty()) {
+		// CP1251 / ASCII: один вес на байт, блоками по 16 байт
+		size_t offset = key.size();
+		key.resize(offset + name.size());
+		cp1251PrimaryWeights(reinterpret_cast<const unsigned char*>(name.data()), name.size(),
+			reinterpret_cast<unsigned char*>(&key[offset]));
+	}
+}
+
+/// Строит ключ сортировки для названия блюда
+std::string Collation::makeKey(const std::string& name) {
+	std::string key;
+	key.reserve(name.size() * 2 + 1);
+	appendPrimaryWeights(name, key);
+	key.push_back('\0');
+	key.append(name);
+	return key;
+}
+
+/// Возвращает только первичные веса символов
+std::string Collation::primaryWeights(const std::string& text) {
+	std::string weights;
+	weights.reserve(text.size());
+	appendPrimaryWeights(text, weights);
+	return weights;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+﻿#pragma once
+#ifndef COLLATION_H
+#define COLLATION_H
+
+#include <string>
+#include <cstring>
+
+/// Построение ключей сопоставления для корректной русской сортировки названий.
+/// Ключ вычисляется один раз на блюдо, после чего сравнение сводится к memcmp.
+/// Поддерживаются названия в кодировках CP1251 и UTF-8.
+class Collation {
+public:
+	/// Строит ключ сортировки: первичные веса символов (без учета регистра, Ё после Е),
+	/// нулевой разделитель и исходные байты для детерминированного разрешения равенств
+	static std::string makeKey(const std::string& name);
+
+	/// Возвращает только первичные веса (без разделителя и исходных байтов) - для поиска по префиксу и подстроке
+	static std::string primaryWeights(const std::string& text);
+
+	/// Возвращает длину первичной части ключа, построенного для названия длиной nameSize байт
+	static size_t primaryLength(const std::string& key, size_t nameSize) {
+		return key.size() - nameSize - 1;
+	}
+
+	/// Проверяет, является ли строка корректным UTF-8 с многобайтовыми символами
+	static bool isMultibyteUtf8(const std::string& str);
+
+	/// Сравнивает два ключа побайтово (беззнаково): отрицательное, ноль или положительное значение
+	static int compare(const std::string& a, const std::string& b) {
+		size_t n = a.size() < b.size() ? a.size() : b.size();
+		int cmp = std::memcmp(a.data(), b.data(), n);
+		if (cmp != 0) return cmp;
+		return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+	}
+
+	/// Сравнивает два ключа побайтово (беззнаково) через memcmp
+	static bool less(const std::string& a, const std::string& b) {
+		return compare(a, b) < 0;
+	}
+};
+
+#endif // COLLATION_H
\ No newline at end of file
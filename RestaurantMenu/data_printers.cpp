@@ -0,0 +1,248 @@
+﻿#include "data_printers.h"
+#include "printer.h"
+#include "formatting.h"
+#include "collation.h"
+#include <algorithm>
+
+// ==================== DATA MENU PRINTER ====================
+
+// Конструктор: записи копятся в буфере и уходят в поток крупными блоками
+DataMenuPrinter::DataMenuPrinter(std::ostream& sink)
+	: buffer_(sink) {}
+
+void DataMenuPrinter::printAllDishes(const std::vector<Dish>& dishes, int) const {
+	writeDocument(dishes, 0, dishes.size());
+}
+
+void DataMenuPrinter::printFilteredDishes(const std::vector<Dish>& dishes, const std::string&) const {
+	writeDocument(dishes, 0, dishes.size());
+}
+
+// Выводит только блюда запрошенной страницы
+void DataMenuPrinter::printPage(const std::vector<Dish>& dishes, size_t page, size_t pageSize, const std::string&) const {
+	pageSize = std::max<size_t>(1, pageSize);
+	const size_t first = page == 0 ? dishes.size() : std::min((page - 1) * pageSize, dishes.size());
+	const size_t last = std::min(first + pageSize, dishes.size());
+	writeDocument(dishes, first, last);
+}
+
+// Страница уже отобрана: несуществующей странице соответствует пустой rows
+void DataMenuPrinter::printPageRows(const std::vector<Dish>& rows, size_t, size_t, size_t, const std::string&) const {
+	writeDocument(rows, 0, rows.size());
+}
+
+void DataMenuPrinter::printStats(const MenuStats& stats) const {
+	writeStats(stats);
+	buffer_.flush();
+}
+
+// Пишет документ потоково: каждая запись сразу уходит в буфер
+void DataMenuPrinter::writeDocument(const std::vector<Dish>& dishes, size_t first, size_t last) const {
+	beginDocument();
+	for (size_t i = first; i < last; ++i) {
+		writeDish(dishes[i], i - first);
+	}
+	endDocument(last - first);
+	buffer_.flush();
+}
+
+// ==================== CSV ====================
+
+// Поле в кавычках, если без них его нельзя прочитать однозначно; кавычки внутри удваиваются
+void CsvMenuPrinter::appendField(std::string& out, const std::string& field) {
+	if (field.find_first_of(",\"\r\n") == std::string::npos) {
+		out.append(field);
+		return;
+	}
+	out.push_back('"');
+	for (char c : field) {
+		if (c == '"') out.push_back('"');
+		out.push_back(c);
+	}
+	out.push_back('"');
+}
+
+void CsvMenuPrinter::beginDocument() const {
+	buffer_.append("name,price,minutes\n");
+}
+
+void CsvMenuPrinter::writeDish(const Dish& dish, size_t) const {
+	row_.clear();
+	appendField(row_, dish.name);
+	row_.push_back(',');
+	DishFormat::appendPrice(row_, dish.price);
+	row_.push_back(',');
+	row_.append(std::to_string(dish.totalMinutes()));
+	row_.push_back('\n');
+	buffer_.append(row_);
+}
+
+void CsvMenuPrinter::endDocument(size_t) const {}
+
+// Агрегаты: по строке на показатель, колонки - цена и время в минутах
+void CsvMenuPrinter::writeStats(const MenuStats& stats) const {
+	row_.assign("metric,price,minutes\n");
+	row_.append("count," + std::to_string(stats.count()) + "," + std::to_string(stats.count()) + "\n");
+
+	const struct { const char* name; double price; double minutes; } rows[] = {
+		{ "min", stats.minPrice(), static_cast<double>(stats.minMinutes()) },
+		{ "mean", stats.meanPrice(), stats.meanMinutes() },
+		{ "max", stats.maxPrice(), static_cast<double>(stats.maxMinutes()) },
+		{ "p50", stats.priceQuantile(0.5), stats.minutesQuantile(0.5) },
+		{ "p90", stats.priceQuantile(0.9), stats.minutesQuantile(0.9) },
+		{ "p99", stats.priceQuantile(0.99), stats.minutesQuantile(0.99) },
+	};
+	for (const auto& item : rows) {
+		row_.append(item.name);
+		row_.push_back(',');
+		DishFormat::appendPrice(row_, item.price);
+		row_.push_back(',');
+		DishFormat::appendPrice(row_, item.minutes);
+		row_.push_back('\n');
+	}
+	buffer_.append(row_);
+}
+
+// ==================== JSON ====================
+
+// Кодовые точки символов CP1251 0x80-0xBF; 0xC0-0xFF - подряд А-я (U+0410-U+044F)
+static const unsigned short kCp1251Upper[64] = {
+	0x0402, 0x0403, 0x201A, 0x0453, 0x201E, 0x2026, 0x2020, 0x2021, 0x20AC, 0x2030, 0x0409, 0x2039, 0x040A, 0x040C, 0x040B, 0x040F,
+	0x0452, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0xFFFD, 0x2122, 0x0459, 0x203A, 0x045A, 0x045C, 0x045B, 0x045F,
+	0x00A0, 0x040E, 0x045E, 0x0408, 0x00A4, 0x0490, 0x00A6, 0x00A7, 0x0401, 0x00A9, 0x0404, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x0407,
+	0x00B0, 0x00B1, 0x0406, 0x0456, 0x0491, 0x00B5, 0x00B6, 0x00B7, 0x0451, 0x2116, 0x0454, 0x00BB, 0x0458, 0x0405, 0x0455, 0x0457
+};
+
+// Дописывает байт CP1251 >= 0x80 в UTF-8 (два или три байта)
+static void appendCp1251AsUtf8(std::string& out, unsigned char byte) {
+	const unsigned int cp = byte >= 0xC0 ? 0x0410u + (byte - 0xC0u) : kCp1251Upper[byte - 0x80];
+	if (cp < 0x800) {
+		out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+	}
+	else {
+		out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+		out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+	}
+	out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+}
+
+// Экранирует кавычки, обратную косую черту и управляющие символы; текст не в UTF-8 считается CP1251
+void JsonMenuPrinter::appendString(std::string& out, const std::string& text) {
+	static const char hex[] = "0123456789abcdef";
+	const bool cp1251 = std::any_of(text.begin(), text.end(), [](char c) { return static_cast<unsigned char>(c) >= 0x80; }) &&
+		!Collation::isMultibyteUtf8(text);
+	out.push_back('"');
+	for (char c : text) {
+		unsigned char byte = static_cast<unsigned char>(c);
+		switch (c) {
+		case '"': out.append("\\\""); break;
+		case '\\': out.append("\\\\"); break;
+		case '\n': out.append("\\n"); break;
+		case '\r': out.append("\\r"); break;
+		case '\t': out.append("\\t"); break;
+		default:
+			if (byte < 0x20) {
+				out.append("\\u00");
+				out.push_back(hex[byte >> 4]);
+				out.push_back(hex[byte & 0xF]);
+			}
+			else if (byte >= 0x80 && cp1251) {
+				appendCp1251AsUtf8(out, byte);
+			}
+			else {
+				out.push_back(c);
+			}
+		}
+	}
+	out.push_back('"');
+}
+
+void JsonMenuPrinter::appendDish(std::string& out, const Dish& dish) {
+	out.append("{\"name\":");
+	appendString(out, dish.name);
+	out.append(",\"price\":");
+	DishFormat::appendPrice(out, dish.price);
+	out.append(",\"minutes\":");
+	out.append(std::to_string(dish.totalMinutes()));
+	out.push_back('}');
+}
+
+// Объект агрегатов: {"count":N,"price":{...},"minutes":{...}}
+void JsonMenuPrinter::appendStats(std::string& out, const MenuStats& stats) {
+	const char* names[] = { "min", "mean", "max", "p50", "p90", "p99" };
+	const double prices[] = { stats.minPrice(), stats.meanPrice(), stats.maxPrice(),
+		stats.priceQuantile(0.5), stats.priceQuantile(0.9), stats.priceQuantile(0.99) };
+	const double minutes[] = { static_cast<double>(stats.minMinutes()), stats.meanMinutes(), static_cast<double>(stats.maxMinutes()),
+		stats.minutesQuantile(0.5), stats.minutesQuantile(0.9), stats.minutesQuantile(0.99) };
+
+	out.append("{\"count\":");
+	out.append(std::to_string(stats.count()));
+	for (int column = 0; column < 2; ++column) {
+		out.append(column == 0 ? ",\"price\":{" : ",\"minutes\":{");
+		for (size_t i = 0; i < 6; ++i) {
+			if (i > 0) out.push_back(',');
+			out.push_back('"');
+			out.append(names[i]);
+			out.append("\":");
+			DishFormat::appendPrice(out, column == 0 ? prices[i] : minutes[i]);
+		}
+		out.push_back('}');
+	}
+	out.push_back('}');
+}
+
+void JsonMenuPrinter::beginDocument() const {
+	buffer_.append('[');
+}
+
+// Записи разделяются запятой, каждая на своей строке
+void JsonMenuPrinter::writeDish(const Dish& dish, size_t index) const {
+	row_.assign(index == 0 ? "\n  " : ",\n  ");
+	appendDish(row_, dish);
+	buffer_.append(row_);
+}
+
+void JsonMenuPrinter::endDocument(size_t count) const {
+	buffer_.append(count == 0 ? "]\n" : "\n]\n");
+}
+
+void JsonMenuPrinter::writeStats(const MenuStats& stats) const {
+	row_.clear();
+	appendStats(row_, stats);
+	row_.push_back('\n');
+	buffer_.append(row_);
+}
+
+// ==================== NDJSON ====================
+
+void NdjsonMenuPrinter::beginDocument() const {}
+
+void NdjsonMenuPrinter::writeDish(const Dish& dish, size_t) const {
+	row_.clear();
+	JsonMenuPrinter::appendDish(row_, dish);
+	row_.push_back('\n');
+	buffer_.append(row_);
+}
+
+void NdjsonMenuPrinter::endDocument(size_t) const {}
+
+void NdjsonMenuPrinter::writeStats(const MenuStats& stats) const {
+	row_.clear();
+	JsonMenuPrinter::appendStats(row_, stats);
+	row_.push_back('\n');
+	buffer_.append(row_);
+}
+
+// ==================== PRINTER FORMATS ====================
+
+std::unique_ptr<IMenuPrinter> PrinterFormats::create(const std::string& format, std::ostream& sink) {
+	if (format == "table") return std::make_unique<MenuPrinter>(sink);
+	if (format == "csv") return std::make_unique<CsvMenuPrinter>(sink);
+	if (format == "json") return std::make_unique<JsonMenuPrinter>(sink);
+	if (format == "ndjson") return std::make_unique<NdjsonMenuPrinter>(sink);
+	return nullptr;
+}
+
+const char* PrinterFormats::names() {
+	return "table, csv, json, ndjson";
+}
\ No newline at end of file
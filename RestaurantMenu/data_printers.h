@@ -0,0 +1,117 @@
+﻿#pragma once
+#ifndef DATA_PRINTERS_H
+#define DATA_PRINTERS_H
+
+#include "interfaces.h"
+#include "models.h"
+#include "menu_stats.h"
+#include "output_buffer.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Основа машиночитаемых принтеров: блюда пишутся по одному в буфер вывода,
+/// поэтому документ целиком в памяти не строится. Заголовки таблиц и пояснения
+/// для человека не выводятся; CSV пишет названия в кодировке программы, JSON и NDJSON - в UTF-8.
+class DataMenuPrinter : public IMenuPrinter {
+protected:
+	mutable OutputBuffer buffer_;   ///< Буфер вывода, переиспользуемый между вызовами
+	mutable std::string row_;       ///< Переиспользуемая строка для форматирования одной записи
+
+	/// Начало документа (заголовок CSV, открывающая скобка JSON)
+	virtual void beginDocument() const = 0;
+
+	/// Одна запись блюда; index - номер записи в документе, начиная с 0
+	virtual void writeDish(const Dish& dish, size_t index) const = 0;
+
+	/// Конец документа
+	virtual void endDocument(size_t count) const = 0;
+
+	/// Агрегаты меню одним документом
+	virtual void writeStats(const MenuStats& stats) const = 0;
+
+public:
+	/// Конструктор с потоком назначения (по умолчанию - консоль)
+	explicit DataMenuPrinter(std::ostream& sink = std::cout);
+
+	/// Выводит все блюда; количество невалидных записей в данные не попадает
+	void printAllDishes(const std::vector<Dish>& dishes, int invalidCount) const override;
+
+	/// Выводит блюда; заголовок не выводится
+	void printFilteredDishes(const std::vector<Dish>& dishes, const std::string& title) const override;
+
+	/// Выводит блюда одной страницы; несуществующая страница дает пустой документ
+	void printPage(const std::vector<Dish>& dishes, size_t page, size_t pageSize, const std::string& title) const override;
+
+	/// Выводит заранее отобранные блюда страницы
+	void printPageRows(const std::vector<Dish>& rows, size_t page, size_t pageSize, size_t total, const std::string& title) const override;
+
+	/// Выводит агрегаты меню
+	void printStats(const MenuStats& stats) const override;
+
+private:
+	/// Пишет документ из блюд диапазона [first, last)
+	void writeDocument(const std::vector<Dish>& dishes, size_t first, size_t last) const;
+};
+
+/// CSV (RFC 4180): строка заголовка name,price,minutes и по строке на блюдо
+class CsvMenuPrinter : public DataMenuPrinter {
+public:
+	using DataMenuPrinter::DataMenuPrinter;
+
+	/// Добавляет поле CSV, заключая его в кавычки, если в нем есть запятая, кавычка или перевод строки
+	static void appendField(std::string& out, const std::string& field);
+
+protected:
+	void beginDocument() const override;
+	void writeDish(const Dish& dish, size_t index) const override;
+	void endDocument(size_t count) const override;
+	void writeStats(const MenuStats& stats) const override;
+};
+
+/// JSON: массив объектов {"name", "price", "minutes"}
+class JsonMenuPrinter : public DataMenuPrinter {
+public:
+	using DataMenuPrinter::DataMenuPrinter;
+
+	/// Добавляет строку JSON в кавычках с экранированием кавычек, \ и управляющих символов.
+	/// JSON - всегда UTF-8: названия в CP1251 перекодируются, корректный UTF-8 пишется как есть
+	static void appendString(std::string& out, const std::string& text);
+
+	/// Добавляет объект блюда одной строкой
+	static void appendDish(std::string& out, const Dish& dish);
+
+	/// Добавляет объект агрегатов меню одной строкой
+	static void appendStats(std::string& out, const MenuStats& stats);
+
+protected:
+	void beginDocument() const override;
+	void writeDish(const Dish& dish, size_t index) const override;
+	void endDocument(size_t count) const override;
+	void writeStats(const MenuStats& stats) const override;
+};
+
+/// NDJSON: по одному объекту JSON на строку, без общего массива
+class NdjsonMenuPrinter : public DataMenuPrinter {
+public:
+	using DataMenuPrinter::DataMenuPrinter;
+
+protected:
+	void beginDocument() const override;
+	void writeDish(const Dish& dish, size_t index) const override;
+	void endDocument(size_t count) const override;
+	void writeStats(const MenuStats& stats) const override;
+};
+
+/// Создание принтера по названию формата: table, csv, json, ndjson
+class PrinterFormats {
+public:
+	/// Возвращает принтер формата или nullptr, если формат неизвестен
+	static std::unique_ptr<IMenuPrinter> create(const std::string& format, std::ostream& sink = std::cout);
+
+	/// Список поддерживаемых форматов через запятую
+	static const char* names();
+};
+
+#endif // DATA_PRINTERS_H
\ No newline at end of file
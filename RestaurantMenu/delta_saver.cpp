@@ -0,0 +1,140 @@
+﻿#include "delta_saver.h"
+#include "menu_files.h"
+#include "menu_snapshot.h"
+#include "storage.h"
+#include "write_ahead_log.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+// Заголовок набора изменений: сигнатура, контрольная сумма базы, номер набора
+static const char kDeltaMagic[8] = { 'R', 'M', 'D', 'E', 'L', 'T', 'A', '1' };
+static const size_t kDeltaHeaderSize = sizeof(kDeltaMagic) + sizeof(uint64_t) + sizeof(uint32_t);
+
+// Удаляет наборы изменений, начиная с номера first, пока они есть
+static void removeDeltas(const std::string& path, size_t first) {
+	for (size_t number = first; std::remove(DeltaSaver::deltaPath(path, number).c_str()) == 0; ++number) {}
+}
+
+DeltaSaver::DeltaSaver()
+	: version_(0), baseChecksum_(0), baseCount_(0), deltaCount_(0), deltaRecords_(0) {}
+
+std::string DeltaSaver::deltaPath(const std::string& path, size_t number) {
+	return path + ".delta." + std::to_string(number);
+}
+
+void DeltaSaver::reset() {
+	path_.clear();
+}
+
+void DeltaSaver::forget(const std::string& path) {
+	if (path == path_) reset();
+}
+
+// Сначала атомарно пишется новая база, затем удаляются наборы: при сбое между шагами
+// старые наборы не подойдут к новой базе по контрольной сумме
+void DeltaSaver::saveFull(const IMenuStorage& storage, const std::string& path) {
+	baseChecksum_ = MenuSnapshot::save(storage.getDishes(), path);
+	removeDeltas(path, 1);
+	path_ = path;
+	version_ = storage.getVersion();
+	baseCount_ = storage.getDishesCount();
+	deltaCount_ = 0;
+	deltaRecords_ = 0;
+}
+
+DeltaSaver::Result DeltaSaver::save(const IMenuStorage& storage, const std::string& path, size_t& written) {
+	std::vector<Dish> added, removed;
+	if (path != path_ || !storage.getChangeSetSince(version_, added, removed)) {
+		saveFull(storage, path);
+		written = storage.getDishesCount();
+		return Result::Full;
+	}
+
+	const size_t records = added.size() + removed.size();
+	if (records == 0) {
+		version_ = storage.getVersion();
+		written = 0;
+		return Result::Unchanged;
+	}
+
+	// Наборы растут быстрее базы: объединяем, когда их много или они сравнимы с четвертью базы
+	const size_t recordLimit = std::max(kMinConsolidationRecords, baseCount_ / 4);
+	if (deltaCount_ + 1 > kMaxDeltas || deltaRecords_ + records > recordLimit) {
+		saveFull(storage, path);
+		written = storage.getDishesCount();
+		return Result::Consolidated;
+	}
+
+	// Удаления применяются раньше добавлений: блюдо, удаленное и снова добавленное, останется в меню
+	std::string data(kDeltaMagic, sizeof(kDeltaMagic));
+	const uint32_t number = static_cast<uint32_t>(deltaCount_ + 1);
+	data.append(reinterpret_cast<const char*>(&baseChecksum_), sizeof(baseChecksum_));
+	data.append(reinterpret_cast<const char*>(&number), sizeof(number));
+	for (const auto& dish : removed) {
+		WriteAheadLog::encodeRecord(data, WalRecordType::Remove, dish.name, dish.price, dish.totalMinutes());
+	}
+	for (const auto& dish : added) {
+		WriteAheadLog::encodeRecord(data, WalRecordType::Add, dish.name, dish.price, dish.totalMinutes());
+	}
+
+	AtomicFile file(deltaPath(path, number), true);
+	file.write(data.data(), data.size());
+	file.commit();
+
+	deltaCount_ = number;
+	deltaRecords_ += records;
+	version_ = storage.getVersion();
+	written = records;
+	return Result::Delta;
+}
+
+// Наборы применяются по порядку номеров, пока они относятся к этой базе и целы
+size_t DeltaSaver::load(const std::string& path, IMenuStorage& storage) {
+	MenuSnapshot::load(path, storage);
+	uint64_t baseChecksum = 0;
+	MenuSnapshot::readChecksum(path, baseChecksum);
+
+	size_t applied = 0;
+	size_t records = 0;
+	for (size_t number = 1; ; ++number) {
+		std::ifstream file(deltaPath(path, number), std::ios::binary);
+		if (!file.is_open()) break;
+		std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		uint64_t checksum = 0;
+		uint32_t storedNumber = 0;
+		if (data.size() < kDeltaHeaderSize || std::memcmp(data.data(), kDeltaMagic, sizeof(kDeltaMagic)) != 0) break;
+		std::memcpy(&checksum, data.data() + sizeof(kDeltaMagic), sizeof(checksum));
+		std::memcpy(&storedNumber, data.data() + sizeof(kDeltaMagic) + sizeof(checksum), sizeof(storedNumber));
+		if (checksum != baseChecksum || storedNumber != number) break;
+
+		size_t replayed = 0;
+		bool complete = WriteAheadLog::replayRecords(data.data() + kDeltaHeaderSize, data.size() - kDeltaHeaderSize, storage, replayed);
+		records += replayed;
+		if (!complete) {
+			throw std::runtime_error("Набор изменений поврежден: " + deltaPath(path, number));
+		}
+		applied++;
+	}
+
+	path_ = path;
+	version_ = storage.getVersion();
+	baseChecksum_ = baseChecksum;
+	baseCount_ = storage.getDishesCount();
+	deltaCount_ = applied;
+	deltaRecords_ = records;
+	return applied;
+}
+
+// Инструмент объединения: база и наборы загружаются в отдельное хранилище и записываются новой базой
+size_t DeltaSaver::consolidate(const std::string& path) {
+	MenuStorage merged;
+	DeltaSaver saver;
+	size_t applied = saver.load(path, merged);
+	saver.saveFull(merged, path);
+	return applied;
+}
\ No newline at end of file
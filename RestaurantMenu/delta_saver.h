@@ -0,0 +1,66 @@
+﻿#pragma once
+#ifndef DELTA_SAVER_H
+#define DELTA_SAVER_H
+
+#include "interfaces.h"
+#include <cstdint>
+#include <string>
+
+/// Разностные сохранения: базовый двоичный снимок (MenuSnapshot) в файле path и
+/// последовательность наборов изменений path.delta.1, path.delta.2, ...
+/// Набор изменений: сигнатура "RMDELTA1", контрольная сумма базового снимка (u64), номер (u32)
+/// и записи удаления/добавления в формате журнала WriteAheadLog. Набор применяется, только если
+/// он создан для этого же снимка, поэтому наборы от прежней базы после сбоя игнорируются.
+/// Изменения берутся из журнала хранилища (getChangeSetSince), так что повторное сохранение
+/// пишет только изменившиеся блюда; когда наборов становится много, база переписывается целиком.
+class DeltaSaver {
+public:
+	/// Что сделало сохранение
+	enum class Result {
+		Full,           ///< Записан новый базовый снимок (первое сохранение или журнал хранилища переполнен)
+		Delta,          ///< Дописан набор изменений
+		Unchanged,      ///< Изменений с прошлого сохранения нет
+		Consolidated    ///< Наборов стало слишком много - база переписана, наборы удалены
+	};
+
+	static constexpr size_t kMaxDeltas = 32;            ///< Наборов изменений до объединения с базой
+	static constexpr size_t kMinConsolidationRecords = 4096; ///< Записей в наборах, которые допустимы для любой базы
+
+private:
+	std::string path_;          ///< Файл, для которого отслеживаются изменения (пустой - не отслеживаются)
+	uint64_t version_;          ///< Версия хранилища на момент последнего сохранения или загрузки
+	uint64_t baseChecksum_;     ///< Контрольная сумма базового снимка
+	size_t baseCount_;          ///< Блюд в базовом снимке
+	size_t deltaCount_;         ///< Записано наборов изменений
+	size_t deltaRecords_;       ///< Записей во всех наборах
+
+	/// Переписывает базу текущим состоянием и удаляет наборы изменений
+	void saveFull(const IMenuStorage& storage, const std::string& path);
+
+public:
+	DeltaSaver();
+
+	/// Сохраняет хранилище в path: набором изменений, если path уже сохранялся или загружался
+	/// этим объектом и журнал хранилища покрывает изменения, иначе полной записью.
+	/// written - количество записанных блюд или изменений
+	Result save(const IMenuStorage& storage, const std::string& path, size_t& written);
+
+	/// Загружает базу и все подходящие к ней наборы изменений; начинает отслеживать path.
+	/// Возвращает количество примененных наборов
+	size_t load(const std::string& path, IMenuStorage& storage);
+
+	/// Перестает отслеживать файл (после загрузки другого меню)
+	void reset();
+
+	/// Сообщает, что path переписан в обход этого объекта: если он отслеживался, наборы изменений
+	/// больше не подходят к его базе, и следующее сохранение будет полной записью
+	void forget(const std::string& path);
+
+	/// Объединяет базу path с наборами изменений в новую базу и удаляет наборы; возвращает число наборов
+	static size_t consolidate(const std::string& path);
+
+	/// Путь набора изменений с номером number
+	static std::string deltaPath(const std::string& path, size_t number);
+};
+
+#endif // DELTA_SAVER_H
\ No newline at end of file
@@ -1,5 +1,6 @@
 ﻿#include "file_parser.h"
 #include "utils.h"
+#include "formatting.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
@@ -35,6 +36,7 @@ MenuFileParser::MenuFileParser()
 	, name_pattern_("\"([^\"]+)\"")                    // Название в двойных кавычках
 	, time_pattern_(R"(\b(\d+:(?:[0-5]?\d|59))\b)")   // Время: часы любые, минуты 0-59
 	, price_pattern_(R"(\b(-?\d+[.,]\d+)\b)")         // Цена: строго дробное с точкой или запятой
+	, log_(&std::cout)
 {}
 
 // Парсит файл с меню, заполняет хранилище и подсчитывает невалидные строки
@@ -51,13 +53,26 @@ void MenuFileParser::parseFile(const std::string& filename, IMenuStorage& storag
 		if (!line.empty()) {
 			if (!parseDishLine(line, storage)) {
 				invalidCount++;
-				std::cout << "Невалидная строка " << lineNum << ": " << line << std::endl;
+				if (log_) *log_ << "Невалидная строка " << lineNum << ": " << line << std::endl;
 			}
 		}
 	}
 	file.close();
 }
 
+// Выводит строку журнала о добавленном блюде без промежуточных потоков
+void MenuFileParser::logAdded(const std::string& name, double price, const Time& time) {
+	if (!log_) return;
+	logLine_.assign("+ Добавлено блюдо: ");
+	logLine_.append(name);
+	logLine_.append(" цена: ");
+	DishFormat::appendPrice(logLine_, price);
+	logLine_.append(" время: ");
+	DishFormat::appendTime(logLine_, time);
+	logLine_.push_back('\n');
+	*log_ << logLine_;
+}
+
 // Парсит отдельную строку с информацией о блюде
 bool MenuFileParser::parseDishLine(const std::string& line, IMenuStorage& storage) {
 	std::string name;
@@ -67,13 +82,13 @@ bool MenuFileParser::parseDishLine(const std::string& line, IMenuStorage& storag
 	if (extractValuesWithRegex(line, name, price, time)) {
 		// Проверяем только цену (должна быть положительной)
 		if (price <= 0) {
-			std::cout << "- Отсеяно: отрицательная или нулевая цена: " << price << std::endl;
+			if (log_) *log_ << "- Отсеяно: отрицательная или нулевая цена: " << price << std::endl;
 			return false;
 		}
 
 		// Передаём полный объект Time
 		storage.addDish(name, price, time);
-		std::cout << "+ Добавлено блюдо: " << name << " цена: " << price << " время: " << time.toString() << std::endl;
+		logAdded(name, price, time);
 		return true;
 	}
 
@@ -89,37 +104,37 @@ bool MenuFileParser::extractValuesWithRegex(const std::string& line, std::string
 
 	// Используем единую функцию для поиска и извлечения значений
 	if (!findAndExtractValue(workingLine, name_pattern_, nameResult, 1)) {
-		std::cout << "- Не найдено название в кавычках" << std::endl;
+		if (log_) *log_ << "- Не найдено название в кавычках" << std::endl;
 		return false;
 	}
 
 	// Обрезаем пробелы в названии и проверяем что оно не пустое
 	name = StringUtils::trim(nameResult);
 	if (name.empty()) {
-		std::cout << "- Отсеяно: название блюда не может быть пустым" << std::endl;
+		if (log_) *log_ << "- Отсеяно: название блюда не может быть пустым" << std::endl;
 		return false;
 	}
 
 	if (!findAndExtractValue(workingLine, time_pattern_, timeResult)) {
-		std::cout << "- Не найдено время в формате чч:мм" << std::endl;
+		if (log_) *log_ << "- Не найдено время в формате чч:мм" << std::endl;
 		return false;
 	}
 
 	if (!findAndExtractValue(workingLine, std::regex(price_pattern_), priceResult)) {
-		std::cout << "- Не найдена цена" << std::endl;
+		if (log_) *log_ << "- Не найдена цена" << std::endl;
 		return false;
 	}
 
 	// Парсим время
 	if (!timeParser_->parse(timeResult)) {
-		std::cout << "- Ошибка парсинга времени: " << timeParser_->getErrorMessage() << std::endl;
+		if (log_) *log_ << "- Ошибка парсинга времени: " << timeParser_->getErrorMessage() << std::endl;
 		return false;
 	}
 	time = timeParser_->getResult();
 
 	// Парсим цену
 	if (!numberParser_->parse(priceResult)) {
-		std::cout << "- Ошибка парсинга цены: " << numberParser_->getErrorMessage() << std::endl;
+		if (log_) *log_ << "- Ошибка парсинга цены: " << numberParser_->getErrorMessage() << std::endl;
 		return false;
 	}
 	price = numberParser_->getResult();
@@ -127,7 +142,7 @@ bool MenuFileParser::extractValuesWithRegex(const std::string& line, std::string
 	// Проверяем, что в строке не осталось лишних данных
 	workingLine = StringUtils::trim(workingLine);
 	if (!workingLine.empty()) {
-		std::cout << "- Обнаружены лишние данные в строке: '" << workingLine << "'" << std::endl;
+		if (log_) *log_ << "- Обнаружены лишние данные в строке: '" << workingLine << "'" << std::endl;
 		return false;
 	}
 
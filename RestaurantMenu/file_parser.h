@@ -5,6 +5,7 @@
 #include "interfaces.h"
 #include "parsers.h"
 #include <memory>
+#include <ostream>
 #include <regex>
 #include <string>
 
@@ -19,9 +20,15 @@ private:
 	std::regex time_pattern_;   ///< Шаблон для извлечения времени в формате чч:мм
 	std::regex price_pattern_;  ///< Шаблон для извлечения числовых цен
 
+	std::string logLine_;       ///< Переиспользуемая строка журнала загрузки
+	std::ostream* log_;         ///< Поток журнала загрузки и причин отсева строк (nullptr - без журнала)
+
 public:
 	MenuFileParser();
 
+	/// Задает поток журнала загрузки; nullptr - разбирать молча (например, в рабочих потоках)
+	void setLog(std::ostream* log) override { log_ = log; }
+
 	/// Парсит файл с меню, заполняет хранилище и подсчитывает невалидные строки
 	void parseFile(const std::string& filename, IMenuStorage& storage, int& invalidCount) override;
 
@@ -31,6 +38,9 @@ public:
 private:
 	/// Внутренний метод для парсинга отдельной строки с информацией о блюде
 	bool parseDishLine(const std::string& line, IMenuStorage& storage);
+
+	/// Выводит строку журнала о добавленном блюде
+	void logAdded(const std::string& name, double price, const Time& time);
 };
 
 #endif // FILE_PARSER_H
\ No newline at end of file
@@ -0,0 +1,255 @@
+﻿#include "filter_kernels.h"
+#include <array>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FILTER_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define KERNELS_TARGET_AVX2
+#else
+#define KERNELS_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+#endif
+
+// ==================== ТАБЛИЦЫ СЖАТИЯ ====================
+
+// Номера установленных битов маски (для 4 и 8 линий), дополненные нулями.
+// Прибавив к ним номер первой строки группы, получаем готовые элементы вектора выбора.
+template <size_t Lanes>
+static const std::array<std::array<uint32_t, Lanes>, (1u << Lanes)>& compressTable() {
+	static const std::array<std::array<uint32_t, Lanes>, (1u << Lanes)> table = [] {
+		std::array<std::array<uint32_t, Lanes>, (1u << Lanes)> t{};
+		for (uint32_t mask = 0; mask < (1u << Lanes); ++mask) {
+			size_t n = 0;
+			for (uint32_t lane = 0; lane < Lanes; ++lane) {
+				if (mask & (1u << lane)) t[mask][n++] = lane;
+			}
+		}
+		return t;
+	}();
+	return table;
+}
+
+// Количество установленных битов в 4-битной маске
+static const uint8_t kPopcount4[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+// ==================== СКАЛЯРНЫЕ ЯДРА ====================
+
+// Скалярный отбор без ветвлений: номер записывается всегда, счетчик сдвигается по условию
+template <typename T>
+static size_t selectRangeScalar(const T* values, size_t begin, size_t count, T minValue, T maxValue,
+	uint32_t* selection, size_t n) {
+	for (size_t i = begin; i < count; ++i) {
+		selection[n] = static_cast<uint32_t>(i);
+		n += (values[i] >= minValue) & (values[i] < maxValue);
+	}
+	return n;
+}
+
+// Скалярное сужение вектора выбора
+template <typename T>
+static size_t refineRangeScalar(const T* values, const uint32_t* selection, size_t count,
+	T minValue, T maxValue, uint32_t* out) {
+	size_t n = 0;
+	for (size_t i = 0; i < count; ++i) {
+		uint32_t row = selection[i];
+		T value = values[row];
+		out[n] = row;
+		n += (value >= minValue) & (value < maxValue);
+	}
+	return n;
+}
+
+#ifdef FILTER_KERNELS_X86
+// ==================== SSE2 ====================
+
+// Цены: 2 значения за сравнение
+static size_t selectRangeSse2(const double* values, size_t count, double minValue, double maxValue, uint32_t* selection) {
+	const auto& compress = compressTable<4>();
+	const __m128d lo = _mm_set1_pd(minValue);
+	const __m128d hi = _mm_set1_pd(maxValue);
+	size_t n = 0;
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2) {
+		__m128d x = _mm_loadu_pd(values + i);
+		int bits = _mm_movemask_pd(_mm_and_pd(_mm_cmpge_pd(x, lo), _mm_cmplt_pd(x, hi)));
+		__m128i rows = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(i)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(compress[bits].data())));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(selection + n), rows);
+		n += kPopcount4[bits];
+	}
+	return selectRangeScalar(values, i, count, minValue, maxValue, selection, n);
+}
+
+// Время: 4 значения за сравнение
+static size_t selectRangeSse2(const int32_t* values, size_t count, int32_t minValue, int32_t maxValue, uint32_t* selection) {
+	const auto& compress = compressTable<4>();
+	const __m128i lo = _mm_set1_epi32(minValue);
+	const __m128i hi = _mm_set1_epi32(maxValue);
+	size_t n = 0;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+		__m128i mask = _mm_andnot_si128(_mm_cmpgt_epi32(lo, x), _mm_cmplt_epi32(x, hi));
+		int bits = _mm_movemask_ps(_mm_castsi128_ps(mask));
+		__m128i rows = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(i)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(compress[bits].data())));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(selection + n), rows);
+		n += kPopcount4[bits];
+	}
+	return selectRangeScalar(values, i, count, minValue, maxValue, selection, n);
+}
+
+// ==================== AVX2 ====================
+
+// Цены: 4 значения за сравнение
+KERNELS_TARGET_AVX2
+static size_t selectRangeAvx2(const double* values, size_t count, double minValue, double maxValue, uint32_t* selection) {
+	const auto& compress = compressTable<4>();
+	const __m256d lo = _mm256_set1_pd(minValue);
+	const __m256d hi = _mm256_set1_pd(maxValue);
+	size_t n = 0;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m256d x = _mm256_loadu_pd(values + i);
+		__m256d mask = _mm256_and_pd(_mm256_cmp_pd(x, lo, _CMP_GE_OQ), _mm256_cmp_pd(x, hi, _CMP_LT_OQ));
+		int bits = _mm256_movemask_pd(mask);
+		__m128i rows = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(i)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(compress[bits].data())));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(selection + n), rows);
+		n += kPopcount4[bits];
+	}
+	return selectRangeScalar(values, i, count, minValue, maxValue, selection, n);
+}
+
+// Время: 8 значений за сравнение
+KERNELS_TARGET_AVX2
+static size_t selectRangeAvx2(const int32_t* values, size_t count, int32_t minValue, int32_t maxValue, uint32_t* selection) {
+	const auto& compress = compressTable<8>();
+	const __m256i lo = _mm256_set1_epi32(minValue);
+	const __m256i hi = _mm256_set1_epi32(maxValue);
+	size_t n = 0;
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+		__m256i mask = _mm256_andnot_si256(_mm256_cmpgt_epi32(lo, x), _mm256_cmpgt_epi32(hi, x));
+		unsigned bits = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+		__m256i rows = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(compress[bits].data())));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(selection + n), rows);
+		n += _mm_popcnt_u32(bits);
+	}
+	return selectRangeScalar(values, i, count, minValue, maxValue, selection, n);
+}
+#endif
+
+// ==================== FILTER KERNELS ====================
+
+// Определяет лучший набор инструкций один раз за время работы программы
+KernelIsa FilterKernels::detectIsa() {
+	static const KernelIsa isa = [] {
+#ifdef FILTER_KERNELS_X86
+#if defined(_MSC_VER)
+		int info[4] = {};
+		__cpuid(info, 0);
+		if (info[0] >= 7) {
+			__cpuid(info, 1);
+			bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+			__cpuidex(info, 7, 0);
+			if (osSavesYmm && (info[1] & (1 << 5)) != 0) return KernelIsa::Avx2;
+		}
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return KernelIsa::Avx2;
+#endif
+		return KernelIsa::Sse2;
+#else
+		return KernelIsa::Scalar;
+#endif
+	}();
+	return isa;
+}
+
+// Возвращает название набора инструкций
+const char* FilterKernels::isaName(KernelIsa isa) {
+	switch (isa) {
+	case KernelIsa::Avx2: return "AVX2";
+	case KernelIsa::Sse2: return "SSE2";
+	default: return "scalar";
+	}
+}
+
+// Отбирает строки с ценой в диапазоне
+size_t FilterKernels::selectRange(const double* values, size_t count, double minValue, double maxValue,
+	uint32_t* selection, KernelIsa isa) {
+#ifdef FILTER_KERNELS_X86
+	if (isa == KernelIsa::Avx2 && detectIsa() == KernelIsa::Avx2) {
+		return selectRangeAvx2(values, count, minValue, maxValue, selection);
+	}
+	if (isa != KernelIsa::Scalar) {
+		return selectRangeSse2(values, count, minValue, maxValue, selection);
+	}
+#endif
+	return selectRangeScalar(values, 0, count, minValue, maxValue, selection, 0);
+}
+
+// Отбирает строки со временем в диапазоне
+size_t FilterKernels::selectRange(const int32_t* values, size_t count, int32_t minValue, int32_t maxValue,
+	uint32_t* selection, KernelIsa isa) {
+#ifdef FILTER_KERNELS_X86
+	if (isa == KernelIsa::Avx2 && detectIsa() == KernelIsa::Avx2) {
+		return selectRangeAvx2(values, count, minValue, maxValue, selection);
+	}
+	if (isa != KernelIsa::Scalar) {
+		return selectRangeSse2(values, count, minValue, maxValue, selection);
+	}
+#endif
+	return selectRangeScalar(values, 0, count, minValue, maxValue, selection, 0);
+}
+
+// Сужает вектор выбора условием по цене
+size_t FilterKernels::refineRange(const double* values, const uint32_t* selection, size_t count,
+	double minValue, double maxValue, uint32_t* out) {
+	return refineRangeScalar(values, selection, count, minValue, maxValue, out);
+}
+
+// Сужает вектор выбора условием по времени
+size_t FilterKernels::refineRange(const int32_t* values, const uint32_t* selection, size_t count,
+	int32_t minValue, int32_t maxValue, uint32_t* out) {
+	return refineRangeScalar(values, selection, count, minValue, maxValue, out);
+}
+
+// ==================== MENU COLUMNS ====================
+
+// Строит только запрошенные столбцы за один проход по блюдам
+MenuColumns MenuColumns::build(const std::vector<Dish>& dishes, bool withPrices, bool withMinutes) {
+	MenuColumns columns;
+	if (withPrices) columns.prices.reserve(dishes.size());
+	if (withMinutes) columns.minutes.reserve(dishes.size());
+
+	for (const auto& dish : dishes) {
+		if (withPrices) columns.prices.push_back(dish.price);
+		// Время нормализовано и ограничено 999 годами, поэтому помещается в int32_t
+		if (withMinutes) columns.minutes.push_back(static_cast<int32_t>(dish.totalMinutes()));
+	}
+	return columns;
+}
+
+// Добавляет строку блюда в конец обоих столбцов
+void MenuColumns::add(const Dish& dish) {
+	prices.push_back(dish.price);
+	minutes.push_back(static_cast<int32_t>(dish.totalMinutes()));
+}
+
+// Переносит строку from на место to
+void MenuColumns::moveRow(size_t from, size_t to) {
+	prices[to] = prices[from];
+	minutes[to] = minutes[from];
+}
+
+// Оставляет первые rows строк
+void MenuColumns::resize(size_t rows) {
+	prices.resize(rows);
+	minutes.resize(rows);
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+﻿#pragma once
+#ifndef FILTER_KERNELS_H
+#define FILTER_KERNELS_H
+
+#include "models.h"
+#include <cstdint>
+#include <vector>
+
+/// Набор инструкций, используемый ядрами фильтрации
+enum class KernelIsa {
+	Scalar,     ///< Переносимый скалярный цикл без ветвлений
+	Sse2,       ///< 2 цены / 4 значения времени за инструкцию
+	Avx2        ///< 4 цены / 8 значений времени за инструкцию
+};
+
+/// Векторизованные ядра фильтрации по столбцам цен и времени.
+/// Результат - вектор выбора: возрастающие номера строк, прошедших условие.
+/// Буфер selection должен вмещать count + kSelectionSlack элементов: SIMD-ядра
+/// записывают за один шаг целую группу номеров, даже если подходят не все.
+class FilterKernels {
+public:
+	static const size_t kSelectionSlack = 8;    ///< Запас в конце буфера выбора
+
+	/// Возвращает лучший набор инструкций, поддерживаемый процессором и ОС (определяется один раз)
+	static KernelIsa detectIsa();
+
+	/// Возвращает название набора инструкций для диагностики
+	static const char* isaName(KernelIsa isa);
+
+	/// Отбирает строки, для которых minValue <= values[i] < maxValue
+	static size_t selectRange(const double* values, size_t count, double minValue, double maxValue,
+		uint32_t* selection, KernelIsa isa = detectIsa());
+
+	/// Отбирает строки, для которых minValue <= values[i] < maxValue
+	static size_t selectRange(const int32_t* values, size_t count, int32_t minValue, int32_t maxValue,
+		uint32_t* selection, KernelIsa isa = detectIsa());
+
+	/// Сужает вектор выбора условием minValue <= values[row] < maxValue (out может совпадать с selection)
+	static size_t refineRange(const double* values, const uint32_t* selection, size_t count,
+		double minValue, double maxValue, uint32_t* out);
+
+	/// Сужает вектор выбора условием minValue <= values[row] < maxValue (out может совпадать с selection)
+	static size_t refineRange(const int32_t* values, const uint32_t* selection, size_t count,
+		int32_t minValue, int32_t maxValue, uint32_t* out);
+};
+
+/// Столбцовое представление числовых полей меню для векторизованной фильтрации
+struct MenuColumns {
+	std::vector<double> prices;     ///< Цены блюд по строкам
+	std::vector<int32_t> minutes;   ///< Время приготовления в минутах по строкам
+
+	/// Строит только запрошенные столбцы за один проход по блюдам
+	static MenuColumns build(const std::vector<Dish>& dishes, bool withPrices, bool withMinutes);
+
+	/// Добавляет строку блюда в конец обоих столбцов
+	void add(const Dish& dish);
+
+	/// Переносит строку from на место to (для уплотнения после удаления)
+	void moveRow(size_t from, size_t to);
+
+	/// Оставляет первые rows строк
+	void resize(size_t rows);
+
+	/// Количество строк (оба столбца заполнены)
+	size_t size() const { return prices.size(); }
+};
+
+#endif // FILTER_KERNELS_H
\ No newline at end of file
@@ -0,0 +1,146 @@
+﻿#include "formatting.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+// Пишет целое число через to_chars
+static char* writeInt(char* out, long long value) {
+	return std::to_chars(out, out + 24, value).ptr;
+}
+
+// Пишет строковый литерал без завершающего нуля
+template <size_t N>
+static char* writeLiteral(char* out, const char (&literal)[N]) {
+	std::memcpy(out, literal, N - 1);
+	return out + N - 1;
+}
+
+// Ширина текста на экране: корректный многобайтовый UTF-8 считается по символам, иначе по байтам
+size_t DishFormat::displayWidth(const char* text, size_t size) {
+	size_t characters = 0;
+	bool multibyte = false;
+	for (size_t i = 0; i < size; ) {
+		unsigned char lead = static_cast<unsigned char>(text[i]);
+		size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+		if (length == 0 || i + length > size) return size;
+		for (size_t k = 1; k < length; ++k) {
+			if ((static_cast<unsigned char>(text[i + k]) & 0xC0) != 0x80) return size;
+		}
+		multibyte = multibyte || length > 1;
+		characters++;
+		i += length;
+	}
+	return multibyte ? characters : size;
+}
+
+// Пишет время в формате Time::toString
+size_t DishFormat::formatTime(const Time& time, char* out) {
+	char* p = out;
+	const int years = time.getYears();
+	const int days = time.getDays();
+	const int hours = time.getHours();
+
+	if (years > 0) {
+		p = writeInt(p, years);
+		p = writeLiteral(p, "г. ");
+	}
+	if (days > 0 || years > 0) {
+		p = writeInt(p, days);
+		p = writeLiteral(p, "д. ");
+	}
+	if (hours > 0 || days > 0 || years > 0) {
+		p = writeInt(p, hours);
+		p = writeLiteral(p, "ч ");
+	}
+	p = writeInt(p, time.getMinutes());
+	p = writeLiteral(p, "м");
+	return static_cast<size_t>(p - out);
+}
+
+// Пишет цену с двумя знаками после точки
+size_t DishFormat::formatPrice(double price, char* out) {
+	auto result = std::to_chars(out, out + kMaxPriceLength, price, std::chars_format::fixed, 2);
+	if (result.ec != std::errc()) {
+		// Астрономические цены не помещаются в фиксированную запись - выводим в научной
+		result = std::to_chars(out, out + kMaxPriceLength, price, std::chars_format::scientific, 2);
+	}
+	return static_cast<size_t>(result.ptr - out);
+}
+
+// Добавляет время к строке
+void DishFormat::appendTime(std::string& out, const Time& time) {
+	char buffer[kMaxTimeLength];
+	out.append(buffer, formatTime(time, buffer));
+}
+
+// Добавляет цену к строке
+void DishFormat::appendPrice(std::string& out, double price) {
+	char buffer[kMaxPriceLength];
+	out.append(buffer, formatPrice(price, buffer));
+}
+
+// Добавляет текст, дополненный пробелами до ширины на экране
+void DishFormat::appendPadded(std::string& out, const std::string& text, size_t width) {
+	out.append(text);
+	size_t shown = displayWidth(text.data(), text.size());
+	if (shown < width) out.append(width - shown, ' ');
+}
+
+// Добавляет число, выровненное по правому краю колонки
+void DishFormat::appendRightAligned(std::string& out, size_t value, size_t width) {
+	char buffer[24];
+	size_t length = static_cast<size_t>(std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer);
+	if (length < width) out.append(width - length, ' ');
+	out.append(buffer, length);
+}
+
+// Добавляет строку таблицы меню
+void DishFormat::appendRow(std::string& out, const Dish& dish) {
+	appendPadded(out, dish.name, kNameWidth);
+
+	char buffer[kMaxTimeLength];
+	size_t length = formatPrice(dish.price, buffer);
+	out.append(buffer, length);
+	if (length < kPriceWidth) out.append(kPriceWidth - length, ' ');
+
+	out.append(buffer, formatTime(dish.time, buffer));
+}
+
+// Добавляет цену для файла меню так, чтобы при загрузке получилось то же значение
+void DishFormat::appendFilePrice(std::string& out, double price) {
+	char buffer[kMaxPriceLength];
+	size_t length = formatPrice(price, buffer);
+	double parsed = 0.0;
+	auto check = std::from_chars(buffer, buffer + length, parsed);
+	if (check.ec == std::errc() && parsed == price) {
+		out.append(buffer, length);
+		return;
+	}
+
+	// Двух знаков мало: кратчайшая фиксированная запись, однозначно задающая число
+	char exact[400];
+	auto result = std::to_chars(exact, exact + sizeof(exact), price, std::chars_format::fixed);
+	out.append(exact, result.ptr);
+	if (std::find(exact, result.ptr, '.') == result.ptr) out.append(".0");
+}
+
+// Добавляет время в формате ч:мм
+void DishFormat::appendClock(std::string& out, const Time& time) {
+	const long long minutes = time.totalMinutes();
+	char buffer[24];
+	char* p = writeInt(buffer, minutes / 60);
+	*p++ = ':';
+	*p++ = static_cast<char>('0' + minutes % 60 / 10);
+	*p++ = static_cast<char>('0' + minutes % 10);
+	out.append(buffer, p);
+}
+
+// Добавляет строку файла меню
+void DishFormat::appendFileLine(std::string& out, const Dish& dish) {
+	out.push_back('"');
+	out.append(dish.name);
+	out.append("\" ");
+	appendFilePrice(out, dish.price);
+	out.push_back(' ');
+	appendClock(out, dish.time);
+}
\ No newline at end of file
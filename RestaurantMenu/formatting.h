@@ -0,0 +1,56 @@
+﻿#pragma once
+#ifndef FORMATTING_H
+#define FORMATTING_H
+
+#include "models.h"
+#include <cstddef>
+#include <string>
+
+/// Форматирование блюд и времени без промежуточных потоков: числа пишутся через std::to_chars
+/// прямо в буфер вызывающего, отступы считаются по ширине на экране, а не по байтам.
+/// При повторном использовании одной строки-буфера вывод строки меню не выделяет память.
+class DishFormat {
+public:
+	static constexpr size_t kNameWidth = 25;        ///< Ширина колонки названия (в символах на экране)
+	static constexpr size_t kPriceWidth = 10;       ///< Ширина колонки цены
+	static constexpr size_t kMaxTimeLength = 64;    ///< Максимальная длина текста времени в байтах
+	static constexpr size_t kMaxPriceLength = 32;   ///< Максимальная длина текста цены в байтах
+
+	/// Ширина текста на экране: для UTF-8 каждый символ занимает одну позицию, для CP1251 - каждый байт
+	static size_t displayWidth(const char* text, size_t size);
+
+	/// Пишет время в формате Time::toString ("1г. 3д. 2ч 30м"), возвращает количество байт.
+	/// Буфер должен вмещать kMaxTimeLength байт
+	static size_t formatTime(const Time& time, char* out);
+
+	/// Пишет цену с двумя знаками после точки, возвращает количество байт.
+	/// Буфер должен вмещать kMaxPriceLength байт
+	static size_t formatPrice(double price, char* out);
+
+	/// Добавляет время к строке
+	static void appendTime(std::string& out, const Time& time);
+
+	/// Добавляет цену к строке
+	static void appendPrice(std::string& out, double price);
+
+	/// Добавляет текст, дополненный пробелами до ширины width на экране
+	static void appendPadded(std::string& out, const std::string& text, size_t width);
+
+	/// Добавляет число, выровненное по правому краю колонки ширины width
+	static void appendRightAligned(std::string& out, size_t value, size_t width);
+
+	/// Добавляет строку таблицы меню: название, цена и время в колонках фиксированной ширины
+	static void appendRow(std::string& out, const Dish& dish);
+
+	/// Добавляет цену для файла меню: два знака после точки, если этого достаточно для точного
+	/// восстановления значения, иначе кратчайшая точная запись; точка присутствует всегда
+	static void appendFilePrice(std::string& out, double price);
+
+	/// Добавляет время в формате ч:мм, где часы - все время приготовления в часах
+	static void appendClock(std::string& out, const Time& time);
+
+	/// Добавляет строку файла меню в грамматике загрузчика: "Название" цена ч:мм
+	static void appendFileLine(std::string& out, const Dish& dish);
+};
+
+#endif // FORMATTING_H
\ No newline at end of file
@@ -2,6 +2,9 @@
 #ifndef INTERFACES_H
 #define INTERFACES_H
 
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
 #include <vector>
 #include <string>
 #include <memory>
@@ -9,6 +12,10 @@
 // Предварительные объявления для уменьшения зависимости от заголовков
 class Dish;
 class Time;
+struct DishPredicate;
+class MenuStats;
+struct MenuColumns;
+class IDishIndex;
 
 // ==================== ИНТЕРФЕЙСЫ ====================
 
@@ -35,6 +42,10 @@ public:
 	/// Добавляет новое блюдо в хранилище
 	virtual void addDish(const std::string& name, double price, const Time& time) = 0;
 
+	/// Добавляет блюда пакетом при загрузке файла: память резервируется один раз, индексы и агрегаты
+	/// заполняются без поблюдного журнала - журнал изменений начинается заново, как после очистки
+	virtual void addDishes(std::vector<Dish> dishes) = 0;
+
 	/// Возвращает константную ссылку на вектор всех блюд
 	virtual const std::vector<Dish>& getDishes() const = 0;
 
@@ -47,8 +58,63 @@ public:
 	/// Удаляет конкретное блюдо по всем параметрам
 	virtual bool removeDish(const std::string& name, double price, const Time& time) = 0;
 
+	/// Применяет пакет изменений одним проходом: удаляет блюда, для которых removes возвращает true,
+	/// и вливает added в упорядоченное по алфавиту хранилище. Возвращает количество удаленных блюд
+	virtual size_t applyBatch(std::vector<Dish> added, const std::function<bool(const Dish&)>& removes) = 0;
+
+	/// Упорядочивает блюда по алфавиту; уже упорядоченное начало не сортируется заново
+	virtual void sortByName() = 0;
+
 	/// Сохраняет все блюда в указанный файл
 	virtual void saveToFile(const std::string& filename) const = 0;
+
+	/// Возвращает до limit различных названий, начинающихся с текста (без учета регистра)
+	virtual std::vector<std::string> findNamesByPrefix(const std::string& prefix, size_t limit) const = 0;
+
+	/// Возвращает до limit различных названий, содержащих текст (без учета регистра)
+	virtual std::vector<std::string> findNamesBySubstring(const std::string& fragment, size_t limit) const = 0;
+
+	/// Возвращает до limit названий, похожих на текст (не более maxDistance опечаток), от самых близких
+	virtual std::vector<std::string> findSimilarNames(const std::string& text, size_t maxDistance, size_t limit) const = 0;
+
+	/// Возвращает версию содержимого: увеличивается при каждом изменении хранилища
+	virtual uint64_t getVersion() const = 0;
+
+	/// Собирает блюда, добавленные или удаленные после версии version.
+	/// Возвращает false, если журнал изменений столько не хранит (например, после очистки)
+	virtual bool getChangesSince(uint64_t version, std::vector<Dish>& changed) const = 0;
+
+	/// Собирает итог изменений после версии: добавленные и удаленные блюда, причем добавление
+	/// и последующее удаление того же блюда взаимно сокращаются. false - журнал столько не хранит
+	virtual bool getChangeSetSince(uint64_t version, std::vector<Dish>& added, std::vector<Dish>& removed) const = 0;
+
+	/// Создает (или заменяет) именованное представление - фильтр, поддерживаемый при каждом изменении
+	virtual void defineView(const std::string& name, const DishPredicate& predicate) = 0;
+
+	/// Удаляет представление; возвращает false, если его не было
+	virtual bool dropView(const std::string& name) = 0;
+
+	/// Возвращает строки представления; false, если представление не найдено
+	virtual bool getView(const std::string& name, std::vector<Dish>& rows) const = 0;
+
+	/// Возвращает количество строк представления без копирования строк; false, если представление не найдено
+	virtual bool getViewSize(const std::string& name, size_t& size) const = 0;
+
+	/// Возвращает не более count строк представления, начиная с offset (страница); остальные строки не копируются
+	virtual bool getViewRows(const std::string& name, size_t offset, size_t count, std::vector<Dish>& rows) const = 0;
+
+	/// Возвращает имена всех представлений
+	virtual std::vector<std::string> getViewNames() const = 0;
+
+	/// Возвращает агрегаты меню, поддерживаемые при каждом изменении
+	virtual const MenuStats& getStats() const = 0;
+
+	/// Возвращает столбцы цен и времени, согласованные со строками getDishes()
+	virtual const MenuColumns& getColumns() const = 0;
+
+	/// Возвращает индексы для планировщика запросов по строкам getDishes()
+	/// (пустой список, пока строки не отсортированы по алфавиту)
+	virtual std::vector<const IDishIndex*> getIndexes() const = 0;
 };
 
 /// Интерфейс для сортировки блюд меню
@@ -81,6 +147,15 @@ public:
 	virtual std::vector<Dish> filterByPriceAndTime(const std::vector<Dish>& dishes, double maxPrice, const Time& maxTime) const = 0;
 };
 
+/// Интерфейс индекса, позволяющего планировщику запросов обойтись без полного просмотра
+class IDishIndex {
+public:
+	virtual ~IDishIndex() = default;
+
+	/// Заполняет номера строк-кандидатов для условия; возвращает false, если индекс к нему не применим
+	virtual bool lookup(const DishPredicate& predicate, const std::vector<Dish>& dishes, std::vector<size_t>& rows) const = 0;
+};
+
 /// Интерфейс для вывода информации о меню
 class IMenuPrinter {
 public:
@@ -91,6 +166,15 @@ public:
 
 	/// Выводит отфильтрованные блюда с пользовательским заголовком
 	virtual void printFilteredDishes(const std::vector<Dish>& dishes, const std::string& title) const = 0;
+
+	/// Выводит одну страницу блюд (page с 1); форматируются только строки этой страницы
+	virtual void printPage(const std::vector<Dish>& dishes, size_t page, size_t pageSize, const std::string& title) const = 0;
+
+	/// Выводит страницу page списка из total блюд, строки которой уже отобраны: rows - только эта страница
+	virtual void printPageRows(const std::vector<Dish>& rows, size_t page, size_t pageSize, size_t total, const std::string& title) const = 0;
+
+	/// Выводит агрегаты меню
+	virtual void printStats(const MenuStats& stats) const = 0;
 };
 
 /// Интерфейс для парсинга файлов с меню
@@ -100,6 +184,9 @@ public:
 
 	/// Парсит файл с меню и заполняет хранилище, подсчитывая невалидные строки
 	virtual void parseFile(const std::string& filename, IMenuStorage& storage, int& invalidCount) = 0;
+
+	/// Задает поток журнала загрузки; nullptr - разбирать молча
+	virtual void setLog(std::ostream* log) = 0;
 };
 
 #endif // INTERFACES_H
\ No newline at end of file
@@ -1,5 +1,7 @@
 ﻿#include "app.h"
 #include "builder.h"
+#include "async_output.h"
+#include <fstream>
 #include <iostream>
 #include <locale>
 #include <windows.h>
@@ -16,6 +18,7 @@ void setRussianLocale() {
 
 /// Очищает консоль с помощью системной команды
 void clearConsole() {
+	AsyncOutput::drainConsole();
 	system("cls");
 }
 
@@ -25,6 +28,7 @@ void showFileLevelHelp() {
 	std::cout << "  /help             - показать эту справку" << std::endl;
 	std::cout << "  /clear            - очистить консоль" << std::endl;
 	std::cout << "  <имя_файла>       - загрузить указанный файл с меню" << std::endl;
+	std::cout << "  /map файл условия - вывести блюда двоичного снимка без загрузки (только чтение)" << std::endl;
 	std::cout << "  /stop             - завершить работу программы" << std::endl;
 	std::cout << std::endl;
 }
@@ -43,8 +47,11 @@ void runFileLoop() {
 	// Основной бесконечный цикл обработки команд
 	while (true) {
 		std::cout << "Введите команду или имя файла: ";
-		// Считываем всю строку ввода
-		std::getline(std::cin, input);
+		// Считываем всю строку ввода; конец ввода завершает программу, как /stop
+		AsyncOutput::drainConsole();
+		if (!std::getline(std::cin, input)) {
+			break;
+		}
 
 		// Пропускаем пустой ввод
 		if (input.empty()) {
@@ -61,6 +68,10 @@ void runFileLoop() {
 				// Очищаем консоль
 				clearConsole();
 			}
+			else if (input.compare(0, 5, "/map ") == 0) {
+				// Снимок отображается в память и читается на месте, меню не загружается
+				app->printMapped(input.substr(5));
+			}
 			else if (input == "/stop") {
 				std::cout << "Завершение работы программы." << std::endl;
 				// Выходим из цикла и завершаем программу
@@ -97,10 +108,67 @@ void runFileLoop() {
 	}
 }
 
-/// Главная функция - точка входа в программу
-int main() {
+/// Выполняет сценарий команд из файла или, если путь "-", из стандартного ввода; возвращает код завершения
+int runScript(const std::string& path) {
+	// Журнал сборки приложения в пакетном режиме не выводится: на выходе только результаты команд
+	std::streambuf* console = std::cout.rdbuf(nullptr);
+	std::unique_ptr<RestaurantMenuApp> app;
+	try {
+		app = RestaurantMenuAppBuilder::createDefault();
+	}
+	catch (...) {
+		std::cout.rdbuf(console);
+		throw;
+	}
+	std::cout.rdbuf(console);
+	if (path == "-") {
+		return app->runBatch(std::cin);
+	}
+
+	std::ifstream script(path);
+	if (!script.is_open()) {
+		std::cout << "ОШИБКА: не удалось открыть сценарий: " << path << std::endl;
+		return 2;
+	}
+	return app->runBatch(script);
+}
+
+/// Главная функция - точка входа в программу.
+/// Без аргументов - интерактивный режим; --script файл или --batch (команды из стандартного ввода) -
+/// пакетный режим: выводятся только результаты команд, код завершения 0 - успех, 1 - были ошибки,
+/// 2 - неверные аргументы или сценарий не открылся
+int main(int argc, char* argv[]) {
+	std::string script;
+	if (argc > 1) {
+		std::string option = argv[1];
+		if (option == "--batch" && argc == 2) {
+			script = "-";
+		}
+		else if (option == "--script" && argc == 3) {
+			script = argv[2];
+		}
+		else {
+			std::cout << "Использование: RestaurantMenu [--script файл | --batch]" << std::endl;
+			return 2;
+		}
+		// Пакетный ввод читается большими блоками, без синхронизации с stdio на каждый символ
+		std::ios::sync_with_stdio(false);
+	}
+
 	// Устанавливаем русскую локаль для корректного отображения текста
 	setRussianLocale();
+	// Весь вывод в консоль идет через отдельный поток-писатель; остаток дописывается при выходе из main
+	AsyncOutput consoleOutput(std::cout);
+
+	if (!script.empty()) {
+		try {
+			return runScript(script);
+		}
+		catch (const std::exception& e) {
+			std::cout << "КРИТИЧЕСКАЯ ОШИБКА: " << e.what() << std::endl;
+			return 1;
+		}
+	}
 
 	try {
 		// Запускаем основной цикл работы программы
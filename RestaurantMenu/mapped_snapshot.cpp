@@ -0,0 +1,201 @@
+﻿#include "mapped_snapshot.h"
+#include "menu_snapshot.h"
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Сигнатура и метка порядка байт снимка (см. MenuSnapshot)
+static const char kMagic[8] = { 'R', 'M', 'E', 'N', 'U', 'S', 'N', 'P' };
+static const uint32_t kByteOrderMark = 0x01020304;
+
+// Читает значение фиксированной ширины из отображения
+template <typename T>
+static T readValue(const char* data) {
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+// Отображает файл целиком только для чтения; проверяется заголовок, а не данные
+MappedSnapshot::MappedSnapshot(const std::string& filename)
+	: data_(nullptr), size_(0), count_(0), prices_(nullptr), minutes_(nullptr), ends_(nullptr)
+	, names_(nullptr), namesSize_(0), file_(nullptr), mapping_(nullptr) {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("Не удалось открыть файл: " + filename);
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || static_cast<uint64_t>(fileSize.QuadPart) < MenuSnapshot::kHeaderSize) {
+		CloseHandle(file);
+		throw std::runtime_error("Файл не является снимком меню: " + filename);
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (view == nullptr) {
+		if (mapping) CloseHandle(mapping);
+		CloseHandle(file);
+		throw std::runtime_error("Не удалось отобразить файл в память: " + filename);
+	}
+	file_ = file;
+	mapping_ = mapping;
+	data_ = static_cast<const char*>(view);
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw std::runtime_error("Не удалось открыть файл: " + filename);
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < MenuSnapshot::kHeaderSize) {
+		close(fd);
+		throw std::runtime_error("Файл не является снимком меню: " + filename);
+	}
+	// Отображение остается действительным после закрытия дескриптора
+	void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (view == MAP_FAILED) {
+		throw std::runtime_error("Не удалось отобразить файл в память: " + filename);
+	}
+	data_ = static_cast<const char*>(view);
+	size_ = static_cast<size_t>(info.st_size);
+#endif
+
+	try {
+		if (std::memcmp(data_, kMagic, sizeof(kMagic)) != 0) {
+			throw std::runtime_error("Файл не является снимком меню: " + filename);
+		}
+		const uint32_t version = readValue<uint32_t>(data_ + 8);
+		if (version != MenuSnapshot::kVersion) {
+			throw std::runtime_error("Снимок версии " + std::to_string(version) +
+				" нельзя отобразить в память, пересохраните его: " + filename);
+		}
+		if (readValue<uint32_t>(data_ + 12) != kByteOrderMark) {
+			throw std::runtime_error("Снимок записан с другим порядком байт");
+		}
+		const uint64_t count = readValue<uint64_t>(data_ + 16);
+		namesSize_ = readValue<uint64_t>(data_ + 24);
+
+		const uint64_t recordSize = sizeof(double) + sizeof(int64_t) + sizeof(uint64_t);
+		const uint64_t payloadSize = size_ - MenuSnapshot::kHeaderSize;
+		// Размер таблицы названий сравнивается с остатком, а не суммой, чтобы огромный namesSize не переполнил проверку
+		if (count > payloadSize / recordSize || namesSize_ != payloadSize - count * recordSize) {
+			throw std::runtime_error("Снимок обрезан или поврежден: " + filename);
+		}
+		count_ = static_cast<size_t>(count);
+		prices_ = data_ + MenuSnapshot::kHeaderSize;
+		minutes_ = prices_ + count_ * sizeof(double);
+		ends_ = minutes_ + count_ * sizeof(int64_t);
+		names_ = ends_ + count_ * sizeof(uint64_t);
+	}
+	catch (...) {
+		unmap();
+		throw;
+	}
+}
+
+MappedSnapshot::~MappedSnapshot() {
+	unmap();
+}
+
+// Снимает отображение и закрывает описатели
+void MappedSnapshot::unmap() {
+#ifdef _WIN32
+	if (data_) UnmapViewOfFile(data_);
+	if (mapping_) CloseHandle(mapping_);
+	if (file_) CloseHandle(file_);
+#else
+	if (data_) munmap(const_cast<char*>(data_), size_);
+#endif
+	data_ = nullptr;
+	mapping_ = nullptr;
+	file_ = nullptr;
+}
+
+double MappedSnapshot::price(size_t row) const {
+	return readValue<double>(prices_ + row * sizeof(double));
+}
+
+long long MappedSnapshot::minutes(size_t row) const {
+	return readValue<int64_t>(minutes_ + row * sizeof(int64_t));
+}
+
+// Название лежит между концом предыдущего и своим концом; границы проверяются при каждом обращении,
+// потому что открытие их не просматривает
+std::string_view MappedSnapshot::name(size_t row) const {
+	const uint64_t begin = row == 0 ? 0 : readValue<uint64_t>(ends_ + (row - 1) * sizeof(uint64_t));
+	const uint64_t end = readValue<uint64_t>(ends_ + row * sizeof(uint64_t));
+	if (begin > end || end > namesSize_) {
+		throw std::runtime_error("Таблица названий снимка повреждена");
+	}
+	return std::string_view(names_ + begin, static_cast<size_t>(end - begin));
+}
+
+Dish MappedSnapshot::dish(size_t row) const {
+	std::string_view text = name(row);
+	return Dish(std::string(text.data(), text.size()), price(row), MenuSnapshot::timeFromMinutes(minutes(row)));
+}
+
+// Диапазоны цены и времени и точное название проверяются по колонкам; для остальных
+// условий по названию строка копируется в Dish с ключом сопоставления
+bool MappedSnapshot::matchesRow(const DishPredicate& predicate, size_t row) const {
+	switch (predicate.kind) {
+	case PredicateKind::PriceRange: {
+		const double value = price(row);
+		return value >= predicate.minPrice && value < predicate.maxPrice;
+	}
+	case PredicateKind::TimeRange: {
+		const long long value = minutes(row);
+		return value >= predicate.minMinutes && value < predicate.maxMinutes;
+	}
+	case PredicateKind::NameEquals:
+		return name(row) == predicate.text;
+	case PredicateKind::And:
+		for (const auto& child : predicate.children) {
+			if (!matchesRow(child, row)) return false;
+		}
+		return true;
+	case PredicateKind::Or:
+		for (const auto& child : predicate.children) {
+			if (matchesRow(child, row)) return true;
+		}
+		return false;
+	default:
+		return predicate.matches(dish(row));
+	}
+}
+
+// Просматривает колонки отображения без создания Dish для неподходящих строк
+std::vector<size_t> MappedSnapshot::select(const DishPredicate& predicate, size_t limit) const {
+	CompiledPredicate compiled(predicate);
+	std::vector<size_t> rows;
+	for (size_t row = 0; row < count_; ++row) {
+		if (matchesRow(compiled.normalized(), row)) {
+			rows.push_back(row);
+			if (rows.size() == limit) break;
+		}
+	}
+	return rows;
+}
+
+std::vector<Dish> MappedSnapshot::dishes(const std::vector<size_t>& rows) const {
+	std::vector<Dish> result;
+	result.reserve(rows.size());
+	for (size_t row : rows) {
+		result.push_back(dish(row));
+	}
+	return result;
+}
+
+// Контрольная сумма покрывает все данные после заголовка
+bool MappedSnapshot::verify() const {
+	return MenuSnapshot::checksum(prices_, size_ - MenuSnapshot::kHeaderSize) == readValue<uint64_t>(data_ + 32);
+}
\ No newline at end of file
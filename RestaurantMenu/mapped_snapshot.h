@@ -0,0 +1,72 @@
+﻿#pragma once
+#ifndef MAPPED_SNAPSHOT_H
+#define MAPPED_SNAPSHOT_H
+
+#include "models.h"
+#include "query.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Меню только для чтения поверх отображенного в память двоичного снимка (MenuSnapshot версии 2).
+/// Открытие проверяет заголовок и размеры колонок и ничего не разбирает, поэтому занимает O(1)
+/// при любом размере меню; цены, время и названия читаются прямо из отображенных колонок и
+/// таблицы названий, а страницы файла общие для всех процессов, открывших тот же снимок.
+/// Объекты Dish создаются только для строк, которые нужно вывести.
+class MappedSnapshot {
+private:
+	const char* data_;          ///< Начало отображения
+	size_t size_;               ///< Размер отображения в байтах
+	size_t count_;              ///< Количество блюд
+	const char* prices_;        ///< Колонка цен double[N]
+	const char* minutes_;       ///< Колонка времени в минутах int64[N]
+	const char* ends_;          ///< Концы названий в таблице u64[N]
+	const char* names_;         ///< Таблица названий
+	uint64_t namesSize_;        ///< Размер таблицы названий
+	void* file_;                ///< Описатель файла (только Windows)
+	void* mapping_;             ///< Описатель отображения (только Windows)
+
+	/// Снимает отображение и закрывает описатели
+	void unmap();
+
+	/// Проверяет условие для строки, читая только нужные колонки
+	bool matchesRow(const DishPredicate& predicate, size_t row) const;
+
+public:
+	/// Отображает снимок в память; бросает std::runtime_error, если файл нельзя отобразить,
+	/// он не снимок, другой версии или его размеры не сходятся с заголовком
+	explicit MappedSnapshot(const std::string& filename);
+
+	/// Снимает отображение
+	~MappedSnapshot();
+
+	MappedSnapshot(const MappedSnapshot&) = delete;
+	MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+	/// Количество блюд
+	size_t size() const { return count_; }
+
+	/// Цена блюда в строке row
+	double price(size_t row) const;
+
+	/// Время приготовления блюда в строке row в минутах
+	long long minutes(size_t row) const;
+
+	/// Название блюда в строке row без копирования; бросает std::runtime_error, если границы названия повреждены
+	std::string_view name(size_t row) const;
+
+	/// Копия блюда в строке row
+	Dish dish(size_t row) const;
+
+	/// Номера строк, удовлетворяющих условию (не больше limit, 0 - без ограничения)
+	std::vector<size_t> select(const DishPredicate& predicate, size_t limit = 0) const;
+
+	/// Копии блюд из строк rows
+	std::vector<Dish> dishes(const std::vector<size_t>& rows) const;
+
+	/// Сверяет контрольную сумму данных с заголовком (полный проход по файлу)
+	bool verify() const;
+};
+
+#endif // MAPPED_SNAPSHOT_H
\ No newline at end of file
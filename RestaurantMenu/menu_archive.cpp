@@ -0,0 +1,398 @@
+﻿#include "menu_archive.h"
+#include "menu_files.h"
+#include "menu_snapshot.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+// Сигнатура и метка порядка байт
+static const char kMagic[8] = { 'R', 'M', 'A', 'R', 'C', 'H', 'V', '1' };
+static const uint32_t kByteOrderMark = 0x01020304;
+
+// Размер записи каталога блоков
+static const size_t kEntrySize = 72;
+
+// Кодировка колонки цен блока
+static const uint32_t kPricesCents = 0;     // zig-zag varint разностей в копейках
+static const uint32_t kPricesRaw = 1;       // double подряд
+
+// Цены по модулю больше этой границы в копейки не переводятся
+static const double kMaxCentsPrice = 1e15;
+
+// Запись каталога: где лежит блок и какие значения в нем встречаются
+struct BlockEntry {
+	uint64_t offset;
+	uint64_t size;
+	uint32_t rows;
+	uint32_t priceEncoding;
+	double minPrice;
+	double maxPrice;
+	int64_t minMinutes;
+	int64_t maxMinutes;
+	uint32_t namesSize;
+	uint32_t pricesSize;
+	uint64_t checksum;
+};
+
+// Дописывает значение фиксированной ширины в буфер
+template <typename T>
+static void appendValue(std::string& out, const T& value) {
+	out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Читает значение фиксированной ширины из буфера
+template <typename T>
+static T readValue(const char* data) {
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+// Дописывает беззнаковое число varint: по 7 бит, старший бит - признак продолжения
+static void appendVarint(std::string& out, uint64_t value) {
+	while (value >= 0x80) {
+		out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<char>(value));
+}
+
+// Дописывает разность соседних значений zig-zag varint; вычисления по модулю 2^64 без переполнения
+static void appendDelta(std::string& out, int64_t previous, int64_t current) {
+	const uint64_t delta = static_cast<uint64_t>(current) - static_cast<uint64_t>(previous);
+	const uint64_t sign = static_cast<int64_t>(delta) < 0 ? ~0ULL : 0ULL;
+	appendVarint(out, (delta << 1) ^ sign);
+}
+
+// Последовательное чтение колонки с проверкой границ
+class ColumnReader {
+private:
+	const char* pos_;
+	const char* end_;
+
+public:
+	ColumnReader(const char* begin, const char* end) : pos_(begin), end_(end) {}
+
+	bool atEnd() const { return pos_ == end_; }
+
+	uint64_t varint() {
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if (pos_ == end_) throw std::runtime_error("Колонка архива обрезана");
+			const unsigned char byte = static_cast<unsigned char>(*pos_++);
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) return value;
+		}
+		throw std::runtime_error("Некорректное число в колонке архива");
+	}
+
+	int64_t delta(int64_t previous) {
+		const uint64_t zigzag = varint();
+		const uint64_t delta = (zigzag >> 1) ^ (0ULL - (zigzag & 1));
+		return static_cast<int64_t>(static_cast<uint64_t>(previous) + delta);
+	}
+
+	const char* bytes(size_t size) {
+		if (static_cast<size_t>(end_ - pos_) < size) throw std::runtime_error("Колонка архива обрезана");
+		const char* data = pos_;
+		pos_ += size;
+		return data;
+	}
+};
+
+// Цена точно представима целым числом копеек
+static bool isWholeCents(double price) {
+	if (!std::isfinite(price) || std::fabs(price) >= kMaxCentsPrice) return false;
+	const double cents = static_cast<double>(std::llround(price * 100.0));
+	return cents / 100.0 == price && std::signbit(cents) == std::signbit(price);
+}
+
+// Кодирует строки [first, last) упорядоченного списка в блок и заполняет запись каталога
+static void encodeBlock(const std::vector<Dish>& dishes, const std::vector<size_t>& order,
+	size_t first, size_t last, std::string& data, BlockEntry& entry) {
+	entry.rows = static_cast<uint32_t>(last - first);
+	entry.minPrice = std::numeric_limits<double>::infinity();
+	entry.maxPrice = -std::numeric_limits<double>::infinity();
+	entry.minMinutes = std::numeric_limits<int64_t>::max();
+	entry.maxMinutes = std::numeric_limits<int64_t>::min();
+	entry.priceEncoding = kPricesCents;
+	for (size_t i = first; i < last; ++i) {
+		const Dish& dish = dishes[order[i]];
+		if (dish.price < entry.minPrice) entry.minPrice = dish.price;
+		if (dish.price > entry.maxPrice) entry.maxPrice = dish.price;
+		entry.minMinutes = std::min<int64_t>(entry.minMinutes, dish.totalMinutes());
+		entry.maxMinutes = std::max<int64_t>(entry.maxMinutes, dish.totalMinutes());
+		if (!isWholeCents(dish.price)) entry.priceEncoding = kPricesRaw;
+	}
+
+	// Первое название блока записывается целиком, поэтому блок не зависит от соседей
+	std::string block;
+	const std::string* previous = nullptr;
+	for (size_t i = first; i < last; ++i) {
+		const std::string& name = dishes[order[i]].name;
+		size_t shared = 0;
+		if (previous) {
+			const size_t limit = std::min(previous->size(), name.size());
+			while (shared < limit && (*previous)[shared] == name[shared]) shared++;
+		}
+		appendVarint(block, shared);
+		appendVarint(block, name.size() - shared);
+		block.append(name, shared, std::string::npos);
+		previous = &name;
+	}
+	const size_t namesSize = block.size();
+
+	int64_t previousValue = 0;
+	for (size_t i = first; i < last; ++i) {
+		const double price = dishes[order[i]].price;
+		if (entry.priceEncoding == kPricesRaw) {
+			appendValue(block, price);
+			continue;
+		}
+		const int64_t cents = std::llround(price * 100.0);
+		appendDelta(block, previousValue, cents);
+		previousValue = cents;
+	}
+	const size_t pricesSize = block.size() - namesSize;
+
+	previousValue = 0;
+	for (size_t i = first; i < last; ++i) {
+		const int64_t minutes = dishes[order[i]].totalMinutes();
+		appendDelta(block, previousValue, minutes);
+		previousValue = minutes;
+	}
+
+	if (block.size() > UINT32_MAX) {
+		throw std::runtime_error("Слишком большой блок архива");
+	}
+	entry.offset = data.size();
+	entry.size = block.size();
+	entry.namesSize = static_cast<uint32_t>(namesSize);
+	entry.pricesSize = static_cast<uint32_t>(pricesSize);
+	entry.checksum = MenuSnapshot::checksum(block.data(), block.size());
+	data.append(block);
+}
+
+// Декодирует блок, проверяя, что каждая колонка заканчивается ровно на своей границе
+static void decodeBlock(const BlockEntry& entry, const char* block, std::vector<Dish>& rows) {
+	const char* pricesBegin = block + entry.namesSize;
+	const char* minutesBegin = pricesBegin + entry.pricesSize;
+	ColumnReader names(block, pricesBegin);
+	ColumnReader prices(pricesBegin, minutesBegin);
+	ColumnReader minutes(minutesBegin, block + entry.size);
+
+	std::string name;
+	int64_t cents = 0;
+	int64_t totalMinutes = 0;
+	rows.clear();
+	for (uint32_t i = 0; i < entry.rows; ++i) {
+		const uint64_t shared = names.varint();
+		const uint64_t suffix = names.varint();
+		if (shared > name.size() || suffix > entry.size) {
+			throw std::runtime_error("Некорректное название в блоке архива");
+		}
+		name.resize(static_cast<size_t>(shared));
+		name.append(names.bytes(static_cast<size_t>(suffix)), static_cast<size_t>(suffix));
+
+		double price;
+		if (entry.priceEncoding == kPricesRaw) {
+			price = readValue<double>(prices.bytes(sizeof(double)));
+		}
+		else {
+			cents = prices.delta(cents);
+			price = static_cast<double>(cents) / 100.0;
+		}
+
+		totalMinutes = minutes.delta(totalMinutes);
+		if (totalMinutes < 0) {
+			throw std::runtime_error("Некорректное время в блоке архива");
+		}
+		rows.emplace_back(name, price, MenuSnapshot::timeFromMinutes(totalMinutes));
+	}
+	if (!names.atEnd() || !prices.atEnd() || !minutes.atEnd()) {
+		throw std::runtime_error("Размеры колонок блока архива не совпадают с каталогом");
+	}
+}
+
+// Сортирует номера строк по байтам названия, разбивает на блоки и атомарно записывает файл
+void MenuArchive::save(const std::vector<Dish>& dishes, const std::string& filename, size_t blockRows) {
+	if (blockRows == 0 || blockRows > UINT32_MAX) {
+		throw std::invalid_argument("Некорректное количество строк в блоке архива");
+	}
+
+	// Соседние названия с общим началом дают короткие префиксные записи
+	std::vector<size_t> order(dishes.size());
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		const Dish& lhs = dishes[a];
+		const Dish& rhs = dishes[b];
+		if (lhs.name != rhs.name) return lhs.name < rhs.name;
+		if (lhs.price != rhs.price) return lhs.price < rhs.price;
+		return lhs.totalMinutes() < rhs.totalMinutes();
+	});
+
+	const size_t blockCount = (dishes.size() + blockRows - 1) / blockRows;
+	if (blockCount > UINT32_MAX) {
+		throw std::runtime_error("Слишком много блоков в архиве");
+	}
+	std::vector<BlockEntry> entries(blockCount);
+	std::string data;
+	for (size_t block = 0; block < blockCount; ++block) {
+		const size_t first = block * blockRows;
+		encodeBlock(dishes, order, first, std::min(first + blockRows, dishes.size()), data, entries[block]);
+	}
+
+	// Смещения в каталоге отсчитываются от начала файла
+	const uint64_t dataOffset = kHeaderSize + blockCount * kEntrySize;
+	std::string directory;
+	directory.reserve(blockCount * kEntrySize);
+	for (const auto& entry : entries) {
+		appendValue(directory, entry.offset + dataOffset);
+		appendValue(directory, entry.size);
+		appendValue(directory, entry.rows);
+		appendValue(directory, entry.priceEncoding);
+		appendValue(directory, entry.minPrice);
+		appendValue(directory, entry.maxPrice);
+		appendValue(directory, entry.minMinutes);
+		appendValue(directory, entry.maxMinutes);
+		appendValue(directory, entry.namesSize);
+		appendValue(directory, entry.pricesSize);
+		appendValue(directory, entry.checksum);
+	}
+
+	std::string header(kMagic, sizeof(kMagic));
+	appendValue(header, kVersion);
+	appendValue(header, kByteOrderMark);
+	appendValue(header, static_cast<uint64_t>(dishes.size()));
+	appendValue(header, static_cast<uint32_t>(blockCount));
+	appendValue(header, static_cast<uint32_t>(blockRows));
+	appendValue(header, MenuSnapshot::checksum(directory.data(), directory.size()));
+
+	AtomicFile file(filename, true);
+	file.write(header.data(), header.size());
+	file.write(directory.data(), directory.size());
+	file.write(data.data(), data.size());
+	file.commit();
+}
+
+// Читает заголовок и каталог, затем только те блоки, границы которых допускают условие
+MenuArchive::LoadStats MenuArchive::load(const std::string& filename, IMenuStorage& storage, const DishPredicate& filter) {
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) {
+		throw std::runtime_error("Не удалось открыть файл: " + filename);
+	}
+	const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+	file.seekg(0);
+
+	char header[kHeaderSize] = {};
+	if (!file.read(header, sizeof(header)) || std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+		throw std::runtime_error("Файл не является архивом меню: " + filename);
+	}
+	const uint32_t version = readValue<uint32_t>(header + 8);
+	if (version != kVersion) {
+		throw std::runtime_error("Неподдерживаемая версия архива: " + std::to_string(version));
+	}
+	if (readValue<uint32_t>(header + 12) != kByteOrderMark) {
+		throw std::runtime_error("Архив записан с другим порядком байт");
+	}
+	const uint64_t count = readValue<uint64_t>(header + 16);
+	const uint32_t blockCount = readValue<uint32_t>(header + 24);
+	const uint64_t directoryChecksum = readValue<uint64_t>(header + 32);
+
+	if (blockCount > (fileSize - kHeaderSize) / kEntrySize) {
+		throw std::runtime_error("Архив обрезан или поврежден: " + filename);
+	}
+	std::string directory(blockCount * kEntrySize, '\0');
+	if (!file.read(&directory[0], static_cast<std::streamsize>(directory.size())) ||
+		MenuSnapshot::checksum(directory.data(), directory.size()) != directoryChecksum) {
+		throw std::runtime_error("Каталог архива поврежден: " + filename);
+	}
+
+	std::vector<BlockEntry> entries(blockCount);
+	uint64_t rows = 0;
+	for (uint32_t i = 0; i < blockCount; ++i) {
+		const char* p = directory.data() + i * kEntrySize;
+		BlockEntry& entry = entries[i];
+		entry.offset = readValue<uint64_t>(p);
+		entry.size = readValue<uint64_t>(p + 8);
+		entry.rows = readValue<uint32_t>(p + 16);
+		entry.priceEncoding = readValue<uint32_t>(p + 20);
+		entry.minPrice = readValue<double>(p + 24);
+		entry.maxPrice = readValue<double>(p + 32);
+		entry.minMinutes = readValue<int64_t>(p + 40);
+		entry.maxMinutes = readValue<int64_t>(p + 48);
+		entry.namesSize = readValue<uint32_t>(p + 56);
+		entry.pricesSize = readValue<uint32_t>(p + 60);
+		entry.checksum = readValue<uint64_t>(p + 64);
+		if (entry.offset > fileSize || entry.size > fileSize - entry.offset ||
+			static_cast<uint64_t>(entry.namesSize) + entry.pricesSize > entry.size ||
+			(entry.priceEncoding != kPricesCents && entry.priceEncoding != kPricesRaw)) {
+			throw std::runtime_error("Архив обрезан или поврежден: " + filename);
+		}
+		rows += entry.rows;
+	}
+	if (rows != count) {
+		throw std::runtime_error("Количество блюд в каталоге архива не совпадает с заголовком: " + filename);
+	}
+
+	// Подходящие блюда накапливаются отдельно, чтобы поврежденный блок не оставил хранилище заполненным наполовину
+	LoadStats stats;
+	stats.blocks = blockCount;
+	CompiledPredicate compiled(filter);
+	std::vector<Dish> matched;
+	std::vector<Dish> decoded;
+	std::string block;
+	for (const auto& entry : entries) {
+		if (!mayMatch(compiled.normalized(), entry.minPrice, entry.maxPrice, entry.minMinutes, entry.maxMinutes)) {
+			continue;
+		}
+		block.resize(static_cast<size_t>(entry.size));
+		file.seekg(static_cast<std::streamoff>(entry.offset));
+		if (!file.read(&block[0], static_cast<std::streamsize>(block.size())) ||
+			MenuSnapshot::checksum(block.data(), block.size()) != entry.checksum) {
+			throw std::runtime_error("Блок архива поврежден: " + filename);
+		}
+		decodeBlock(entry, block.data(), decoded);
+		stats.blocksRead++;
+		stats.rowsScanned += decoded.size();
+		for (auto& dish : decoded) {
+			if (compiled.matches(dish)) matched.push_back(std::move(dish));
+		}
+	}
+
+	stats.rowsLoaded = matched.size();
+	storage.addDishes(std::move(matched));
+	return stats;
+}
+
+// Сравнивает первые байты файла с сигнатурой
+bool MenuArchive::isArchive(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary);
+	char magic[sizeof(kMagic)] = {};
+	return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+// Условия по названию границами блока не проверяются и считаются возможными
+bool MenuArchive::mayMatch(const DishPredicate& predicate, double minPrice, double maxPrice,
+	long long minMinutes, long long maxMinutes) {
+	switch (predicate.kind) {
+	case PredicateKind::PriceRange:
+		return maxPrice >= predicate.minPrice && minPrice < predicate.maxPrice;
+	case PredicateKind::TimeRange:
+		return maxMinutes >= predicate.minMinutes && minMinutes < predicate.maxMinutes;
+	case PredicateKind::And:
+		return std::all_of(predicate.children.begin(), predicate.children.end(), [&](const DishPredicate& child) {
+			return mayMatch(child, minPrice, maxPrice, minMinutes, maxMinutes);
+		});
+	case PredicateKind::Or:
+		return std::any_of(predicate.children.begin(), predicate.children.end(), [&](const DishPredicate& child) {
+			return mayMatch(child, minPrice, maxPrice, minMinutes, maxMinutes);
+		});
+	default:
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+﻿#pragma once
+#ifndef MENU_ARCHIVE_H
+#define MENU_ARCHIVE_H
+
+#include "interfaces.h"
+#include "models.h"
+#include "query.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Колоночный архив меню для долгого хранения выгрузок. Блюда упорядочены по байтам названия
+/// и разбиты на блоки по kBlockRows строк; каждый блок декодируется независимо и хранит три колонки:
+///   названия - префиксное сжатие: длина общего с предыдущим названием префикса и остаток;
+///   цены - разности соседних цен в копейках (или исходные double, если цены не целые в копейках);
+///   время - разности соседних значений в минутах.
+/// Числа записываются zig-zag varint. Формат (версия 1, порядок байт машины, проверяется меткой):
+///   заголовок 40 байт: "RMARCHV1", версия (u32), метка порядка байт (u32), количество блюд (u64),
+///   количество блоков (u32), строк в блоке (u32), контрольная сумма каталога (u64);
+///   каталог блоков: смещение и размер блока, строки, кодировка цен, минимум и максимум цены и
+///   времени, размеры колонок и контрольная сумма данных блока;
+///   данные блоков подряд.
+/// По минимумам и максимумам каталога загрузка с условием пропускает блоки, в которых заведомо
+/// нет подходящих блюд, не читая их с диска.
+class MenuArchive {
+public:
+	static constexpr uint32_t kVersion = 1;             ///< Текущая версия формата
+	static constexpr size_t kHeaderSize = 40;           ///< Размер заголовка в байтах
+	static constexpr size_t kBlockRows = 4096;          ///< Строк в блоке по умолчанию
+
+	/// Итоги загрузки с условием
+	struct LoadStats {
+		size_t blocks = 0;          ///< Блоков в архиве
+		size_t blocksRead = 0;      ///< Блоков прочитано и декодировано
+		size_t rowsScanned = 0;     ///< Строк в прочитанных блоках
+		size_t rowsLoaded = 0;      ///< Строк, удовлетворивших условию и добавленных в хранилище
+	};
+
+	/// Сохраняет блюда в архив; blockRows - строк в блоке. Бросает std::runtime_error при ошибке записи
+	static void save(const std::vector<Dish>& dishes, const std::string& filename, size_t blockRows = kBlockRows);
+
+	/// Загружает из архива блюда, удовлетворяющие условию; блоки, чьи минимумы и максимумы
+	/// исключают условие, пропускаются. Бросает std::runtime_error, если файл поврежден или
+	/// другой версии; в этом случае хранилище не изменяется
+	static LoadStats load(const std::string& filename, IMenuStorage& storage,
+		const DishPredicate& filter = DishPredicate::any());
+
+	/// Проверяет, начинается ли файл с сигнатуры архива
+	static bool isArchive(const std::string& filename);
+
+	/// Может ли в блоке с такими границами цены и времени найтись блюдо, удовлетворяющее условию
+	static bool mayMatch(const DishPredicate& predicate, double minPrice, double maxPrice,
+		long long minMinutes, long long maxMinutes);
+};
+
+#endif // MENU_ARCHIVE_H
\ No newline at end of file
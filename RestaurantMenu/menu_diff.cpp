@@ -0,0 +1,152 @@
+﻿#include "menu_diff.h"
+#include "collation.h"
+#include "file_parser.h"
+#include "menu_archive.h"
+#include "menu_snapshot.h"
+#include "storage.h"
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+
+// Ключ полного совпадения блюда
+struct DishKey {
+	std::string_view name;
+	double price;
+	long long minutes;
+
+	bool operator==(const DishKey& other) const {
+		return name == other.name && price == other.price && minutes == other.minutes;
+	}
+};
+
+// Хеш ключа: хеш названия, перемешанный с битами цены и минутами
+struct DishKeyHash {
+	size_t operator()(const DishKey& key) const {
+		uint64_t priceBits;
+		std::memcpy(&priceBits, &key.price, sizeof(priceBits));
+		uint64_t hash = std::hash<std::string_view>()(key.name);
+		hash ^= priceBits + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+		hash ^= static_cast<uint64_t>(key.minutes) + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+		return static_cast<size_t>(hash);
+	}
+};
+
+static DishKey keyOf(const Dish& dish) {
+	return DishKey{ dish.name, dish.price, dish.totalMinutes() };
+}
+
+// Два прохода по хеш-таблицам: сначала полные совпадения, затем совпадения по названию среди оставшихся
+MenuDiff::Result MenuDiff::compare(const std::vector<Dish>& before, const std::vector<Dish>& after) {
+	Result result;
+	std::unordered_map<DishKey, std::vector<size_t>, DishKeyHash> exact;
+	exact.reserve(before.size());
+	// Номера в обратном порядке, чтобы одинаковые блюда сопоставлялись по порядку снятием с конца
+	for (size_t i = before.size(); i-- > 0; ) {
+		exact[keyOf(before[i])].push_back(i);
+	}
+
+	std::vector<bool> matchedBefore(before.size(), false);
+	std::vector<size_t> unmatchedAfter;
+	for (size_t j = 0; j < after.size(); ++j) {
+		auto it = exact.find(keyOf(after[j]));
+		if (it != exact.end() && !it->second.empty()) {
+			matchedBefore[it->second.back()] = true;
+			it->second.pop_back();
+			result.unchanged++;
+		}
+		else {
+			unmatchedAfter.push_back(j);
+		}
+	}
+
+	std::unordered_map<std::string_view, std::vector<size_t>> byName;
+	for (size_t i = before.size(); i-- > 0; ) {
+		if (!matchedBefore[i]) byName[before[i].name].push_back(i);
+	}
+	for (size_t j : unmatchedAfter) {
+		auto it = byName.find(after[j].name);
+		if (it != byName.end() && !it->second.empty()) {
+			matchedBefore[it->second.back()] = true;
+			result.changed.emplace_back(it->second.back(), j);
+			it->second.pop_back();
+		}
+		else {
+			result.added.push_back(j);
+		}
+	}
+
+	for (size_t i = 0; i < before.size(); ++i) {
+		if (!matchedBefore[i]) result.removed.push_back(i);
+	}
+	return result;
+}
+
+// Отмечает, какие строки каждого меню попадут в результат, и сливает входы по ключу сопоставления
+std::vector<Dish> MenuDiff::merge(const std::vector<Dish>& first, const std::vector<Dish>& second,
+	const Result& diff, Policy policy) {
+	// Из первого меню берется все, кроме проигравших конфликт; из второго - только новое
+	std::vector<bool> keepFirst(first.size(), true);
+	std::vector<bool> keepSecond(second.size(), false);
+	for (size_t j : diff.added) keepSecond[j] = true;
+	for (const auto& pair : diff.changed) {
+		bool takeFirst = true;
+		bool takeSecond = true;
+		switch (policy) {
+		case Policy::First: takeSecond = false; break;
+		case Policy::Second: takeFirst = false; break;
+		case Policy::Both: break;
+		case Policy::Cheaper:
+			takeFirst = first[pair.first].price < second[pair.second].price;
+			takeSecond = !takeFirst;
+			break;
+		}
+		keepFirst[pair.first] = takeFirst;
+		keepSecond[pair.second] = takeSecond;
+	}
+
+	std::vector<Dish> merged;
+	merged.reserve(first.size() + diff.added.size() + (policy == Policy::Both ? diff.changed.size() : 0));
+	size_t i = 0;
+	size_t j = 0;
+	while (i < first.size() || j < second.size()) {
+		if (i < first.size() && !keepFirst[i]) { ++i; continue; }
+		if (j < second.size() && !keepSecond[j]) { ++j; continue; }
+		if (j == second.size() || (i < first.size() && Collation::compare(first[i].sortKey, second[j].sortKey) <= 0)) {
+			merged.push_back(first[i++]);
+		}
+		else {
+			merged.push_back(second[j++]);
+		}
+	}
+	return merged;
+}
+
+// Формат определяется так же, как при загрузке меню в приложении
+std::vector<Dish> MenuDiff::loadSorted(const std::string& filename, int& invalidCount) {
+	MenuStorage storage;
+	invalidCount = 0;
+	if (MenuSnapshot::isSnapshot(filename)) {
+		MenuSnapshot::load(filename, storage);
+	}
+	else if (MenuArchive::isArchive(filename)) {
+		MenuArchive::load(filename, storage);
+	}
+	else {
+		MenuFileParser parser;
+		parser.setLog(nullptr);
+		parser.parseFile(filename, storage, invalidCount);
+	}
+	std::vector<Dish> dishes = storage.getDishes();
+	MenuSorter().sortAlphabetically(dishes);
+	return dishes;
+}
+
+bool MenuDiff::parsePolicy(const std::string& name, Policy& policy) {
+	if (name == "first") policy = Policy::First;
+	else if (name == "second") policy = Policy::Second;
+	else if (name == "both") policy = Policy::Both;
+	else if (name == "cheaper") policy = Policy::Cheaper;
+	else return false;
+	return true;
+}
\ No newline at end of file
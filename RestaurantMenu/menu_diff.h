@@ -0,0 +1,48 @@
+﻿#pragma once
+#ifndef MENU_DIFF_H
+#define MENU_DIFF_H
+
+#include "models.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Сравнение и слияние двух версий меню за линейное время. Блюда сопоставляются по хешу
+/// (название, цена, время): совпавшие считаются неизменными, из оставшихся блюда с одинаковым
+/// названием образуют пары "изменена цена или время", прочие - добавленные и удаленные.
+class MenuDiff {
+public:
+	/// Как разрешать конфликт слияния - блюдо с одним названием и разной ценой или временем
+	enum class Policy {
+		First,      ///< Оставить вариант из первого меню
+		Second,     ///< Оставить вариант из второго меню
+		Both,       ///< Оставить оба варианта
+		Cheaper     ///< Оставить более дешевый вариант (при равной цене - из второго меню)
+	};
+
+	/// Результат сравнения: номера строк в первом (before) и втором (after) меню
+	struct Result {
+		std::vector<size_t> removed;                        ///< Есть только в первом меню
+		std::vector<size_t> added;                          ///< Есть только во втором меню
+		std::vector<std::pair<size_t, size_t>> changed;     ///< Одно название, разные цена или время
+		size_t unchanged = 0;                               ///< Совпали полностью
+	};
+
+	/// Сравнивает два меню
+	static Result compare(const std::vector<Dish>& before, const std::vector<Dish>& after);
+
+	/// Сливает два отсортированных по алфавиту меню: неизменные блюда берутся один раз, добавленные и
+	/// удаленные - все, конфликты разрешаются политикой. Результат получается слиянием входов
+	/// за один проход и уже отсортирован
+	static std::vector<Dish> merge(const std::vector<Dish>& first, const std::vector<Dish>& second,
+		const Result& diff, Policy policy);
+
+	/// Загружает файл меню (текст, двоичный снимок или архив) без вывода журнала и сортирует по алфавиту;
+	/// invalidCount - количество невалидных строк текста. Можно вызывать из разных потоков
+	static std::vector<Dish> loadSorted(const std::string& filename, int& invalidCount);
+
+	/// Разбирает название политики: first, second, both, cheaper
+	static bool parsePolicy(const std::string& name, Policy& policy);
+};
+
+#endif // MENU_DIFF_H
\ No newline at end of file
@@ -0,0 +1,199 @@
+﻿#include "menu_files.h"
+#include "formatting.h"
+#include "menu_snapshot.h"
+#include <atomic>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#include <process.h>
+#include <share.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// ==================== ATOMIC FILE ====================
+
+// Уникальное имя временного файла: идентификатор процесса и номер записи в процессе
+static std::string makeTempPath(const std::string& path) {
+	static std::atomic<unsigned long> counter(0);
+#ifdef _WIN32
+	const long long pid = _getpid();
+#else
+	const long long pid = getpid();
+#endif
+	return path + "." + std::to_string(pid) + "." + std::to_string(++counter) + ".tmp";
+}
+
+// Временный файл создается в том же каталоге, чтобы переименование не пересекало файловые системы
+AtomicFile::AtomicFile(const std::string& path, bool binary)
+	: path_(path), tempPath_(makeTempPath(path)), file_(openFile(tempPath_, binary ? "wb" : "w")) {
+	if (file_ == nullptr) {
+		throw std::runtime_error("Не удалось открыть файл для сохранения: " + tempPath_);
+	}
+}
+
+AtomicFile::~AtomicFile() {
+	if (file_ != nullptr) {
+		std::fclose(file_);
+		std::remove(tempPath_.c_str());
+	}
+}
+
+void AtomicFile::write(const char* data, size_t size) {
+	if (size > 0 && std::fwrite(data, 1, size, file_) != size) {
+		throw std::runtime_error("Ошибка записи файла: " + tempPath_);
+	}
+}
+
+// Данные на диске до переименования: иначе после сбоя под целевым именем может оказаться пустой файл
+void AtomicFile::commit() {
+	bool synced = syncFile(file_);
+	bool closed = std::fclose(file_) == 0;
+	file_ = nullptr;
+	if (!synced || !closed) {
+		std::remove(tempPath_.c_str());
+		throw std::runtime_error("Не удалось сбросить файл на диск: " + tempPath_);
+	}
+
+#ifdef _WIN32
+	bool renamed = MoveFileExA(tempPath_.c_str(), path_.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	bool renamed = std::rename(tempPath_.c_str(), path_.c_str()) == 0;
+#endif
+	if (!renamed) {
+		std::remove(tempPath_.c_str());
+		throw std::runtime_error("Не удалось заменить файл: " + path_);
+	}
+	syncDirectory(path_);
+}
+
+std::FILE* AtomicFile::openFile(const std::string& path, const char* mode) {
+#ifdef _WIN32
+	// В отличие от fopen_s, _fsopen не запрещает другим процессам читать файл
+	return _fsopen(path.c_str(), mode, _SH_DENYNO);
+#else
+	return std::fopen(path.c_str(), mode);
+#endif
+}
+
+bool AtomicFile::syncFile(std::FILE* file) {
+	if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+	return _commit(_fileno(file)) == 0;
+#else
+	return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Переименование становится устойчивым к сбою питания только после сброса каталога
+void AtomicFile::syncDirectory(const std::string& path) {
+#ifndef _WIN32
+	size_t slash = path.find_last_of('/');
+	std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+	int fd = open(directory.c_str(), O_RDONLY);
+	if (fd >= 0) {
+		fsync(fd);
+		close(fd);
+	}
+#else
+	(void)path;
+#endif
+}
+
+// ==================== MENU TEXT FILE ====================
+
+// Строки копятся в буфере и записываются блоками по мегабайту
+void MenuTextFile::save(const std::vector<Dish>& dishes, const std::string& filename) {
+	AtomicFile file(filename, false);
+	const size_t chunkSize = 1 << 20;
+	std::string buffer;
+	buffer.reserve(chunkSize + 256);
+	for (const auto& dish : dishes) {
+		DishFormat::appendFileLine(buffer, dish);
+		buffer.push_back('\n');
+		if (buffer.size() >= chunkSize) {
+			file.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+	}
+	file.write(buffer.data(), buffer.size());
+	file.commit();
+}
+
+// ==================== BACKGROUND SAVER ====================
+
+BackgroundSaver::BackgroundSaver()
+	: running_(0), stop_(false), worker_(&BackgroundSaver::workerLoop, this) {}
+
+BackgroundSaver::~BackgroundSaver() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	ready_.notify_one();
+	worker_.join();
+}
+
+void BackgroundSaver::start(std::vector<Dish> dishes, const std::string& filename, bool binary) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		jobs_.push_back(Job{ std::move(dishes), filename, binary });
+		running_++;
+		targets_[filename]++;
+	}
+	ready_.notify_one();
+}
+
+// Запись идет без блокировки: поток команд в это время может ставить новые задания
+void BackgroundSaver::workerLoop() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		ready_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+		if (jobs_.empty()) return;
+
+		Job job = std::move(jobs_.front());
+		jobs_.pop_front();
+		lock.unlock();
+
+		Result result{ job.filename, job.binary, job.dishes.size(), "" };
+		try {
+			if (job.binary) MenuSnapshot::save(job.dishes, job.filename);
+			else MenuTextFile::save(job.dishes, job.filename);
+		}
+		catch (const std::exception& e) {
+			result.error = e.what();
+		}
+
+		lock.lock();
+		auto target = targets_.find(result.filename);
+		if (--target->second == 0) targets_.erase(target);
+		results_.push_back(std::move(result));
+		running_--;
+		done_.notify_all();
+	}
+}
+
+std::vector<BackgroundSaver::Result> BackgroundSaver::takeResults() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::vector<Result> results;
+	results.swap(results_);
+	return results;
+}
+
+size_t BackgroundSaver::pending() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return running_;
+}
+
+bool BackgroundSaver::isSaving(const std::string& filename) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return targets_.count(filename) > 0;
+}
+
+void BackgroundSaver::wait() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	done_.wait(lock, [this] { return running_ == 0; });
+}
\ No newline at end of file
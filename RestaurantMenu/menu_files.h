@@ -0,0 +1,123 @@
+﻿#pragma once
+#ifndef MENU_FILES_H
+#define MENU_FILES_H
+
+#include "models.h"
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Атомарная запись файла: данные пишутся во временный файл рядом с целевым,
+/// сбрасываются на диск, после чего временный файл переименовывается поверх целевого
+/// (на POSIX дополнительно сбрасывается каталог). При сбое посередине записи остается
+/// либо старый файл целиком, либо новый. Незавершенный временный файл удаляется в деструкторе.
+/// Имя временного файла уникально (идентификатор процесса и номер записи), поэтому
+/// одновременные записи в один целевой файл не пишут в общий временный файл.
+class AtomicFile {
+private:
+	std::string path_;          ///< Целевой файл
+	std::string tempPath_;      ///< Временный файл
+	std::FILE* file_;           ///< Открытый временный файл
+
+public:
+	/// Открывает временный файл; binary = false - текстовый режим (перевод строк платформы).
+	/// Бросает std::runtime_error, если файл нельзя создать
+	AtomicFile(const std::string& path, bool binary);
+
+	/// Удаляет временный файл, если commit() не был вызван
+	~AtomicFile();
+
+	AtomicFile(const AtomicFile&) = delete;
+	AtomicFile& operator=(const AtomicFile&) = delete;
+
+	/// Дописывает данные; бросает std::runtime_error при ошибке записи
+	void write(const char* data, size_t size);
+
+	/// Сбрасывает данные на диск и заменяет целевой файл
+	void commit();
+
+	/// Временный файл, в который идет запись
+	const std::string& tempPath() const { return tempPath_; }
+
+	/// Открывает файл как std::fopen; на Windows - через _fsopen, так как fopen запрещен проверками /sdl (C4996).
+	/// Возвращает nullptr, если файл не открылся
+	static std::FILE* openFile(const std::string& path, const char* mode);
+
+	/// Сбрасывает буферы потока и данные файла на диск
+	static bool syncFile(std::FILE* file);
+
+	/// Сбрасывает на диск запись каталога, в котором лежит path (на Windows не требуется)
+	static void syncDirectory(const std::string& path);
+};
+
+/// Текстовый файл меню в формате, который читает MenuFileParser
+class MenuTextFile {
+public:
+	/// Атомарно сохраняет блюда строками "Название" цена ч:мм, записывая блоками по мегабайту
+	static void save(const std::vector<Dish>& dishes, const std::string& filename);
+};
+
+/// Фоновое сохранение: копия меню записывается отдельным потоком, пока команды продолжают выполняться.
+/// Задания выполняются по очереди, поэтому два фоновых сохранения в один файл не пересекаются;
+/// синхронная запись в тот же файл должна сначала дождаться их (см. isSaving)
+class BackgroundSaver {
+public:
+	/// Результат завершенного сохранения
+	struct Result {
+		std::string filename;   ///< Файл
+		bool binary;            ///< Двоичный снимок или текст
+		size_t count;           ///< Количество сохраненных блюд
+		std::string error;      ///< Текст ошибки (пустой при успехе)
+	};
+
+private:
+	struct Job {
+		std::vector<Dish> dishes;
+		std::string filename;
+		bool binary;
+	};
+
+	std::deque<Job> jobs_;              ///< Очередь заданий
+	std::vector<Result> results_;       ///< Завершенные, но еще не забранные результаты
+	size_t running_;                    ///< Заданий в работе (в очереди и выполняемых)
+	std::map<std::string, size_t> targets_; ///< Незавершенные задания по файлам
+	bool stop_;
+	std::mutex mutex_;
+	std::condition_variable ready_;     ///< Появилось задание или запрошена остановка
+	std::condition_variable done_;      ///< Завершилось задание
+	std::thread worker_;                ///< Поток сохранения (объявлен последним)
+
+	/// Цикл потока сохранения
+	void workerLoop();
+
+public:
+	BackgroundSaver();
+
+	/// Дожидается всех заданий и останавливает поток
+	~BackgroundSaver();
+
+	BackgroundSaver(const BackgroundSaver&) = delete;
+	BackgroundSaver& operator=(const BackgroundSaver&) = delete;
+
+	/// Ставит сохранение копии блюд в очередь и сразу возвращает управление
+	void start(std::vector<Dish> dishes, const std::string& filename, bool binary);
+
+	/// Забирает результаты завершенных сохранений
+	std::vector<Result> takeResults();
+
+	/// Количество незавершенных сохранений
+	size_t pending();
+
+	/// Есть ли незавершенное сохранение в файл
+	bool isSaving(const std::string& filename);
+
+	/// Ждет завершения всех поставленных сохранений
+	void wait();
+};
+
+#endif // MENU_FILES_H
\ No newline at end of file
@@ -0,0 +1,180 @@
+﻿#include "menu_snapshot.h"
+#include "menu_files.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+// Сигнатура и метка порядка байт
+static const char kMagic[8] = { 'R', 'M', 'E', 'N', 'U', 'S', 'N', 'P' };
+static const uint32_t kByteOrderMark = 0x01020304;
+
+// Минут в часе, сутках и "году" (31 день, как в Time::normalizeTime)
+static const long long kMinutesPerHour = 60;
+static const long long kMinutesPerDay = 24 * kMinutesPerHour;
+static const long long kMinutesPerYear = 31 * kMinutesPerDay;
+
+// Дописывает значение фиксированной ширины в буфер
+template <typename T>
+static void appendValue(std::string& out, const T& value) {
+	out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Читает значение фиксированной ширины из буфера
+template <typename T>
+static T readValue(const char* data) {
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+// FNV-1a: один проход по байтам без таблиц
+uint64_t MenuSnapshot::checksum(const char* data, size_t size) {
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+// Раскладывает минуты на годы, дни, часы и минуты
+Time MenuSnapshot::timeFromMinutes(long long minutes) {
+	const int years = static_cast<int>(minutes / kMinutesPerYear);
+	minutes %= kMinutesPerYear;
+	const int days = static_cast<int>(minutes / kMinutesPerDay);
+	minutes %= kMinutesPerDay;
+	return Time(static_cast<int>(minutes / kMinutesPerHour), static_cast<int>(minutes % kMinutesPerHour), days, years);
+}
+
+// Собирает колонки в памяти и атомарно записывает файл двумя операциями: заголовок и данные
+uint64_t MenuSnapshot::save(const std::vector<Dish>& dishes, const std::string& filename) {
+	const size_t count = dishes.size();
+	size_t namesSize = 0;
+	for (const auto& dish : dishes) {
+		if (dish.name.size() > UINT32_MAX) {
+			throw std::runtime_error("Слишком длинное название блюда для снимка");
+		}
+		namesSize += dish.name.size();
+	}
+
+	std::string payload;
+	payload.reserve(count * (sizeof(double) + sizeof(int64_t) + sizeof(uint64_t)) + namesSize);
+	for (const auto& dish : dishes) appendValue(payload, dish.price);
+	for (const auto& dish : dishes) appendValue(payload, static_cast<int64_t>(dish.totalMinutes()));
+	uint64_t end = 0;
+	for (const auto& dish : dishes) {
+		end += dish.name.size();
+		appendValue(payload, end);
+	}
+	for (const auto& dish : dishes) payload.append(dish.name);
+
+	std::string header(kMagic, sizeof(kMagic));
+	appendValue(header, kVersion);
+	appendValue(header, kByteOrderMark);
+	appendValue(header, static_cast<uint64_t>(count));
+	appendValue(header, static_cast<uint64_t>(namesSize));
+	const uint64_t payloadChecksum = checksum(payload.data(), payload.size());
+	appendValue(header, payloadChecksum);
+
+	AtomicFile file(filename, true);
+	file.write(header.data(), header.size());
+	file.write(payload.data(), payload.size());
+	file.commit();
+	return payloadChecksum;
+}
+
+// Читает файл целиком, проверяет заголовок, размер и контрольную сумму, затем заполняет хранилище
+size_t MenuSnapshot::load(const std::string& filename, IMenuStorage& storage) {
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) {
+		throw std::runtime_error("Не удалось открыть файл: " + filename);
+	}
+	const std::streamoff fileSize = file.tellg();
+	file.seekg(0);
+	std::string data(static_cast<size_t>(fileSize), '\0');
+	file.read(&data[0], fileSize);
+	if (!file || data.size() < kHeaderSize || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+		throw std::runtime_error("Файл не является снимком меню: " + filename);
+	}
+
+	const char* header = data.data();
+	const uint32_t version = readValue<uint32_t>(header + 8);
+	if (version != 1 && version != kVersion) {
+		throw std::runtime_error("Неподдерживаемая версия снимка: " + std::to_string(version));
+	}
+	if (readValue<uint32_t>(header + 12) != kByteOrderMark) {
+		throw std::runtime_error("Снимок записан с другим порядком байт");
+	}
+	const uint64_t count = readValue<uint64_t>(header + 16);
+	const uint64_t namesSize = readValue<uint64_t>(header + 24);
+	const uint64_t expectedChecksum = readValue<uint64_t>(header + 32);
+
+	// Версия 1 хранит длины названий u32, версия 2 - концы названий u64
+	const uint64_t boundSize = version == 1 ? sizeof(uint32_t) : sizeof(uint64_t);
+	const uint64_t recordSize = sizeof(double) + sizeof(int64_t) + boundSize;
+	const uint64_t payloadSize = data.size() - kHeaderSize;
+	// Размер таблицы названий сравнивается с остатком, а не суммой, чтобы огромный namesSize не переполнил проверку
+	if (count > payloadSize / recordSize || namesSize != payloadSize - count * recordSize) {
+		throw std::runtime_error("Снимок обрезан или поврежден: " + filename);
+	}
+	const char* payload = header + kHeaderSize;
+	if (checksum(payload, static_cast<size_t>(payloadSize)) != expectedChecksum) {
+		throw std::runtime_error("Контрольная сумма снимка не совпадает: " + filename);
+	}
+
+	const char* prices = payload;
+	const char* minutes = prices + count * sizeof(double);
+	const char* bounds = minutes + count * sizeof(int64_t);
+	const char* names = bounds + count * boundSize;
+
+	// Границы названий проверяются до заполнения, чтобы поврежденный снимок не оставил хранилище заполненным наполовину
+	std::vector<uint64_t> ends(static_cast<size_t>(count));
+	uint64_t total = 0;
+	bool ordered = true;
+	for (uint64_t i = 0; i < count; ++i) {
+		if (version == 1) {
+			total += readValue<uint32_t>(bounds + i * sizeof(uint32_t));
+		}
+		else {
+			const uint64_t end = readValue<uint64_t>(bounds + i * sizeof(uint64_t));
+			ordered = ordered && end >= total;
+			total = end;
+		}
+		ends[static_cast<size_t>(i)] = total;
+	}
+	if (!ordered || total != namesSize) {
+		throw std::runtime_error("Таблица названий снимка повреждена: " + filename);
+	}
+
+	// Блюда передаются хранилищу одним пакетом: без журнала и повторного вычисления ключей
+	std::vector<Dish> dishes;
+	dishes.reserve(static_cast<size_t>(count));
+	uint64_t offset = 0;
+	for (uint64_t i = 0; i < count; ++i) {
+		const uint64_t end = ends[static_cast<size_t>(i)];
+		dishes.emplace_back(std::string(names + offset, static_cast<size_t>(end - offset)),
+			readValue<double>(prices + i * sizeof(double)),
+			timeFromMinutes(readValue<int64_t>(minutes + i * sizeof(int64_t))));
+		offset = end;
+	}
+	storage.addDishes(std::move(dishes));
+	return static_cast<size_t>(count);
+}
+
+// Сравнивает первые байты файла с сигнатурой
+bool MenuSnapshot::isSnapshot(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary);
+	char magic[sizeof(kMagic)] = {};
+	return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+// Контрольная сумма лежит в заголовке по смещению 32
+bool MenuSnapshot::readChecksum(const std::string& filename, uint64_t& checksum) {
+	std::ifstream file(filename, std::ios::binary);
+	char header[kHeaderSize] = {};
+	if (!file.read(header, sizeof(header)) || std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+		return false;
+	}
+	checksum = readValue<uint64_t>(header + 32);
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+﻿#pragma once
+#ifndef MENU_SNAPSHOT_H
+#define MENU_SNAPSHOT_H
+
+#include "interfaces.h"
+#include "models.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Двоичный снимок меню. Формат (версия 2, порядок байт машины, проверяется меткой):
+///   заголовок 40 байт: "RMENUSNP", версия (u32), метка порядка байт 0x01020304 (u32),
+///   количество блюд (u64), размер таблицы названий (u64), контрольная сумма FNV-1a данных (u64);
+///   данные: цены double[N], время в минутах int64[N], концы названий в таблице u64[N], названия подряд.
+/// Колонки фиксированной ширины пишутся и читаются одним копированием; по концам названий любая
+/// строка доступна без просмотра предыдущих (см. MappedSnapshot). Версия 1 вместо концов хранила
+/// длины названий u32[N] и по-прежнему загружается.
+class MenuSnapshot {
+public:
+	static constexpr uint32_t kVersion = 2;         ///< Текущая версия формата
+	static constexpr size_t kHeaderSize = 40;       ///< Размер заголовка в байтах
+
+	/// Сохраняет блюда в файл снимка и возвращает контрольную сумму его данных;
+	/// бросает std::runtime_error при ошибке записи
+	static uint64_t save(const std::vector<Dish>& dishes, const std::string& filename);
+
+	/// Загружает снимок в хранилище и возвращает количество блюд.
+	/// Бросает std::runtime_error, если файл поврежден, обрезан или другой версии
+	static size_t load(const std::string& filename, IMenuStorage& storage);
+
+	/// Проверяет, начинается ли файл с сигнатуры снимка
+	static bool isSnapshot(const std::string& filename);
+
+	/// Читает контрольную сумму данных из заголовка снимка; false, если файл не снимок
+	static bool readChecksum(const std::string& filename, uint64_t& checksum);
+
+	/// Контрольная сумма FNV-1a (64 бита)
+	static uint64_t checksum(const char* data, size_t size);
+
+	/// Восстанавливает время приготовления из общего количества минут
+	static Time timeFromMinutes(long long minutes);
+};
+
+#endif // MENU_SNAPSHOT_H
\ No newline at end of file
@@ -0,0 +1,264 @@
+﻿#include "menu_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Границы корзин гистограммы цен
+static const std::vector<double>& priceBounds() {
+	static const std::vector<double> bounds = { 5.0, 10.0, 15.0, 20.0, 30.0, 50.0, 100.0 };
+	return bounds;
+}
+
+// Границы корзин гистограммы времени в минутах
+static const std::vector<double>& minutesBounds() {
+	static const std::vector<double> bounds = { 10.0, 20.0, 30.0, 45.0, 60.0, 90.0, 120.0 };
+	return bounds;
+}
+
+// Переводит цену в копейки
+static long long toCents(double price) {
+	return std::llround(price * 100.0);
+}
+
+// Уменьшает счетчик значения в словаре, удаляя значение при обнулении
+static void decrement(std::map<long long, size_t>& counts, long long value) {
+	auto it = counts.find(value);
+	if (it == counts.end()) return;
+	if (--it->second == 0) counts.erase(it);
+}
+
+// Добавляет в словарь счетчики значений: значения сортируются, и каждое различное значение ищется один раз
+static void addCounts(std::map<long long, size_t>& counts, std::vector<long long>& values) {
+	std::sort(values.begin(), values.end());
+	for (size_t i = 0; i < values.size();) {
+		size_t end = i + 1;
+		while (end < values.size() && values[end] == values[i]) end++;
+		counts[values[i]] += end - i;
+		i = end;
+	}
+}
+
+// ==================== FIXED HISTOGRAM ====================
+
+FixedHistogram::FixedHistogram(const std::vector<double>& bounds)
+	: bounds_(bounds), counts_(bounds.size() + 1, 0) {}
+
+// Возвращает номер корзины для значения
+size_t FixedHistogram::bucketOf(double value) const {
+	return static_cast<size_t>(std::upper_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin());
+}
+
+// Учитывает значение
+void FixedHistogram::add(double value) {
+	counts_[bucketOf(value)]++;
+}
+
+// Убирает ранее учтенное значение
+void FixedHistogram::remove(double value) {
+	size_t& count = counts_[bucketOf(value)];
+	if (count > 0) count--;
+}
+
+// Добавляет счетчики гистограммы с теми же границами
+void FixedHistogram::merge(const FixedHistogram& other) {
+	if (other.bounds_ != bounds_) {
+		throw std::invalid_argument("Нельзя объединить гистограммы с разными границами");
+	}
+	for (size_t i = 0; i < counts_.size(); ++i) {
+		counts_[i] += other.counts_[i];
+	}
+}
+
+// Обнуляет счетчики
+void FixedHistogram::clear() {
+	std::fill(counts_.begin(), counts_.end(), 0);
+}
+
+// ==================== QUANTILE SKETCH ====================
+
+// Корзина i покрывает (gamma^(i-1), gamma^i], поэтому любая оценка внутри нее
+// отличается от истинного значения не больше чем на relativeAccuracy
+QuantileSketch::QuantileSketch(double relativeAccuracy)
+	: gamma_((1.0 + relativeAccuracy) / (1.0 - relativeAccuracy))
+	, logGamma_(std::log(gamma_))
+	, zeroCount_(0)
+	, count_(0) {}
+
+// Возвращает номер корзины для положительного значения
+int QuantileSketch::bucketOf(double value) const {
+	return static_cast<int>(std::ceil(std::log(value) / logGamma_));
+}
+
+// Учитывает значение
+void QuantileSketch::add(double value) {
+	if (value > 0.0) buckets_[bucketOf(value)]++;
+	else zeroCount_++;
+	count_++;
+}
+
+// Убирает ранее учтенное значение
+void QuantileSketch::remove(double value) {
+	if (value > 0.0) {
+		auto it = buckets_.find(bucketOf(value));
+		if (it == buckets_.end()) return;
+		if (--it->second == 0) buckets_.erase(it);
+	}
+	else {
+		if (zeroCount_ == 0) return;
+		zeroCount_--;
+	}
+	count_--;
+}
+
+// Объединяет с эскизом той же точности
+void QuantileSketch::merge(const QuantileSketch& other) {
+	if (other.gamma_ != gamma_) {
+		throw std::invalid_argument("Нельзя объединить эскизы квантилей разной точности");
+	}
+	for (const auto& bucket : other.buckets_) {
+		buckets_[bucket.first] += bucket.second;
+	}
+	zeroCount_ += other.zeroCount_;
+	count_ += other.count_;
+}
+
+// Очищает эскиз
+void QuantileSketch::clear() {
+	buckets_.clear();
+	zeroCount_ = 0;
+	count_ = 0;
+}
+
+// Возвращает приближенный квантиль: проход по корзинам, число которых не зависит от размера меню
+double QuantileSketch::quantile(double q) const {
+	if (count_ == 0) return 0.0;
+
+	q = std::min(std::max(q, 0.0), 1.0);
+	size_t rank = static_cast<size_t>(q * static_cast<double>(count_ - 1));
+	if (rank < zeroCount_) return 0.0;
+
+	size_t seen = zeroCount_;
+	for (const auto& bucket : buckets_) {
+		seen += bucket.second;
+		if (seen > rank) {
+			// Середина корзины в смысле относительной ошибки
+			return 2.0 * std::pow(gamma_, bucket.first) / (gamma_ + 1.0);
+		}
+	}
+	return 2.0 * std::pow(gamma_, buckets_.rbegin()->first) / (gamma_ + 1.0);
+}
+
+// ==================== MENU STATS ====================
+
+MenuStats::MenuStats()
+	: count_(0)
+	, priceCents_(0)
+	, minutesSum_(0)
+	, priceHistogram_(priceBounds())
+	, timeHistogram_(minutesBounds()) {}
+
+// Учитывает добавленное блюдо
+void MenuStats::add(const Dish& dish) {
+	long long cents = toCents(dish.price);
+	long long minutes = dish.totalMinutes();
+
+	count_++;
+	priceCents_ += cents;
+	minutesSum_ += minutes;
+	prices_[cents]++;
+	minutes_[minutes]++;
+	priceHistogram_.add(dish.price);
+	timeHistogram_.add(static_cast<double>(minutes));
+	priceSketch_.add(dish.price);
+	timeSketch_.add(static_cast<double>(minutes));
+}
+
+// Учитывает блюда пакетом: суммы, гистограммы и эскизы - за один проход, словари минимума и максимума -
+// по одному обращению на различную цену и время вместо обращения на каждое блюдо
+void MenuStats::addAll(const std::vector<Dish>& dishes, size_t first) {
+	std::vector<long long> cents;
+	std::vector<long long> minutes;
+	cents.reserve(dishes.size() - first);
+	minutes.reserve(dishes.size() - first);
+	for (size_t i = first; i < dishes.size(); ++i) {
+		const Dish& dish = dishes[i];
+		cents.push_back(toCents(dish.price));
+		minutes.push_back(dish.totalMinutes());
+		priceCents_ += cents.back();
+		minutesSum_ += minutes.back();
+		priceHistogram_.add(dish.price);
+		timeHistogram_.add(static_cast<double>(minutes.back()));
+		priceSketch_.add(dish.price);
+		timeSketch_.add(static_cast<double>(minutes.back()));
+	}
+	count_ += cents.size();
+	addCounts(prices_, cents);
+	addCounts(minutes_, minutes);
+}
+
+// Учитывает удаленное блюдо
+void MenuStats::remove(const Dish& dish) {
+	long long cents = toCents(dish.price);
+	long long minutes = dish.totalMinutes();
+	if (count_ == 0 || prices_.find(cents) == prices_.end()) return;
+
+	count_--;
+	priceCents_ -= cents;
+	minutesSum_ -= minutes;
+	decrement(prices_, cents);
+	decrement(minutes_, minutes);
+	priceHistogram_.remove(dish.price);
+	timeHistogram_.remove(static_cast<double>(minutes));
+	priceSketch_.remove(dish.price);
+	timeSketch_.remove(static_cast<double>(minutes));
+}
+
+// Объединяет с агрегатами другой части меню
+void MenuStats::merge(const MenuStats& other) {
+	count_ += other.count_;
+	priceCents_ += other.priceCents_;
+	minutesSum_ += other.minutesSum_;
+	for (const auto& item : other.prices_) prices_[item.first] += item.second;
+	for (const auto& item : other.minutes_) minutes_[item.first] += item.second;
+	priceHistogram_.merge(other.priceHistogram_);
+	timeHistogram_.merge(other.timeHistogram_);
+	priceSketch_.merge(other.priceSketch_);
+	timeSketch_.merge(other.timeSketch_);
+}
+
+// Очищает агрегаты
+void MenuStats::clear() {
+	count_ = 0;
+	priceCents_ = 0;
+	minutesSum_ = 0;
+	prices_.clear();
+	minutes_.clear();
+	priceHistogram_.clear();
+	timeHistogram_.clear();
+	priceSketch_.clear();
+	timeSketch_.clear();
+}
+
+double MenuStats::minPrice() const {
+	return prices_.empty() ? 0.0 : static_cast<double>(prices_.begin()->first) / 100.0;
+}
+
+double MenuStats::maxPrice() const {
+	return prices_.empty() ? 0.0 : static_cast<double>(prices_.rbegin()->first) / 100.0;
+}
+
+double MenuStats::meanPrice() const {
+	return count_ == 0 ? 0.0 : static_cast<double>(priceCents_) / 100.0 / static_cast<double>(count_);
+}
+
+long long MenuStats::minMinutes() const {
+	return minutes_.empty() ? 0 : minutes_.begin()->first;
+}
+
+long long MenuStats::maxMinutes() const {
+	return minutes_.empty() ? 0 : minutes_.rbegin()->first;
+}
+
+double MenuStats::meanMinutes() const {
+	return count_ == 0 ? 0.0 : static_cast<double>(minutesSum_) / static_cast<double>(count_);
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+﻿#pragma once
+#ifndef MENU_STATS_H
+#define MENU_STATS_H
+
+#include "models.h"
+#include <map>
+#include <vector>
+
+/// Гистограмма с фиксированными границами корзин: корзина i содержит значения
+/// из [bounds[i - 1], bounds[i]), первая - всё меньше bounds[0], последняя - всё от bounds.back()
+class FixedHistogram {
+private:
+	std::vector<double> bounds_;    ///< Возрастающие границы корзин
+	std::vector<size_t> counts_;    ///< Количество значений в корзинах (bounds_.size() + 1)
+
+	/// Возвращает номер корзины для значения
+	size_t bucketOf(double value) const;
+
+public:
+	/// Конструктор с возрастающими границами корзин
+	explicit FixedHistogram(const std::vector<double>& bounds);
+
+	/// Учитывает значение
+	void add(double value);
+
+	/// Убирает ранее учтенное значение
+	void remove(double value);
+
+	/// Добавляет счетчики гистограммы с теми же границами
+	void merge(const FixedHistogram& other);
+
+	/// Обнуляет счетчики
+	void clear();
+
+	/// Возвращает границы корзин
+	const std::vector<double>& bounds() const { return bounds_; }
+
+	/// Возвращает счетчики корзин
+	const std::vector<size_t>& counts() const { return counts_; }
+};
+
+/// Сливаемый эскиз квантилей с относительной точностью: значения раскладываются
+/// по логарифмическим корзинам, поэтому поддерживает удаление и объединение частей
+class QuantileSketch {
+private:
+	double gamma_;                  ///< Отношение границ соседних корзин
+	double logGamma_;               ///< Натуральный логарифм gamma_
+	std::map<int, size_t> buckets_; ///< Номер логарифмической корзины -> количество значений
+	size_t zeroCount_;              ///< Количество нулевых (и отрицательных) значений
+	size_t count_;                  ///< Общее количество значений
+
+	/// Возвращает номер корзины для положительного значения
+	int bucketOf(double value) const;
+
+public:
+	/// Конструктор с относительной точностью оценки квантилей (например, 0.01 - 1%)
+	explicit QuantileSketch(double relativeAccuracy = 0.01);
+
+	/// Учитывает значение
+	void add(double value);
+
+	/// Убирает ранее учтенное значение
+	void remove(double value);
+
+	/// Объединяет с эскизом той же точности
+	void merge(const QuantileSketch& other);
+
+	/// Очищает эскиз
+	void clear();
+
+	/// Возвращает количество значений
+	size_t count() const { return count_; }
+
+	/// Возвращает приближенный квантиль q из [0, 1] (0 для пустого эскиза)
+	double quantile(double q) const;
+};
+
+/// Агрегаты меню, поддерживаемые при каждом добавлении и удалении блюда:
+/// количество, минимум, максимум и среднее цены и времени, гистограммы и квантили.
+/// Агрегаты частей меню (например, загружаемых параллельно) объединяются через merge.
+class MenuStats {
+private:
+	size_t count_;                          ///< Количество блюд
+	long long priceCents_;                  ///< Сумма цен в копейках (без накопления ошибки округления)
+	long long minutesSum_;                  ///< Сумма времени приготовления в минутах
+	std::map<long long, size_t> prices_;    ///< Цена в копейках -> количество (для минимума и максимума)
+	std::map<long long, size_t> minutes_;   ///< Время в минутах -> количество
+	FixedHistogram priceHistogram_;         ///< Гистограмма цен
+	FixedHistogram timeHistogram_;          ///< Гистограмма времени в минутах
+	QuantileSketch priceSketch_;            ///< Эскиз квантилей цен
+	QuantileSketch timeSketch_;             ///< Эскиз квантилей времени
+
+public:
+	MenuStats();
+
+	/// Учитывает добавленное блюдо
+	void add(const Dish& dish);
+
+	/// Учитывает блюда dishes[first..] пакетом (загрузка файла)
+	void addAll(const std::vector<Dish>& dishes, size_t first = 0);
+
+	/// Учитывает удаленное блюдо
+	void remove(const Dish& dish);
+
+	/// Объединяет с агрегатами другой части меню
+	void merge(const MenuStats& other);
+
+	/// Очищает агрегаты
+	void clear();
+
+	/// Возвращает количество блюд
+	size_t count() const { return count_; }
+
+	/// Минимальная, максимальная и средняя цена (0 для пустого меню)
+	double minPrice() const;
+	double maxPrice() const;
+	double meanPrice() const;
+
+	/// Минимальное, максимальное и среднее время приготовления в минутах (0 для пустого меню)
+	long long minMinutes() const;
+	long long maxMinutes() const;
+	double meanMinutes() const;
+
+	/// Приближенные квантили цены и времени в минутах
+	double priceQuantile(double q) const { return priceSketch_.quantile(q); }
+	double minutesQuantile(double q) const { return timeSketch_.quantile(q); }
+
+	/// Гистограммы цены и времени в минутах
+	const FixedHistogram& priceHistogram() const { return priceHistogram_; }
+	const FixedHistogram& timeHistogram() const { return timeHistogram_; }
+};
+
+#endif // MENU_STATS_H
\ No newline at end of file
@@ -0,0 +1,72 @@
+﻿#include "menu_transaction.h"
+#include <cmath>
+
+// Точность сравнения цен, как у MenuStorage::removeDish
+static const double kPriceEpsilon = 0.001;
+
+MenuTransaction::MenuTransaction() : cancelledCount_(0) {}
+
+// Отменяет добавления этой транзакции с названием name, подходящие под условие
+template <typename Match>
+size_t MenuTransaction::cancelAdded(const std::string& name, Match match) {
+	auto it = addedByName_.find(name);
+	if (it == addedByName_.end()) return 0;
+
+	size_t count = 0;
+	for (size_t index : it->second) {
+		if (!cancelled_[index] && match(added_[index])) {
+			cancelled_[index] = 1;
+			count++;
+		}
+	}
+	cancelledCount_ += count;
+	return count;
+}
+
+// Откладывает добавление блюда
+void MenuTransaction::add(const std::string& name, double price, const Time& time) {
+	addedByName_[name].push_back(added_.size());
+	added_.emplace_back(name, price, time);
+	cancelled_.push_back(0);
+}
+
+// Откладывает удаление всех копий блюда
+size_t MenuTransaction::remove(const std::string& name, double price, const Time& time) {
+	removed_.emplace_back(name, price, time);
+	removedByName_[name].emplace_back(price, time);
+	return cancelAdded(name, [&](const Dish& dish) {
+		return std::fabs(dish.price - price) < kPriceEpsilon && dish.time == time;
+	});
+}
+
+// Откладывает удаление всех блюд с названием
+size_t MenuTransaction::removeName(const std::string& name) {
+	if (removedNameSet_.insert(name).second) removedNames_.push_back(name);
+	return cancelAdded(name, [](const Dish&) { return true; });
+}
+
+// Удаляет ли транзакция блюдо хранилища: поиск по названию в хеш-таблицах
+bool MenuTransaction::removes(const Dish& dish) const {
+	if (removedNameSet_.count(dish.name) > 0) return true;
+
+	auto it = removedByName_.find(dish.name);
+	if (it == removedByName_.end()) return false;
+	for (const auto& variant : it->second) {
+		if (std::fabs(dish.price - variant.first) < kPriceEpsilon && dish.time == variant.second) return true;
+	}
+	return false;
+}
+
+// Забирает неотмененные добавления в порядке команд
+std::vector<Dish> MenuTransaction::takeAdded() {
+	std::vector<Dish> result;
+	result.reserve(added_.size() - cancelledCount_);
+	for (size_t i = 0; i < added_.size(); ++i) {
+		if (!cancelled_[i]) result.push_back(std::move(added_[i]));
+	}
+	added_.clear();
+	cancelled_.clear();
+	addedByName_.clear();
+	cancelledCount_ = 0;
+	return result;
+}
\ No newline at end of file
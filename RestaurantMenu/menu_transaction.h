@@ -0,0 +1,67 @@
+﻿#pragma once
+#ifndef MENU_TRANSACTION_H
+#define MENU_TRANSACTION_H
+
+#include "models.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/// Изменения меню, накопленные между begin и commit. До фиксации хранилище не меняется,
+/// поэтому откат - просто удаление буферов. Удаление сразу отменяет подходящие добавления
+/// этой же транзакции, а остальные удаления и добавления применяются к хранилищу при commit
+/// одним проходом (IMenuStorage::applyBatch) вместо пересортировки после каждой команды.
+class MenuTransaction {
+private:
+	std::vector<Dish> added_;                       ///< Добавленные блюда в порядке команд
+	std::vector<char> cancelled_;                   ///< Признак добавления, отмененного удалением
+	std::unordered_map<std::string, std::vector<size_t>> addedByName_; ///< Номера добавлений по названию
+	size_t cancelledCount_;                         ///< Количество отмененных добавлений
+	std::vector<Dish> removed_;                     ///< Удаления по точному совпадению
+	std::vector<std::string> removedNames_;         ///< Удаления всех блюд с названием
+	/// Цены и время точных удалений по названию
+	std::unordered_map<std::string, std::vector<std::pair<double, Time>>> removedByName_;
+	std::unordered_set<std::string> removedNameSet_; ///< Названия, удаляемые целиком
+
+	/// Отменяет добавления этой транзакции с названием name, подходящие под условие
+	template <typename Match>
+	size_t cancelAdded(const std::string& name, Match match);
+
+public:
+	MenuTransaction();
+
+	/// Откладывает добавление блюда
+	void add(const std::string& name, double price, const Time& time);
+
+	/// Откладывает удаление всех копий блюда (сравнение как у removeDish);
+	/// возвращает количество отмененных добавлений этой транзакции
+	size_t remove(const std::string& name, double price, const Time& time);
+
+	/// Откладывает удаление всех блюд с названием; возвращает количество отмененных добавлений
+	size_t removeName(const std::string& name);
+
+	/// Удаляет ли транзакция блюдо, уже находящееся в хранилище
+	bool removes(const Dish& dish) const;
+
+	/// Есть ли отложенные удаления
+	bool hasRemovals() const { return !removed_.empty() || !removedNames_.empty(); }
+
+	/// Забирает неотмененные добавления в порядке команд
+	std::vector<Dish> takeAdded();
+
+	/// Удаления по точному совпадению в порядке команд
+	const std::vector<Dish>& removed() const { return removed_; }
+
+	/// Удаления по названию в порядке команд
+	const std::vector<std::string>& removedNames() const { return removedNames_; }
+
+	/// Количество отложенных изменений: добавления без отмененных и удаления
+	size_t size() const { return added_.size() - cancelledCount_ + removed_.size() + removedNames_.size(); }
+
+	/// Нет ли отложенных изменений
+	bool empty() const { return size() == 0; }
+};
+
+#endif // MENU_TRANSACTION_H
\ No newline at end of file
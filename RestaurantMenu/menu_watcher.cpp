@@ -0,0 +1,146 @@
+﻿#include "menu_watcher.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+// Читает файл целиком в текстовом режиме, как его читает MenuFileParser
+static std::string readFile(const std::string& filename) {
+	std::ifstream file(filename);
+	if (!file.is_open()) {
+		throw std::runtime_error("Не удалось открыть файл: " + filename);
+	}
+	std::ostringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+// Делит участок текста на непустые строки
+static void splitLines(const std::string& text, size_t first, size_t last, std::vector<std::string_view>& lines) {
+	while (first < last) {
+		size_t end = text.find('\n', first);
+		if (end == std::string::npos || end > last) end = last;
+		if (end > first) lines.emplace_back(text.data() + first, end - first);
+		first = end + 1;
+	}
+}
+
+MenuFileWatcher::MenuFileWatcher() : size_(0) {}
+
+// Запоминает время изменения, размер и содержимое файла
+void MenuFileWatcher::watch(const std::string& filename) {
+	std::error_code error;
+	std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(filename, error);
+	uintmax_t size = std::filesystem::file_size(filename, error);
+	if (error) {
+		throw std::runtime_error("Не удалось получить сведения о файле: " + filename);
+	}
+	content_ = readFile(filename);
+	path_ = filename;
+	writeTime_ = writeTime;
+	size_ = size;
+}
+
+void MenuFileWatcher::stop() {
+	path_.clear();
+	content_.clear();
+	content_.shrink_to_fit();
+}
+
+void MenuFileWatcher::rebase() {
+	if (active()) watch(path_);
+}
+
+// Файл перечитывается, только если изменились время изменения или размер
+bool MenuFileWatcher::poll(Changes& changes) {
+	if (!active()) return false;
+	std::error_code error;
+	std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path_, error);
+	uintmax_t size = std::filesystem::file_size(path_, error);
+	if (error) {
+		throw std::runtime_error("Не удалось получить сведения о файле: " + path_);
+	}
+	if (writeTime == writeTime_ && size == size_) return false;
+
+	std::string content = readFile(path_);
+	writeTime_ = writeTime;
+	size_ = size;
+
+	std::vector<std::string> removed, added;
+	changes = Changes();
+	diffLines(content_, content, removed, added, &changes.linesCompared);
+	content_.swap(content);
+	if (removed.empty() && added.empty()) return false;
+
+	parseLines(removed, changes.removed, changes.invalidRemoved);
+	parseLines(added, changes.added, changes.invalidAdded);
+	return true;
+}
+
+// Проверки те же, что при загрузке файла: формат строки и положительная цена
+void MenuFileWatcher::parseLines(const std::vector<std::string>& lines, std::vector<Dish>& dishes, int& invalid) {
+	for (const auto& line : lines) {
+		std::string name;
+		double price = 0.0;
+		Time time;
+		if (parser_.extractValuesWithRegex(line, name, price, time) && price > 0) {
+			dishes.emplace_back(name, price, time);
+		}
+		else {
+			invalid++;
+		}
+	}
+}
+
+// Середина между общими началом и концом всегда начинается и заканчивается на границе строки
+void MenuFileWatcher::diffLines(const std::string& before, const std::string& after,
+	std::vector<std::string>& removed, std::vector<std::string>& added, size_t* linesCompared) {
+	const size_t shorter = std::min(before.size(), after.size());
+	size_t prefix = 0;
+	while (prefix < shorter && before[prefix] == after[prefix]) prefix++;
+	if (prefix == before.size() && prefix == after.size()) {
+		if (linesCompared) *linesCompared = 0;
+		return;
+	}
+	while (prefix > 0 && before[prefix - 1] != '\n') prefix--;
+
+	size_t matched = 0;
+	const size_t maxSuffix = shorter - prefix;
+	while (matched < maxSuffix && before[before.size() - 1 - matched] == after[after.size() - 1 - matched]) matched++;
+
+	// Общий конец должен начинаться с новой строки в обоих текстах: сразу после общего перевода
+	// строки или там же, где кончается общее начало
+	size_t suffix = matched;
+	while (suffix > 0) {
+		const size_t start = before.size() - suffix;
+		if (start == prefix && after.size() - suffix == prefix) break;
+		if (suffix < matched && before[start - 1] == '\n') break;
+		suffix--;
+	}
+
+	std::vector<std::string_view> oldLines, newLines;
+	splitLines(before, prefix, before.size() - suffix, oldLines);
+	splitLines(after, prefix, after.size() - suffix, newLines);
+	if (linesCompared) *linesCompared = oldLines.size() + newLines.size();
+
+	// Строка, встречающаяся в обеих частях, не изменилась, даже если переместилась
+	std::unordered_map<std::string_view, long long> balance;
+	for (const auto& line : oldLines) balance[line]++;
+	for (const auto& line : newLines) balance[line]--;
+	for (const auto& line : oldLines) {
+		auto it = balance.find(line);
+		if (it->second > 0) {
+			removed.emplace_back(line);
+			it->second--;
+		}
+	}
+	for (const auto& line : newLines) {
+		auto it = balance.find(line);
+		if (it->second < 0) {
+			added.emplace_back(line);
+			it->second++;
+		}
+	}
+}
\ No newline at end of file
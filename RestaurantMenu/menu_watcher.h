@@ -0,0 +1,65 @@
+﻿#pragma once
+#ifndef MENU_WATCHER_H
+#define MENU_WATCHER_H
+
+#include "file_parser.h"
+#include "models.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/// Отслеживание изменений загруженного текстового файла меню. Проверка - сравнение времени
+/// изменения и размера файла, поэтому ее можно выполнять перед каждой командой. Изменившийся файл
+/// сравнивается с прежним содержимым: общие начало и конец отбрасываются сравнением байт, а строки
+/// между ними сопоставляются как мультимножества по хешу, так что разбираются только добавленные и
+/// удаленные строки. Порядок строк в меню не важен - хранилище все равно отсортировано.
+class MenuFileWatcher {
+public:
+	/// Изменения файла с прошлой проверки
+	struct Changes {
+		std::vector<Dish> added;        ///< Блюда из появившихся строк
+		std::vector<Dish> removed;      ///< Блюда из исчезнувших строк
+		int invalidAdded = 0;           ///< Появилось невалидных строк
+		int invalidRemoved = 0;         ///< Исчезло невалидных строк
+		size_t linesCompared = 0;       ///< Строк, попавших в сравниваемую середину файла
+	};
+
+private:
+	std::string path_;                              ///< Отслеживаемый файл (пустой - не отслеживается)
+	std::string content_;                           ///< Содержимое файла при прошлой проверке
+	std::filesystem::file_time_type writeTime_;     ///< Время изменения при прошлой проверке
+	uintmax_t size_;                                ///< Размер при прошлой проверке
+	MenuFileParser parser_;                         ///< Разбор изменившихся строк
+
+	/// Разбирает строки в блюда, считая невалидные
+	void parseLines(const std::vector<std::string>& lines, std::vector<Dish>& dishes, int& invalid);
+
+public:
+	MenuFileWatcher();
+
+	/// Начинает отслеживать файл с текущим содержимым как исходным; бросает std::runtime_error
+	void watch(const std::string& filename);
+
+	/// Перестает отслеживать файл
+	void stop();
+
+	/// Отслеживается ли файл
+	bool active() const { return !path_.empty(); }
+
+	/// Отслеживаемый файл
+	const std::string& path() const { return path_; }
+
+	/// Принимает текущее содержимое файла за исходное (после сохранения меню в этот же файл)
+	void rebase();
+
+	/// Проверяет файл; если он изменился, заполняет changes и возвращает true.
+	/// Бросает std::runtime_error, если файл нельзя прочитать
+	bool poll(Changes& changes);
+
+	/// Находит строки, исчезнувшие из before и появившиеся в after (без учета порядка и пустых строк)
+	static void diffLines(const std::string& before, const std::string& after,
+		std::vector<std::string>& removed, std::vector<std::string>& added, size_t* linesCompared = nullptr);
+};
+
+#endif // MENU_WATCHER_H
\ No newline at end of file
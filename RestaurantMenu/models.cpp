@@ -1,5 +1,6 @@
 ﻿#include "models.h"
-#include <iomanip>
+#include "collation.h"
+#include "formatting.h"
 
 // ==================== РЕАЛИЗАЦИЯ МЕТОДОВ TIME ====================
 
@@ -59,20 +60,8 @@ long long Time::totalMinutes() const {
 
 // Возвращает строковое представление времени
 std::string Time::toString() const {
-	std::stringstream ss;
-
-	if (time_.tm_year > 0) {
-		ss << time_.tm_year << "г. ";
-	}
-	if (time_.tm_mday > 1 || time_.tm_year > 0) {
-		ss << (time_.tm_mday - 1) << "д. ";
-	}
-	if (time_.tm_hour > 0 || time_.tm_mday > 1 || time_.tm_year > 0) {
-		ss << time_.tm_hour << "ч ";
-	}
-	ss << time_.tm_min << "м";
-
-	return ss.str();
+	char buffer[DishFormat::kMaxTimeLength];
+	return std::string(buffer, DishFormat::formatTime(*this, buffer));
 }
 
 // Оператор сравнения "меньше" для сортировки
@@ -91,11 +80,12 @@ bool Time::operator==(const Time& other) const {
 // ==================== РЕАЛИЗАЦИЯ МЕТОДОВ DISH ====================
 
 // Конструктор с объектом Time
-Dish::Dish(const std::string& n, double p, const Time& t) : name(n), price(p), time(t) {}
+Dish::Dish(const std::string& n, double p, const Time& t)
+	: name(n), price(p), time(t), sortKey(Collation::makeKey(n)) {}
 
 // Конструктор с отдельными компонентами времени
 Dish::Dish(const std::string& n, double p, int hours, int minutes, int days, int years)
-	: name(n), price(p) {
+	: name(n), price(p), sortKey(Collation::makeKey(n)) {
 	setTime(hours, minutes, days, years);
 }
 
@@ -119,13 +109,11 @@ void Dish::print() const {
 	std::cout << *this; // Используем оператор вывода
 }
 
-// Оператор вывода для Dish
+// Оператор вывода для Dish: строка таблицы с колонками фиксированной ширины
 std::ostream& operator<<(std::ostream& os, const Dish& dish) {
-	std::stringstream ss;
-	ss << std::left << std::setw(25) << dish.name
-		<< std::fixed << std::setprecision(2) << std::setw(10) << dish.price
-		<< dish.getTimeString();
-
-	os << ss.str();
-	return os;
+	// Строка-буфер переиспользуется между вызовами в пределах потока
+	thread_local std::string row;
+	row.clear();
+	DishFormat::appendRow(row, dish);
+	return os.write(row.data(), static_cast<std::streamsize>(row.size()));
 }
\ No newline at end of file
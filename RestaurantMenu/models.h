@@ -45,6 +45,7 @@ public:
 	std::string name;   ///< Название блюда
 	double price;       ///< Цена блюда в валюте
 	Time time;          ///< Время приготовления блюда
+	std::string sortKey; ///< Кэшированный ключ сортировки по названию (см. Collation::makeKey)
 
 	/// Конструктор с объектом Time
 	Dish(const std::string& n, double p, const Time& t);
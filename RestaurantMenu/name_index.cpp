@@ -0,0 +1,363 @@
+﻿#include "name_index.h"
+#include "collation.h"
+#include "models.h"
+#include "query.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+// Минимальное количество удаленных записей, после которого списки триграмм перестраиваются
+static const size_t kCompactThreshold = 1024;
+
+// Окрестность удалений строится для названий не длиннее kShortNameLength первичных весов и до kShortMaxDistance удалений.
+// Запрос, который триграммы не отсекают, обычно не длиннее 3 * maxDistance: при maxDistance <= 2 он может
+// совпасть только с названием не длиннее 8, поэтому таких названий достаточно
+static const size_t kShortNameLength = 8;
+static const size_t kShortMaxDistance = 2;
+
+// Возвращает первичную часть ключа сопоставления
+static std::string_view primaryOf(const std::string& key, const std::string& name) {
+	return std::string_view(key.data(), Collation::primaryLength(key, name.size()));
+}
+
+// Собирает различные триграммы строки первичных весов
+static std::vector<uint32_t> collectTrigrams(std::string_view weights) {
+	std::vector<uint32_t> result;
+	for (size_t i = 0; i + 3 <= weights.size(); ++i) {
+		result.push_back(
+			(static_cast<uint32_t>(static_cast<unsigned char>(weights[i])) << 16) |
+			(static_cast<uint32_t>(static_cast<unsigned char>(weights[i + 1])) << 8) |
+			static_cast<uint32_t>(static_cast<unsigned char>(weights[i + 2])));
+	}
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+// Дополняет первичные веса граничными символами, чтобы края названия тоже попадали в триграммы
+static std::string padded(std::string_view weights) {
+	std::string result;
+	result.reserve(weights.size() + 2);
+	result.push_back('\x01');
+	result.append(weights.data(), weights.size());
+	result.push_back('\x01');
+	return result;
+}
+
+// Собирает различные строки, получаемые из weights удалением не более maxDeletions символов (включая саму строку).
+// Если расстояние между строками не больше d, у них есть общий вариант с не более чем d удалениями из каждой
+static std::vector<std::string> collectDeletions(std::string_view weights, size_t maxDeletions) {
+	std::vector<std::string> result(1, std::string(weights));
+	size_t levelBegin = 0;
+	for (size_t deletions = 1; deletions <= maxDeletions; ++deletions) {
+		const size_t levelEnd = result.size();
+		for (size_t i = levelBegin; i < levelEnd; ++i) {
+			for (size_t position = 0; position < result[i].size(); ++position) {
+				std::string variant = result[i];
+				variant.erase(position, 1);
+				result.push_back(std::move(variant));
+			}
+		}
+		levelBegin = levelEnd;
+	}
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+// Расстояние Левенштейна с отсечением: возвращает bound + 1, если расстояние больше bound
+static size_t boundedEditDistance(std::string_view a, std::string_view b, size_t bound) {
+	if (a.size() > b.size()) std::swap(a, b);
+	if (b.size() - a.size() > bound) return bound + 1;
+
+	std::vector<size_t> previous(a.size() + 1);
+	std::vector<size_t> current(a.size() + 1);
+	for (size_t i = 0; i <= a.size(); ++i) previous[i] = i;
+
+	for (size_t j = 1; j <= b.size(); ++j) {
+		current[0] = j;
+		size_t rowMin = current[0];
+		for (size_t i = 1; i <= a.size(); ++i) {
+			size_t substitution = previous[i - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+			current[i] = std::min({ previous[i] + 1, current[i - 1] + 1, substitution });
+			rowMin = std::min(rowMin, current[i]);
+		}
+		// Вся строка матрицы превысила порог - дальше расстояние только растет
+		if (rowMin > bound) return bound + 1;
+		previous.swap(current);
+	}
+	return std::min(previous[a.size()], bound + 1);
+}
+
+// ==================== NAME INDEX ====================
+
+NameIndex::NameIndex() : deadCount_(0) {}
+
+// Учитывает блюдо с указанным названием
+void NameIndex::add(const std::string& name) {
+	add(name, Collation::makeKey(name));
+}
+
+// Учитывает блюдо с готовым ключом; ключ больше всех известных (названия упорядоченного снимка) вставляется в конец без поиска
+void NameIndex::add(const std::string& name, const std::string& key) {
+	auto hint = byKey_.end();
+	if (byKey_.empty() || byKey_.rbegin()->first < key) {
+		// Новое название - поиск не нужен
+	}
+	else if (byKey_.rbegin()->first == key) {
+		entries_[byKey_.rbegin()->second].count++;
+		return;
+	}
+	else {
+		auto it = byKey_.find(key);
+		if (it != byKey_.end()) {
+			entries_[it->second].count++;
+			return;
+		}
+		hint = byKey_.lower_bound(key);
+	}
+
+	uint32_t id = static_cast<uint32_t>(entries_.size());
+	entries_.push_back(Entry{ name, key, 1 });
+	byKey_.emplace_hint(hint, key, id);
+	indexTrigrams(id);
+}
+
+// Убирает count блюд с указанным названием
+void NameIndex::remove(const std::string& name, size_t count) {
+	auto it = byKey_.find(Collation::makeKey(name));
+	if (it == byKey_.end()) return;
+
+	Entry& entry = entries_[it->second];
+	entry.count = entry.count > count ? entry.count - count : 0;
+	if (entry.count == 0) {
+		// Запись остается в списках триграмм до перестроения
+		byKey_.erase(it);
+		deadCount_++;
+		if (deadCount_ >= kCompactThreshold && deadCount_ * 2 >= entries_.size()) {
+			compact();
+		}
+	}
+}
+
+// Резервирует место еще под names названий
+void NameIndex::reserve(size_t names) {
+	entries_.reserve(entries_.size() + names);
+}
+
+// Полностью очищает индекс
+void NameIndex::clear() {
+	entries_.clear();
+	byKey_.clear();
+	trigrams_.clear();
+	deletions_.clear();
+	deadCount_ = 0;
+}
+
+// Возвращает количество различных названий
+size_t NameIndex::size() const {
+	return byKey_.size();
+}
+
+// Добавляет идентификатор в списки всех триграмм названия
+void NameIndex::indexTrigrams(uint32_t id) {
+	const Entry& entry = entries_[id];
+	const std::string_view weights = primaryOf(entry.key, entry.name);
+	// Идентификаторы выдаются по возрастанию, поэтому списки остаются упорядоченными
+	for (uint32_t trigram : collectTrigrams(padded(weights))) {
+		trigrams_[trigram].push_back(id);
+	}
+	if (weights.size() <= kShortNameLength) {
+		for (auto& variant : collectDeletions(weights, kShortMaxDistance)) {
+			deletions_[std::move(variant)].push_back(id);
+		}
+	}
+}
+
+// Перестраивает списки триграмм, выбрасывая удаленные записи
+void NameIndex::compact() {
+	std::vector<Entry> alive;
+	alive.reserve(byKey_.size());
+	trigrams_.clear();
+	deletions_.clear();
+
+	for (auto& item : byKey_) {
+		uint32_t oldId = item.second;
+		item.second = static_cast<uint32_t>(alive.size());
+		alive.push_back(std::move(entries_[oldId]));
+	}
+	entries_.swap(alive);
+	for (uint32_t id = 0; id < entries_.size(); ++id) {
+		indexTrigrams(id);
+	}
+	deadCount_ = 0;
+}
+
+// Возвращает до limit различных названий, начинающихся с текста
+std::vector<std::string> NameIndex::findByPrefix(const std::string& prefix, size_t limit) const {
+	std::vector<std::string> result;
+	const std::string weights = Collation::primaryWeights(prefix);
+
+	// Все ключи с общим префиксом первичных весов идут в словаре подряд
+	for (auto it = byKey_.lower_bound(weights); it != byKey_.end() && result.size() < limit; ++it) {
+		const Entry& entry = entries_[it->second];
+		std::string_view primary = primaryOf(entry.key, entry.name);
+		if (primary.size() < weights.size() || std::memcmp(primary.data(), weights.data(), weights.size()) != 0) {
+			break;
+		}
+		result.push_back(entry.name);
+	}
+	return result;
+}
+
+// Возвращает до limit различных названий, содержащих текст
+std::vector<std::string> NameIndex::findBySubstring(const std::string& fragment, size_t limit) const {
+	std::vector<std::string> result;
+	const std::string weights = Collation::primaryWeights(fragment);
+	if (limit == 0) return result;
+
+	// Короткий фрагмент: проверяем различные названия по порядку
+	if (weights.size() < 3) {
+		for (const auto& item : byKey_) {
+			const Entry& entry = entries_[item.second];
+			if (primaryOf(entry.key, entry.name).find(weights) != std::string_view::npos) {
+				result.push_back(entry.name);
+				if (result.size() == limit) break;
+			}
+		}
+		return result;
+	}
+
+	// Пересекаем списки триграмм, начиная с самого короткого
+	std::vector<const std::vector<uint32_t>*> lists;
+	for (uint32_t trigram : collectTrigrams(weights)) {
+		auto it = trigrams_.find(trigram);
+		if (it == trigrams_.end()) return result;
+		lists.push_back(&it->second);
+	}
+	std::sort(lists.begin(), lists.end(),
+		[](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) { return a->size() < b->size(); });
+
+	std::vector<uint32_t> candidates = *lists.front();
+	for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+		std::vector<uint32_t> next;
+		std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(),
+			std::back_inserter(next));
+		candidates.swap(next);
+	}
+
+	// Триграммы дают надмножество - проверяем вхождение и упорядочиваем по ключу
+	std::vector<const Entry*> matched;
+	for (uint32_t id : candidates) {
+		const Entry& entry = entries_[id];
+		if (entry.count > 0 && primaryOf(entry.key, entry.name).find(weights) != std::string_view::npos) {
+			matched.push_back(&entry);
+		}
+	}
+	std::sort(matched.begin(), matched.end(),
+		[](const Entry* a, const Entry* b) { return Collation::less(a->key, b->key); });
+
+	for (size_t i = 0; i < matched.size() && i < limit; ++i) {
+		result.push_back(matched[i]->name);
+	}
+	return result;
+}
+
+// Возвращает до limit названий на расстоянии редактирования не больше maxDistance
+std::vector<std::string> NameIndex::findSimilar(const std::string& text, size_t maxDistance, size_t limit) const {
+	std::vector<std::string> result;
+	const std::string weights = Collation::primaryWeights(text);
+	if (weights.empty() || limit == 0) return result;
+
+	// Каждая правка разрушает не более трех триграмм, поэтому у подходящего названия
+	// должно совпасть не меньше (число триграмм запроса - 3 * maxDistance) триграмм
+	const std::vector<uint32_t> queryTrigrams = collectTrigrams(padded(weights));
+	const long long threshold = static_cast<long long>(queryTrigrams.size()) - 3LL * static_cast<long long>(maxDistance);
+
+	std::vector<uint32_t> candidates;
+	if (threshold >= 1) {
+		std::unordered_map<uint32_t, uint32_t> hits;
+		for (uint32_t trigram : queryTrigrams) {
+			auto it = trigrams_.find(trigram);
+			if (it == trigrams_.end()) continue;
+			for (uint32_t id : it->second) hits[id]++;
+		}
+		for (const auto& hit : hits) {
+			if (hit.second >= threshold) candidates.push_back(hit.first);
+		}
+	}
+	else if (maxDistance <= kShortMaxDistance && weights.size() + maxDistance <= kShortNameLength) {
+		// Слишком короткий запрос для триграмм: подходящее название не длиннее weights.size() + maxDistance,
+		// поэтому кандидаты - короткие названия с общим вариантом удалений
+		for (const auto& variant : collectDeletions(weights, maxDistance)) {
+			auto it = deletions_.find(variant);
+			if (it == deletions_.end()) continue;
+			candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+		}
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+	}
+	else {
+		// Большое расстояние или повторяющиеся триграммы в запросе: проверяем различные названия
+		for (const auto& item : byKey_) candidates.push_back(item.second);
+	}
+
+	std::vector<std::pair<size_t, const Entry*>> matched;
+	for (uint32_t id : candidates) {
+		const Entry& entry = entries_[id];
+		if (entry.count == 0) continue;
+		size_t distance = boundedEditDistance(primaryOf(entry.key, entry.name), weights, maxDistance);
+		if (distance <= maxDistance) {
+			matched.emplace_back(distance, &entry);
+		}
+	}
+
+	// Сначала самые близкие, при равенстве - по алфавиту
+	std::sort(matched.begin(), matched.end(),
+		[](const std::pair<size_t, const Entry*>& a, const std::pair<size_t, const Entry*>& b) {
+		if (a.first != b.first) return a.first < b.first;
+		return Collation::less(a.second->key, b.second->key);
+	});
+
+	for (size_t i = 0; i < matched.size() && i < limit; ++i) {
+		result.push_back(matched[i].second->name);
+	}
+	return result;
+}
+
+// ==================== ПЛАНИРОВЩИК ЗАПРОСОВ ====================
+
+void NameIndex::appendRows(const std::string& key, const std::vector<Dish>& dishes, std::vector<size_t>& rows) {
+	auto first = std::lower_bound(dishes.begin(), dishes.end(), key,
+		[](const Dish& dish, const std::string& k) { return Collation::less(dish.sortKey, k); });
+	for (auto it = first; it != dishes.end() && it->sortKey == key; ++it) {
+		rows.push_back(static_cast<size_t>(it - dishes.begin()));
+	}
+}
+
+// Различных названий обычно намного меньше, чем строк: подходящие названия берутся из словаря
+// и триграмм, а их строки - двоичным поиском, без просмотра всего меню
+bool NameIndex::lookup(const DishPredicate& predicate, const std::vector<Dish>& dishes, std::vector<size_t>& rows) const {
+	std::vector<std::string> names;
+	switch (predicate.kind) {
+	case PredicateKind::NameEquals: {
+		auto it = byKey_.find(Collation::makeKey(predicate.text));
+		if (it != byKey_.end()) appendRows(it->first, dishes, rows);
+		return true;
+	}
+	case PredicateKind::NamePrefix:
+		names = findByPrefix(predicate.text, SIZE_MAX);
+		break;
+	case PredicateKind::NameContains:
+		names = findBySubstring(predicate.text, SIZE_MAX);
+		break;
+	default:
+		return false;
+	}
+
+	for (const auto& name : names) {
+		appendRows(Collation::makeKey(name), dishes, rows);
+	}
+	return true;
+}
\ No newline at end of file
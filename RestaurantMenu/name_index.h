@@ -0,0 +1,78 @@
+﻿#pragma once
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include "interfaces.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Индекс названий блюд для поиска по префиксу и подстроке без учета регистра.
+/// Префиксный поиск идет по упорядоченному словарю ключей сопоставления,
+/// поиск подстроки и нечеткий поиск - по триграммам первичных весов. Короткие запросы, для которых
+/// триграммы не отсекают кандидатов, ищутся по окрестностям удалений коротких названий. Обновляется инкрементально.
+/// Как индекс планировщика запросов обслуживает условия по названию для блюд, отсортированных по ключу сопоставления.
+class NameIndex : public IDishIndex {
+private:
+	/// Запись о различном названии
+	struct Entry {
+		std::string name;       ///< Исходное название
+		std::string key;        ///< Ключ сопоставления (см. Collation::makeKey)
+		size_t count;           ///< Количество блюд с этим названием (0 - запись удалена)
+	};
+
+	std::vector<Entry> entries_;                                        ///< Записи по идентификатору
+	std::map<std::string, uint32_t> byKey_;                             ///< Ключ сопоставления -> идентификатор
+	std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams_;      ///< Триграмма -> возрастающий список идентификаторов
+	std::unordered_map<std::string, std::vector<uint32_t>> deletions_;  ///< Короткое название без 0-2 символов -> идентификаторы
+	size_t deadCount_;                                                  ///< Количество удаленных записей в списках триграмм
+
+	/// Перестраивает списки триграмм, выбрасывая удаленные записи
+	void compact();
+
+	/// Добавляет идентификатор в списки всех триграмм названия, а короткое название - и в окрестность удалений
+	void indexTrigrams(uint32_t id);
+
+	/// Добавляет номера строк с ключом key двоичным поиском (dishes отсортирован по sortKey)
+	static void appendRows(const std::string& key, const std::vector<Dish>& dishes, std::vector<size_t>& rows);
+
+public:
+	NameIndex();
+
+	/// Учитывает блюдо с указанным названием
+	void add(const std::string& name);
+
+	/// Учитывает блюдо с готовым ключом сопоставления (Dish::sortKey)
+	void add(const std::string& name, const std::string& key);
+
+	/// Резервирует место еще под names названий (перед пакетной загрузкой)
+	void reserve(size_t names);
+
+	/// Убирает count блюд с указанным названием
+	void remove(const std::string& name, size_t count = 1);
+
+	/// Полностью очищает индекс
+	void clear();
+
+	/// Возвращает количество различных названий
+	size_t size() const;
+
+	/// Возвращает до limit различных названий, начинающихся с текста, в алфавитном порядке
+	std::vector<std::string> findByPrefix(const std::string& prefix, size_t limit) const;
+
+	/// Возвращает до limit различных названий, содержащих текст, в алфавитном порядке
+	std::vector<std::string> findBySubstring(const std::string& fragment, size_t limit) const;
+
+	/// Возвращает до limit названий, отличающихся от текста не более чем на maxDistance правок
+	/// (без учета регистра), от самых близких к дальним
+	std::vector<std::string> findSimilar(const std::string& text, size_t maxDistance, size_t limit) const;
+
+	/// Заполняет строки с названиями, подходящими под NameEquals, NamePrefix или NameContains: названия
+	/// находятся по индексу, строки - двоичным поиском. dishes - блюда, по которым построен индекс,
+	/// отсортированные по sortKey
+	bool lookup(const DishPredicate& predicate, const std::vector<Dish>& dishes, std::vector<size_t>& rows) const override;
+};
+
+#endif // NAME_INDEX_H
\ No newline at end of file
@@ -0,0 +1,35 @@
+﻿#include "output_buffer.h"
+
+// Конструктор с потоком назначения и порогом сброса в байтах
+OutputBuffer::OutputBuffer(std::ostream& sink, size_t flushThreshold)
+	: sink_(sink), flushThreshold_(flushThreshold) {
+	data_.reserve(flushThreshold_ < (1u << 16) ? flushThreshold_ : (1u << 16));
+}
+
+// Сбрасывает остаток буфера при уничтожении
+OutputBuffer::~OutputBuffer() {
+	flush();
+}
+
+// Запись одного символа через std::ostream
+OutputBuffer::int_type OutputBuffer::overflow(int_type ch) {
+	if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+		append(traits_type::to_char_type(ch));
+	}
+	return traits_type::not_eof(ch);
+}
+
+// Запись блока символов через std::ostream
+std::streamsize OutputBuffer::xsputn(const char* s, std::streamsize count) {
+	append(s, static_cast<size_t>(count));
+	return count;
+}
+
+// Записывает накопленный текст в поток одной операцией; емкость буфера сохраняется
+void OutputBuffer::flush() {
+	if (!data_.empty()) {
+		sink_.write(data_.data(), static_cast<std::streamsize>(data_.size()));
+		data_.clear();
+	}
+	sink_.flush();
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+﻿#pragma once
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+/// Растущий буфер вывода: текст накапливается в памяти и уходит в поток крупными блоками.
+/// Память буфера переиспользуется между выводами; сброс происходит при превышении порога
+/// и по явному вызову flush(). Может служить streambuf для std::ostream.
+class OutputBuffer : public std::streambuf {
+private:
+	std::string data_;          ///< Накопленный текст
+	std::ostream& sink_;        ///< Поток, в который сбрасывается буфер
+	size_t flushThreshold_;     ///< Размер, при достижении которого буфер сбрасывается
+
+	/// Сбрасывает буфер, если он превысил порог
+	void flushIfFull() {
+		if (data_.size() >= flushThreshold_) flush();
+	}
+
+protected:
+	/// Запись одного символа через std::ostream
+	int_type overflow(int_type ch) override;
+
+	/// Запись блока символов через std::ostream
+	std::streamsize xsputn(const char* s, std::streamsize count) override;
+
+public:
+	/// Конструктор с потоком назначения и порогом сброса в байтах
+	explicit OutputBuffer(std::ostream& sink, size_t flushThreshold = 1 << 20);
+
+	/// Сбрасывает остаток буфера при уничтожении
+	~OutputBuffer() override;
+
+	/// Добавляет байты
+	void append(const char* data, size_t size) {
+		data_.append(data, size);
+		flushIfFull();
+	}
+
+	/// Добавляет строку
+	void append(const std::string& text) {
+		append(text.data(), text.size());
+	}
+
+	/// Добавляет символ
+	void append(char ch) {
+		data_.push_back(ch);
+		flushIfFull();
+	}
+
+	/// Добавляет count одинаковых символов
+	void append(size_t count, char ch) {
+		data_.append(count, ch);
+		flushIfFull();
+	}
+
+	/// Записывает накопленный текст в поток одной операцией и сбрасывает поток
+	void flush();
+
+	/// Возвращает количество байт, ожидающих записи
+	size_t size() const { return data_.size(); }
+};
+
+#endif // OUTPUT_BUFFER_H
\ No newline at end of file
@@ -1,46 +1,179 @@
 ﻿#include "printer.h"
+#include "formatting.h"
+#include <algorithm>
+#include <cmath>
+
+// Конструктор: вывод копится в буфере и уходит в поток крупными блоками
+MenuPrinter::MenuPrinter(std::ostream& sink)
+	: buffer_(sink), out_(&buffer_) {}
 
 // Выводит все блюда меню с статистикой
 void MenuPrinter::printAllDishes(const std::vector<Dish>& dishes, int invalidCount) const {
-	std::cout << std::endl << "=== МЕНЮ РЕСТОРАНА ===" << std::endl;
+	out_ << '\n' << "=== МЕНЮ РЕСТОРАНА ===" << '\n';
 	printTableHeader();
 
 	// Вывод нумерованного списка блюд
-	for (size_t i = 0; i < dishes.size(); ++i) {
-		std::cout << std::setw(5) << std::right << (i + 1) << ". " << dishes[i] << std::endl;
-	}
+	printRows(dishes, 0, dishes.size(), 1);
 
 	// Вывод статистики
-	std::cout << std::endl << "СТАТИСТИКА:" << std::endl;
-	std::cout << "  Отсеяно невалидных блюд: " << invalidCount << std::endl;
-	std::cout << "  Валидных блюд: " << dishes.size() << std::endl;
+	out_ << '\n' << "СТАТИСТИКА:" << '\n';
+	out_ << "  Отсеяно невалидных блюд: " << invalidCount << '\n';
+	out_ << "  Валидных блюд: " << dishes.size() << '\n';
+	buffer_.flush();
 }
 
 // Выводит отфильтрованный список блюд
 void MenuPrinter::printFilteredDishes(const std::vector<Dish>& dishes, const std::string& title) const {
 	if (dishes.empty()) {
-		std::cout << std::endl << "Нет блюд, соответствующих критериям." << std::endl;
+		out_ << '\n' << "Нет блюд, соответствующих критериям." << '\n';
+		buffer_.flush();
 		return;
 	}
 
-	std::cout << std::endl << title << std::endl;
+	out_ << '\n' << title << '\n';
 	printTableHeader();
 
 	// Вывод нумерованного списка отфильтрованных блюд
-	for (size_t i = 0; i < dishes.size(); ++i) {
-		std::cout << std::setw(5) << std::right << (i + 1) << ". " << dishes[i] << std::endl;
+	printRows(dishes, 0, dishes.size(), 1);
+	buffer_.flush();
+}
+
+// Выводит одну страницу блюд: остальные строки не форматируются
+void MenuPrinter::printPage(const std::vector<Dish>& dishes, size_t page, size_t pageSize, const std::string& title) const {
+	printPageOf(dishes, 0, page, pageSize, dishes.size(), title);
+}
+
+// Выводит заранее отобранную страницу: rows начинается с первой строки страницы
+void MenuPrinter::printPageRows(const std::vector<Dish>& rows, size_t page, size_t pageSize, size_t total, const std::string& title) const {
+	pageSize = std::max<size_t>(1, pageSize);
+	printPageOf(rows, page > 0 ? (page - 1) * pageSize : 0, page, pageSize, total, title);
+}
+
+// Выводит страницу списка из total блюд, из которого в dishes есть строки начиная с offset
+void MenuPrinter::printPageOf(const std::vector<Dish>& dishes, size_t offset, size_t page, size_t pageSize,
+	size_t total, const std::string& title) const {
+	if (total == 0) {
+		out_ << '\n' << "Нет блюд, соответствующих критериям." << '\n';
+		buffer_.flush();
+		return;
+	}
+
+	pageSize = std::max<size_t>(1, pageSize);
+	const size_t pageCount = (total + pageSize - 1) / pageSize;
+	if (page == 0 || page > pageCount) {
+		out_ << '\n' << "Страница " << page << " не существует, всего страниц: " << pageCount << '\n';
+		buffer_.flush();
+		return;
+	}
+
+	const size_t first = (page - 1) * pageSize;
+	const size_t last = std::min(first + pageSize, total);
+	out_ << '\n' << title << '\n';
+	printTableHeader();
+	printRows(dishes, first - offset, std::min(last - offset, dishes.size()), first + 1);
+	out_ << '\n' << "Страница " << page << " из " << pageCount
+		<< " (блюда " << (first + 1) << "-" << last << " из " << total << ")";
+	if (page < pageCount) {
+		out_ << ", следующая: next";
+	}
+	out_ << '\n';
+	buffer_.flush();
+}
+
+// Форматирует цену с двумя знаками после запятой
+static std::string formatPrice(double price) {
+	std::string text;
+	DishFormat::appendPrice(text, price);
+	return text;
+}
+
+// Форматирует время в минутах как время приготовления
+static std::string formatMinutes(double minutes) {
+	std::string text;
+	DishFormat::appendTime(text, Time(0, static_cast<int>(std::llround(minutes))));
+	return text;
+}
+
+// Выводит агрегаты меню
+void MenuPrinter::printStats(const MenuStats& stats) const {
+	out_ << '\n' << "=== СТАТИСТИКА МЕНЮ ===" << '\n';
+	out_ << "  Блюд: " << stats.count() << '\n';
+	if (stats.count() == 0) {
+		buffer_.flush();
+		return;
+	}
+
+	// Таблица: строка заголовков, затем цена и время; колонки выравниваются по ширине на экране
+	const std::string table[3][7] = {
+		{ "", "Минимум", "Среднее", "Максимум", "Медиана", "90%", "99%" },
+		{ "Цена", formatPrice(stats.minPrice()), formatPrice(stats.meanPrice()), formatPrice(stats.maxPrice()),
+			formatPrice(stats.priceQuantile(0.5)), formatPrice(stats.priceQuantile(0.9)), formatPrice(stats.priceQuantile(0.99)) },
+		{ "Время", formatMinutes(static_cast<double>(stats.minMinutes())), formatMinutes(stats.meanMinutes()),
+			formatMinutes(static_cast<double>(stats.maxMinutes())), formatMinutes(stats.minutesQuantile(0.5)),
+			formatMinutes(stats.minutesQuantile(0.9)), formatMinutes(stats.minutesQuantile(0.99)) }
+	};
+	out_ << '\n';
+	for (const auto& cells : table) {
+		row_.clear();
+		DishFormat::appendPadded(row_, cells[0], 10);
+		for (size_t i = 1; i < 6; ++i) {
+			DishFormat::appendPadded(row_, cells[i], 12);
+		}
+		row_.append(cells[6]);
+		row_.push_back('\n');
+		buffer_.append(row_);
+	}
+
+	out_ << '\n' << "Распределение цен:" << '\n';
+	printHistogram(stats.priceHistogram(), formatPrice);
+	out_ << '\n' << "Распределение времени приготовления:" << '\n';
+	printHistogram(stats.timeHistogram(), formatMinutes);
+	buffer_.flush();
+}
+
+// Выводит гистограмму полосами, масштабированными по самой большой корзине
+void MenuPrinter::printHistogram(const FixedHistogram& histogram, std::string (*format)(double)) const {
+	const size_t barWidth = 30;
+	const auto& bounds = histogram.bounds();
+	const auto& counts = histogram.counts();
+	size_t maxCount = std::max<size_t>(1, *std::max_element(counts.begin(), counts.end()));
+
+	for (size_t i = 0; i < counts.size(); ++i) {
+		std::string label = i == 0 ? "< " + format(bounds[0])
+			: i == bounds.size() ? ">= " + format(bounds.back())
+			: format(bounds[i - 1]) + " - " + format(bounds[i]);
+		row_.assign("  ");
+		DishFormat::appendPadded(row_, label, 18);
+		DishFormat::appendRightAligned(row_, counts[i], 6);
+		row_.push_back(' ');
+		row_.append(counts[i] * barWidth / maxCount, '#');
+		row_.push_back('\n');
+		buffer_.append(row_);
 	}
 }
 
 // Выводит заголовок таблицы меню
 void MenuPrinter::printTableHeader() const {
-	// Заголовок таблицы с выравниванием
-	std::cout << std::setw(5) << std::right << "№"
-		<< " "
-		<< std::setw(25) << std::left << "Название блюда"
-		<< std::setw(10) << std::left << "Цена"
-		<< "Время приготовления" << std::endl;
+	// Заголовок таблицы с выравниванием по ширине на экране
+	row_.assign("    № ");
+	DishFormat::appendPadded(row_, "Название блюда", DishFormat::kNameWidth);
+	DishFormat::appendPadded(row_, "Цена", DishFormat::kPriceWidth);
+	row_.append("Время приготовления\n");
+	buffer_.append(row_);
 
 	// Разделительная линия
-	std::cout << std::string(60, '-') << std::endl;
+	buffer_.append(60, '-');
+	buffer_.append('\n');
+}
+
+// Выводит нумерованные строки блюд; строка-буфер переиспользуется, поэтому память не выделяется
+void MenuPrinter::printRows(const std::vector<Dish>& dishes, size_t first, size_t last, size_t number) const {
+	for (size_t i = first; i < last; ++i) {
+		row_.clear();
+		DishFormat::appendRightAligned(row_, number + (i - first), 5);
+		row_.append(". ");
+		DishFormat::appendRow(row_, dishes[i]);
+		row_.push_back('\n');
+		buffer_.append(row_);
+	}
 }
\ No newline at end of file
@@ -4,21 +4,50 @@
 
 #include "interfaces.h"
 #include "models.h"
+#include "menu_stats.h"
+#include "output_buffer.h"
 #include <iostream>
 #include <iomanip>
 
-/// Реализация вывода меню в табличном формате в консоль
+/// Реализация вывода меню в табличном формате в консоль.
+/// Строки форматируются в общий буфер и записываются в поток несколькими крупными блоками
 class MenuPrinter : public IMenuPrinter {
+private:
+	mutable OutputBuffer buffer_;   ///< Буфер вывода, переиспользуемый между вызовами
+	mutable std::ostream out_;      ///< Поток форматирования поверх буфера
+	mutable std::string row_;       ///< Переиспользуемая строка для форматирования одной строки вывода
+
 public:
+	/// Конструктор с потоком назначения (по умолчанию - консоль)
+	explicit MenuPrinter(std::ostream& sink = std::cout);
+
 	/// Выводит полное меню с заголовком и статистикой
 	void printAllDishes(const std::vector<Dish>& dishes, int invalidCount) const override;
 
 	/// Выводит отфильтрованные блюда с пользовательским заголовком
 	void printFilteredDishes(const std::vector<Dish>& dishes, const std::string& title) const override;
 
+	/// Выводит одну страницу блюд с нумерацией по всему списку
+	void printPage(const std::vector<Dish>& dishes, size_t page, size_t pageSize, const std::string& title) const override;
+
+	/// Выводит заранее отобранную страницу с нумерацией по всему списку из total блюд
+	void printPageRows(const std::vector<Dish>& rows, size_t page, size_t pageSize, size_t total, const std::string& title) const override;
+
+	/// Выводит агрегаты меню: сводку, квантили и гистограммы
+	void printStats(const MenuStats& stats) const override;
+
 private:
 	/// Вспомогательный метод для вывода заголовка таблицы
 	void printTableHeader() const;
+
+	/// Вспомогательный метод для вывода строк блюд из диапазона [first, last), number - номер первой строки
+	void printRows(const std::vector<Dish>& dishes, size_t first, size_t last, size_t number) const;
+
+	/// Выводит страницу списка из total блюд; dishes содержит строки списка, начиная с позиции offset
+	void printPageOf(const std::vector<Dish>& dishes, size_t offset, size_t page, size_t pageSize, size_t total, const std::string& title) const;
+
+	/// Вспомогательный метод для вывода гистограммы; format переводит границу корзины в текст
+	void printHistogram(const FixedHistogram& histogram, std::string (*format)(double)) const;
 };
 
 #endif // PRINTER_H
\ No newline at end of file
@@ -0,0 +1,519 @@
+﻿#include "query.h"
+#include "collation.h"
+#include "filter_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+// ==================== ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ ====================
+
+// Максимальная глубина стека вычисления, при которой используется быстрый путь без выделения памяти
+static const size_t kMaxStackDepth = 64;
+
+// Возвращает первичную часть ключа сопоставления блюда
+static std::string_view primaryPart(const Dish& dish) {
+	return std::string_view(dish.sortKey.data(), Collation::primaryLength(dish.sortKey, dish.name.size()));
+}
+
+// Проверяет, начинается ли название блюда с текста, заданного первичными весами
+static bool primaryStartsWith(const Dish& dish, const std::string& weights) {
+	std::string_view primary = primaryPart(dish);
+	return primary.size() >= weights.size() &&
+		std::memcmp(primary.data(), weights.data(), weights.size()) == 0;
+}
+
+// Проверяет, содержит ли название блюда текст, заданный первичными весами
+static bool primaryContains(const Dish& dish, const std::string& weights) {
+	return primaryPart(dish).find(weights) != std::string_view::npos;
+}
+
+// Проверяет простое (не логическое) условие; для условий по названию text - первичные веса
+static bool evaluateLeaf(PredicateKind kind, double minPrice, double maxPrice,
+	long long minMinutes, long long maxMinutes, const std::string& text, const Dish& dish) {
+	switch (kind) {
+	case PredicateKind::PriceRange:
+		return dish.price >= minPrice && dish.price < maxPrice;
+	case PredicateKind::TimeRange: {
+		long long minutes = dish.totalMinutes();
+		return minutes >= minMinutes && minutes < maxMinutes;
+	}
+	case PredicateKind::NameEquals:
+		return dish.name == text;
+	case PredicateKind::NamePrefix:
+		return primaryStartsWith(dish, text);
+	case PredicateKind::NameContains:
+		return primaryContains(dish, text);
+	default:
+		return false;
+	}
+}
+
+// Проверяет, является ли условие простым сравнением
+static bool isLeaf(const DishPredicate& predicate) {
+	return predicate.kind != PredicateKind::And && predicate.kind != PredicateKind::Or;
+}
+
+// Нормализует дерево условия: раскрывает вложенные связки одного вида,
+// сворачивает константы и объединяет диапазоны цены и времени внутри "И"
+static DishPredicate normalize(const DishPredicate& predicate) {
+	if (isLeaf(predicate)) return predicate;
+
+	const bool isAnd = predicate.kind == PredicateKind::And;
+	DishPredicate result;
+	result.kind = predicate.kind;
+
+	DishPredicate price;
+	price.kind = PredicateKind::PriceRange;
+	DishPredicate time;
+	time.kind = PredicateKind::TimeRange;
+	bool hasPrice = false;
+	bool hasTime = false;
+
+	// Раскрываем вложенные связки того же вида
+	std::vector<DishPredicate> operands;
+	for (const auto& child : predicate.children) {
+		DishPredicate normalized = normalize(child);
+
+		// Пустое "И" - истина, пустое "ИЛИ" - ложь
+		if (!isLeaf(normalized) && normalized.children.empty()) {
+			bool value = normalized.kind == PredicateKind::And;
+			if (value == isAnd) continue;     // нейтральный элемент
+			result.kind = value ? PredicateKind::And : PredicateKind::Or;
+			return result;                    // поглощающий элемент
+		}
+
+		if (normalized.kind == predicate.kind) {
+			for (auto& grandChild : normalized.children) {
+				operands.push_back(std::move(grandChild));
+			}
+		}
+		else {
+			operands.push_back(std::move(normalized));
+		}
+	}
+
+	for (auto& normalized : operands) {
+		if (isAnd && normalized.kind == PredicateKind::PriceRange) {
+			price.minPrice = std::max(price.minPrice, normalized.minPrice);
+			price.maxPrice = std::min(price.maxPrice, normalized.maxPrice);
+			hasPrice = true;
+		}
+		else if (isAnd && normalized.kind == PredicateKind::TimeRange) {
+			time.minMinutes = std::max(time.minMinutes, normalized.minMinutes);
+			time.maxMinutes = std::min(time.maxMinutes, normalized.maxMinutes);
+			hasTime = true;
+		}
+		else {
+			result.children.push_back(std::move(normalized));
+		}
+	}
+
+	// Объединенные диапазоны ставим первыми - они дешевле проверок по названию
+	if (hasTime) result.children.insert(result.children.begin(), time);
+	if (hasPrice) result.children.insert(result.children.begin(), price);
+
+	if (result.children.size() == 1) {
+		return result.children.front();
+	}
+	return result;
+}
+
+// Компилирует дерево в обратную польскую запись и возвращает глубину стека
+static size_t emit(const DishPredicate& predicate, std::vector<CompiledPredicate::Instruction>& program) {
+	CompiledPredicate::Instruction instruction{ predicate.kind, predicate.minPrice, predicate.maxPrice,
+		predicate.minMinutes, predicate.maxMinutes, std::string(), 0 };
+
+	if (isLeaf(predicate)) {
+		bool byWeights = predicate.kind == PredicateKind::NamePrefix || predicate.kind == PredicateKind::NameContains;
+		instruction.text = byWeights ? Collation::primaryWeights(predicate.text) : predicate.text;
+		program.push_back(std::move(instruction));
+		return 1;
+	}
+
+	size_t depth = 1;
+	for (size_t i = 0; i < predicate.children.size(); ++i) {
+		depth = std::max(depth, i + emit(predicate.children[i], program));
+	}
+	instruction.arity = predicate.children.size();
+	program.push_back(std::move(instruction));
+	return depth;
+}
+
+// Подбирает строки-кандидаты по индексам: для "И" - самый избирательный конъюнкт,
+// для "ИЛИ" - объединение, если индексом покрывается каждая ветвь.
+// Возвращает false, если условие требует полного просмотра.
+static bool planCandidates(const DishPredicate& predicate, const std::vector<Dish>& dishes,
+	const std::vector<const IDishIndex*>& indexes, std::vector<size_t>& rows) {
+	if (predicate.kind == PredicateKind::And) {
+		bool found = false;
+		for (const auto& child : predicate.children) {
+			std::vector<size_t> childRows;
+			if (planCandidates(child, dishes, indexes, childRows) && (!found || childRows.size() < rows.size())) {
+				rows = std::move(childRows);
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	if (predicate.kind == PredicateKind::Or) {
+		if (predicate.children.empty()) return false;
+		for (const auto& child : predicate.children) {
+			std::vector<size_t> childRows;
+			if (!planCandidates(child, dishes, indexes, childRows)) return false;
+			rows.insert(rows.end(), childRows.begin(), childRows.end());
+		}
+		return true;
+	}
+
+	bool found = false;
+	for (const IDishIndex* index : indexes) {
+		std::vector<size_t> indexRows;
+		if (index && index->lookup(predicate, dishes, indexRows) && (!found || indexRows.size() < rows.size())) {
+			rows = std::move(indexRows);
+			found = true;
+		}
+	}
+	return found;
+}
+
+// Отбирает строки по диапазонам цены и времени векторизованными ядрами над столбцами.
+// Применимо, если условие - диапазон или "И" с диапазонами; прочие конъюнкты попадают в residual.
+// Готовые столбцы stored используются, если они описывают те же строки; иначе нужные строятся здесь.
+static bool selectByColumns(const DishPredicate& root, const std::vector<Dish>& dishes, const MenuColumns* stored,
+	std::vector<size_t>& rows, DishPredicate& residual) {
+	if (dishes.size() > UINT32_MAX) return false;
+
+	std::vector<const DishPredicate*> conjuncts;
+	if (root.kind == PredicateKind::And) {
+		for (const auto& child : root.children) conjuncts.push_back(&child);
+	}
+	else {
+		conjuncts.push_back(&root);
+	}
+
+	const DishPredicate* price = nullptr;
+	const DishPredicate* time = nullptr;
+	residual = DishPredicate::any();
+	for (const DishPredicate* conjunct : conjuncts) {
+		if (conjunct->kind == PredicateKind::PriceRange && !price) price = conjunct;
+		else if (conjunct->kind == PredicateKind::TimeRange && !time) time = conjunct;
+		else residual.children.push_back(*conjunct);
+	}
+	if (!price && !time) return false;
+
+	MenuColumns built;
+	if (!stored || stored->size() != dishes.size()) {
+		built = MenuColumns::build(dishes, price != nullptr, time != nullptr);
+		stored = &built;
+	}
+	const MenuColumns& columns = *stored;
+	std::vector<uint32_t> selection(dishes.size() + FilterKernels::kSelectionSlack);
+	size_t count = 0;
+
+	if (price) {
+		count = FilterKernels::selectRange(columns.prices.data(), dishes.size(),
+			price->minPrice, price->maxPrice, selection.data());
+	}
+	if (time) {
+		// Время блюда помещается в int32_t, поэтому границы можно безопасно сузить
+		int32_t minMinutes = static_cast<int32_t>(std::max<long long>(time->minMinutes, INT32_MIN));
+		int32_t maxMinutes = static_cast<int32_t>(std::min<long long>(time->maxMinutes, INT32_MAX));
+		count = price
+			? FilterKernels::refineRange(columns.minutes.data(), selection.data(), count, minMinutes, maxMinutes, selection.data())
+			: FilterKernels::selectRange(columns.minutes.data(), dishes.size(), minMinutes, maxMinutes, selection.data());
+	}
+
+	rows.assign(selection.begin(), selection.begin() + count);
+	return true;
+}
+
+// ==================== DISH PREDICATE ====================
+
+DishPredicate DishPredicate::any() {
+	return DishPredicate();
+}
+
+DishPredicate DishPredicate::priceBelow(double maxPrice) {
+	DishPredicate predicate;
+	predicate.kind = PredicateKind::PriceRange;
+	predicate.maxPrice = maxPrice;
+	return predicate;
+}
+
+DishPredicate DishPredicate::priceBetween(double minPrice, double maxPrice) {
+	DishPredicate predicate = priceBelow(maxPrice);
+	predicate.minPrice = minPrice;
+	return predicate;
+}
+
+DishPredicate DishPredicate::priceAbove(double minPrice) {
+	DishPredicate predicate;
+	predicate.kind = PredicateKind::PriceRange;
+	predicate.minPrice = std::nextafter(minPrice, std::numeric_limits<double>::infinity());
+	return predicate;
+}
+
+DishPredicate DishPredicate::timeBelow(const Time& maxTime) {
+	DishPredicate predicate;
+	predicate.kind = PredicateKind::TimeRange;
+	predicate.maxMinutes = maxTime.totalMinutes();
+	return predicate;
+}
+
+DishPredicate DishPredicate::timeBetween(const Time& minTime, const Time& maxTime) {
+	DishPredicate predicate = timeBelow(maxTime);
+	predicate.minMinutes = minTime.totalMinutes();
+	return predicate;
+}
+
+DishPredicate DishPredicate::timeAbove(const Time& minTime) {
+	DishPredicate predicate;
+	predicate.kind = PredicateKind::TimeRange;
+	predicate.minMinutes = minTime.totalMinutes() + 1;
+	return predicate;
+}
+
+DishPredicate DishPredicate::nameEquals(const std::string& name) {
+	DishPredicate predicate;
+	predicate.kind = PredicateKind::NameEquals;
+	predicate.text = name;
+	return predicate;
+}
+
+DishPredicate DishPredicate::namePrefix(const std::string& prefix) {
+	DishPredicate predicate = nameEquals(prefix);
+	predicate.kind = PredicateKind::NamePrefix;
+	return predicate;
+}
+
+DishPredicate DishPredicate::nameContains(const std::string& fragment) {
+	DishPredicate predicate = nameEquals(fragment);
+	predicate.kind = PredicateKind::NameContains;
+	return predicate;
+}
+
+bool DishPredicate::matches(const Dish& dish) const {
+	switch (kind) {
+	case PredicateKind::And:
+		return std::all_of(children.begin(), children.end(),
+			[&](const DishPredicate& child) { return child.matches(dish); });
+	case PredicateKind::Or:
+		return std::any_of(children.begin(), children.end(),
+			[&](const DishPredicate& child) { return child.matches(dish); });
+	case PredicateKind::NamePrefix:
+	case PredicateKind::NameContains:
+		return evaluateLeaf(kind, minPrice, maxPrice, minMinutes, maxMinutes, Collation::primaryWeights(text), dish);
+	default:
+		return evaluateLeaf(kind, minPrice, maxPrice, minMinutes, maxMinutes, text, dish);
+	}
+}
+
+DishPredicate operator&&(DishPredicate lhs, DishPredicate rhs) {
+	DishPredicate predicate;
+	predicate.kind = PredicateKind::And;
+	predicate.children.push_back(std::move(lhs));
+	predicate.children.push_back(std::move(rhs));
+	return predicate;
+}
+
+DishPredicate operator||(DishPredicate lhs, DishPredicate rhs) {
+	DishPredicate predicate;
+	predicate.kind = PredicateKind::Or;
+	predicate.children.push_back(std::move(lhs));
+	predicate.children.push_back(std::move(rhs));
+	return predicate;
+}
+
+// ==================== COMPILED PREDICATE ====================
+
+CompiledPredicate::CompiledPredicate(const DishPredicate& predicate)
+	: conjunctive_(false)
+	, normalized_(normalize(predicate)) {
+	size_t depth = emit(normalized_, program_);
+
+	// Конъюнкция простых условий проверяется без стека с ранним выходом
+	conjunctive_ = isLeaf(normalized_) ||
+		(normalized_.kind == PredicateKind::And &&
+			std::all_of(normalized_.children.begin(), normalized_.children.end(), isLeaf));
+	if (conjunctive_ && !isLeaf(normalized_)) {
+		program_.pop_back();
+	}
+
+	// Слишком глубокие деревья вычисляются рекурсивно
+	if (!conjunctive_ && depth > kMaxStackDepth) {
+		program_.clear();
+	}
+}
+
+bool CompiledPredicate::matches(const Dish& dish) const {
+	if (conjunctive_) {
+		for (const auto& in : program_) {
+			if (!evaluateLeaf(in.kind, in.minPrice, in.maxPrice, in.minMinutes, in.maxMinutes, in.text, dish)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	if (program_.empty()) {
+		return normalized_.matches(dish);
+	}
+
+	bool stack[kMaxStackDepth];
+	size_t top = 0;
+	for (const auto& in : program_) {
+		if (in.kind == PredicateKind::And || in.kind == PredicateKind::Or) {
+			bool isAnd = in.kind == PredicateKind::And;
+			bool value = isAnd;
+			for (size_t i = top - in.arity; i < top; ++i) {
+				value = isAnd ? (value && stack[i]) : (value || stack[i]);
+			}
+			top -= in.arity;
+			stack[top++] = value;
+		}
+		else {
+			stack[top++] = evaluateLeaf(in.kind, in.minPrice, in.maxPrice, in.minMinutes, in.maxMinutes, in.text, dish);
+		}
+	}
+	return stack[0];
+}
+
+// ==================== MENU QUERY ====================
+
+MenuQuery::MenuQuery() : where_(DishPredicate::any()), order_(QueryOrder::None), limit_(0) {}
+
+MenuQuery& MenuQuery::where(const DishPredicate& predicate) {
+	where_ = predicate;
+	return *this;
+}
+
+MenuQuery& MenuQuery::orderBy(QueryOrder order) {
+	order_ = order;
+	return *this;
+}
+
+MenuQuery& MenuQuery::limit(size_t count) {
+	limit_ = count;
+	return *this;
+}
+
+// Возвращает номера подходящих строк с учетом плана, порядка и ограничения
+std::vector<size_t> MenuQuery::selectRows(const std::vector<Dish>& dishes,
+	const std::vector<const IDishIndex*>& indexes, const MenuColumns* columns) const {
+	CompiledPredicate compiled(where_);
+	const DishPredicate& root = compiled.normalized();
+
+	// Планировщик: кандидаты по индексам, если условие ими покрывается
+	std::vector<size_t> candidates;
+	bool useCandidates = !indexes.empty() && planCandidates(root, dishes, indexes, candidates);
+	if (useCandidates) {
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+	}
+
+	// Иначе диапазоны цены и времени отбираются SIMD-ядрами, остальное проверяется по кандидатам
+	const CompiledPredicate* check = &compiled;
+	std::unique_ptr<CompiledPredicate> residualCheck;
+	if (!useCandidates) {
+		DishPredicate residual;
+		if (selectByColumns(root, dishes, columns, candidates, residual)) {
+			residualCheck = std::make_unique<CompiledPredicate>(residual);
+			check = residualCheck.get();
+			useCandidates = true;
+		}
+	}
+
+	// Единый проход: проверка условия, при LIMIT без ORDER BY - ранний выход
+	const bool stopEarly = limit_ > 0 && order_ == QueryOrder::None;
+	std::vector<size_t> result;
+	const size_t total = useCandidates ? candidates.size() : dishes.size();
+	for (size_t i = 0; i < total; ++i) {
+		size_t row = useCandidates ? candidates[i] : i;
+		if (check->matches(dishes[row])) {
+			result.push_back(row);
+			if (stopEarly && result.size() == limit_) break;
+		}
+	}
+
+	if (order_ != QueryOrder::None) {
+		auto less = [&](size_t a, size_t b) {
+			const Dish& x = dishes[a];
+			const Dish& y = dishes[b];
+			switch (order_) {
+			case QueryOrder::Name:
+				if (Collation::less(x.sortKey, y.sortKey)) return true;
+				if (Collation::less(y.sortKey, x.sortKey)) return false;
+				break;
+			case QueryOrder::PriceDesc:
+				if (x.price != y.price) return x.price > y.price;
+				break;
+			case QueryOrder::TimeAsc: {
+				long long xm = x.totalMinutes();
+				long long ym = y.totalMinutes();
+				if (xm != ym) return xm < ym;
+				break;
+			}
+			default:
+				break;
+			}
+			return a < b;
+		};
+
+		if (limit_ > 0 && limit_ < result.size()) {
+			std::partial_sort(result.begin(), result.begin() + limit_, result.end(), less);
+		}
+		else {
+			std::sort(result.begin(), result.end(), less);
+		}
+	}
+
+	if (limit_ > 0 && result.size() > limit_) {
+		result.resize(limit_);
+	}
+	return result;
+}
+
+// Выполняет запрос и возвращает копии подходящих блюд
+std::vector<Dish> MenuQuery::execute(const std::vector<Dish>& dishes,
+	const std::vector<const IDishIndex*>& indexes, const MenuColumns* columns) const {
+	std::vector<size_t> rows = selectRows(dishes, indexes, columns);
+	std::vector<Dish> result;
+	result.reserve(rows.size());
+	for (size_t row : rows) {
+		result.push_back(dishes[row]);
+	}
+	return result;
+}
+
+// ==================== SORTED NAME INDEX ====================
+
+// Возвращает диапазон строк с подходящими названиями двоичным поиском по ключам сопоставления
+bool SortedNameIndex::lookup(const DishPredicate& predicate, const std::vector<Dish>& dishes, std::vector<size_t>& rows) const {
+	if (predicate.kind == PredicateKind::NameEquals) {
+		const std::string key = Collation::makeKey(predicate.text);
+		auto first = std::lower_bound(dishes.begin(), dishes.end(), key,
+			[](const Dish& dish, const std::string& k) { return Collation::less(dish.sortKey, k); });
+		for (auto it = first; it != dishes.end() && it->sortKey == key; ++it) {
+			rows.push_back(static_cast<size_t>(it - dishes.begin()));
+		}
+		return true;
+	}
+
+	if (predicate.kind == PredicateKind::NamePrefix) {
+		const std::string weights = Collation::primaryWeights(predicate.text);
+		if (weights.empty()) return false;
+
+		auto first = std::lower_bound(dishes.begin(), dishes.end(), weights,
+			[](const Dish& dish, const std::string& w) { return Collation::less(dish.sortKey, w); });
+		for (auto it = first; it != dishes.end() && primaryStartsWith(*it, weights); ++it) {
+			rows.push_back(static_cast<size_t>(it - dishes.begin()));
+		}
+		return true;
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+﻿#pragma once
+#ifndef QUERY_H
+#define QUERY_H
+
+#include "interfaces.h"
+#include "models.h"
+#include <limits>
+#include <string>
+#include <vector>
+
+/// Вид условия запроса
+enum class PredicateKind {
+	PriceRange,     ///< minPrice <= цена < maxPrice
+	TimeRange,      ///< minMinutes <= время (в минутах) < maxMinutes
+	NameEquals,     ///< Точное совпадение названия
+	NamePrefix,     ///< Название начинается с текста (без учета регистра)
+	NameContains,   ///< Название содержит текст (без учета регистра)
+	And,            ///< Выполнены все вложенные условия
+	Or              ///< Выполнено хотя бы одно вложенное условие
+};
+
+/// Условие запроса к меню: простое сравнение или логическая связка вложенных условий
+struct DishPredicate {
+	PredicateKind kind = PredicateKind::And;
+	double minPrice = -std::numeric_limits<double>::infinity();
+	double maxPrice = std::numeric_limits<double>::infinity();
+	long long minMinutes = std::numeric_limits<long long>::min();
+	long long maxMinutes = std::numeric_limits<long long>::max();
+	std::string text;                       ///< Текст для условий по названию
+	std::vector<DishPredicate> children;    ///< Вложенные условия для And/Or
+
+	/// Условие, которому удовлетворяет любое блюдо
+	static DishPredicate any();
+
+	/// Цена строго меньше maxPrice
+	static DishPredicate priceBelow(double maxPrice);
+
+	/// Цена в полуинтервале [minPrice, maxPrice)
+	static DishPredicate priceBetween(double minPrice, double maxPrice);
+
+	/// Цена строго больше minPrice
+	static DishPredicate priceAbove(double minPrice);
+
+	/// Время приготовления строго меньше maxTime
+	static DishPredicate timeBelow(const Time& maxTime);
+
+	/// Время приготовления в полуинтервале [minTime, maxTime)
+	static DishPredicate timeBetween(const Time& minTime, const Time& maxTime);
+
+	/// Время приготовления строго больше minTime
+	static DishPredicate timeAbove(const Time& minTime);
+
+	/// Название совпадает с текстом
+	static DishPredicate nameEquals(const std::string& name);
+
+	/// Название начинается с текста
+	static DishPredicate namePrefix(const std::string& prefix);
+
+	/// Название содержит текст
+	static DishPredicate nameContains(const std::string& fragment);
+
+	/// Проверяет условие для одного блюда (эталонная, неоптимизированная проверка)
+	bool matches(const Dish& dish) const;
+};
+
+/// Логическое "И" двух условий
+DishPredicate operator&&(DishPredicate lhs, DishPredicate rhs);
+
+/// Логическое "ИЛИ" двух условий
+DishPredicate operator||(DishPredicate lhs, DishPredicate rhs);
+
+/// Порядок результатов запроса
+enum class QueryOrder {
+	None,       ///< Порядок исходных данных
+	Name,       ///< По алфавиту (ключ сопоставления)
+	PriceDesc,  ///< По убыванию цены
+	TimeAsc     ///< По возрастанию времени приготовления
+};
+
+/// Условие, скомпилированное в плоскую программу для вычисления за один проход
+class CompiledPredicate {
+public:
+	/// Инструкция программы в обратной польской записи
+	struct Instruction {
+		PredicateKind kind;
+		double minPrice;
+		double maxPrice;
+		long long minMinutes;
+		long long maxMinutes;
+		std::string text;       ///< Для NamePrefix/NameContains - первичные веса текста
+		size_t arity;           ///< Для And/Or - число операндов на стеке
+	};
+
+private:
+	std::vector<Instruction> program_;  ///< Инструкции в обратной польской записи
+	bool conjunctive_;                  ///< Программа - конъюнкция простых условий (быстрый путь)
+	DishPredicate normalized_;          ///< Нормализованное дерево условия
+
+public:
+	/// Нормализует условие (раскрывает вложенные связки, объединяет диапазоны) и компилирует его
+	explicit CompiledPredicate(const DishPredicate& predicate);
+
+	/// Проверяет условие для блюда
+	bool matches(const Dish& dish) const;
+
+	/// Возвращает нормализованное дерево условия (для планировщика)
+	const DishPredicate& normalized() const { return normalized_; }
+};
+
+/// Запрос к меню: условие WHERE, порядок ORDER BY и ограничение LIMIT
+class MenuQuery {
+private:
+	DishPredicate where_;           ///< Условие отбора
+	QueryOrder order_;              ///< Порядок результатов
+	size_t limit_;                  ///< Максимальное число результатов (0 - без ограничения)
+
+public:
+	MenuQuery();
+
+	/// Задает условие отбора
+	MenuQuery& where(const DishPredicate& predicate);
+
+	/// Задает порядок результатов
+	MenuQuery& orderBy(QueryOrder order);
+
+	/// Ограничивает число результатов
+	MenuQuery& limit(size_t count);
+
+	/// Возвращает номера подходящих строк; индексы используются вместо полного просмотра, если применимы.
+	/// columns - готовые столбцы цен и времени тех же строк (например, хранилища); без них столбцы строятся на время запроса
+	std::vector<size_t> selectRows(const std::vector<Dish>& dishes,
+		const std::vector<const IDishIndex*>& indexes = {}, const MenuColumns* columns = nullptr) const;
+
+	/// Выполняет запрос и возвращает копии подходящих блюд
+	std::vector<Dish> execute(const std::vector<Dish>& dishes,
+		const std::vector<const IDishIndex*>& indexes = {}, const MenuColumns* columns = nullptr) const;
+};
+
+/// Индекс по названию для меню, отсортированного по ключам сопоставления.
+/// Обслуживает NameEquals и NamePrefix двоичным поиском вместо полного просмотра.
+class SortedNameIndex : public IDishIndex {
+public:
+	/// Возвращает диапазон строк с подходящими названиями (dishes должен быть отсортирован по sortKey)
+	bool lookup(const DishPredicate& predicate, const std::vector<Dish>& dishes, std::vector<size_t>& rows) const override;
+};
+
+#endif // QUERY_H
\ No newline at end of file
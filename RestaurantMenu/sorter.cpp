@@ -0,0 +1,22 @@
+﻿#include "sorter.h"
+
+// Возвращает все зарегистрированные порядки
+const std::vector<SorterRegistry::Entry>& SorterRegistry::entries() {
+	static const std::vector<Entry> registry = {
+		{ "name",       "по алфавиту",                            &Sorter<ByName<Asc>>::sort },
+		{ "name-desc",  "по алфавиту в обратном порядке",         &Sorter<ByName<Desc>>::sort },
+		{ "price",      "по убыванию цены, затем по алфавиту",    &Sorter<ByPrice<Desc>, ByName<Asc>>::sort },
+		{ "price-asc",  "по возрастанию цены, затем по алфавиту", &Sorter<ByPrice<Asc>, ByName<Asc>>::sort },
+		{ "time",       "по времени, затем по алфавиту",          &Sorter<ByTime<Asc>, ByName<Asc>>::sort },
+		{ "time-price", "по времени, затем по возрастанию цены",  &Sorter<ByTime<Asc>, ByPrice<Asc>, ByName<Asc>>::sort },
+	};
+	return registry;
+}
+
+// Возвращает функцию сортировки по имени
+SorterRegistry::SortFunction SorterRegistry::find(const std::string& name) {
+	for (const auto& entry : entries()) {
+		if (name == entry.name) return entry.sort;
+	}
+	return nullptr;
+}
\ No newline at end of file
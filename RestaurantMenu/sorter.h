@@ -0,0 +1,103 @@
+﻿#pragma once
+#ifndef SORTER_H
+#define SORTER_H
+
+#include "collation.h"
+#include "models.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/// Направление сортировки по возрастанию
+struct Asc {
+	static int apply(int cmp) { return cmp; }
+};
+
+/// Направление сортировки по убыванию
+struct Desc {
+	static int apply(int cmp) { return -cmp; }
+};
+
+/// Ключ сортировки по названию (по ключу сопоставления, см. Collation::makeKey)
+template <typename Order = Asc>
+struct ByName {
+	static int compare(const Dish& a, const Dish& b) {
+		return Order::apply(Collation::compare(a.sortKey, b.sortKey));
+	}
+};
+
+/// Ключ сортировки по цене
+template <typename Order = Asc>
+struct ByPrice {
+	static int compare(const Dish& a, const Dish& b) {
+		return Order::apply((a.price > b.price) - (a.price < b.price));
+	}
+};
+
+/// Ключ сортировки по времени приготовления
+template <typename Order = Asc>
+struct ByTime {
+	/// Общее время в минутах через встраиваемые геттеры (та же формула, что в Time::totalMinutes)
+	static long long minutesOf(const Time& time) {
+		return ((static_cast<long long>(time.getYears()) * 31LL + time.getDays()) * 24LL + time.getHours()) * 60LL +
+			time.getMinutes();
+	}
+
+	static int compare(const Dish& a, const Dish& b) {
+		long long x = minutesOf(a.time);
+		long long y = minutesOf(b.time);
+		return Order::apply((x > y) - (x < y));
+	}
+};
+
+/// Сортировщик по набору ключей, составленному на этапе компиляции.
+/// Например, Sorter<ByPrice<Desc>, ByName<Asc>> - по убыванию цены, при равной цене по алфавиту.
+/// Компаратор - обычная структура без состояния, поэтому весь каскад ключей встраивается в std::sort.
+template <typename... Keys>
+class Sorter {
+	static_assert(sizeof...(Keys) > 0, "Sorter requires at least one key");
+
+public:
+	/// Сравнивает блюда по ключам по порядку до первого различия
+	static int compare(const Dish& a, const Dish& b) {
+		int cmp = 0;
+		// Свертка по || останавливается на первом ключе, различающем блюда
+		(void)((cmp = Keys::compare(a, b), cmp != 0) || ...);
+		return cmp;
+	}
+
+	/// Компаратор "меньше" для стандартных алгоритмов
+	struct Less {
+		bool operator()(const Dish& a, const Dish& b) const {
+			return compare(a, b) < 0;
+		}
+	};
+
+	/// Сортирует блюда
+	static void sort(std::vector<Dish>& dishes) {
+		std::sort(dishes.begin(), dishes.end(), Less());
+	}
+};
+
+/// Реестр готовых сортировщиков для выбора порядка во время работы программы.
+/// Выбор происходит один раз на сортировку; внутренний цикл остается без косвенных вызовов.
+class SorterRegistry {
+public:
+	/// Функция сортировки конкретного экземпляра Sorter
+	using SortFunction = void (*)(std::vector<Dish>&);
+
+	/// Зарегистрированный порядок сортировки
+	struct Entry {
+		const char* name;           ///< Имя порядка для команд
+		const char* description;    ///< Описание для справки
+		SortFunction sort;          ///< Функция сортировки
+	};
+
+	/// Возвращает все зарегистрированные порядки
+	static const std::vector<Entry>& entries();
+
+	/// Возвращает функцию сортировки по имени или nullptr, если порядок не найден
+	static SortFunction find(const std::string& name);
+};
+
+#endif // SORTER_H
\ No newline at end of file
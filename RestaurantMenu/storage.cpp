@@ -1,74 +1,198 @@
 ﻿#include "storage.h"
+#include "collation.h"
+#include "formatting.h"
+#include "menu_files.h"
+#include "query.h"
+#include "sorter.h"
 #include <algorithm>
 #include <cmath>
 #include <fstream>
-#include <iomanip>
+#include <iterator>
 
 // ==================== MENU SORTER ====================
 
-// Сортирует блюда по алфавиту (A-Z)
+// Сортирует блюда по алфавиту (A-Z, А-Я) по заранее вычисленным ключам сопоставления
 void MenuSorter::sortAlphabetically(std::vector<Dish>& dishes) const {
-	std::sort(dishes.begin(), dishes.end(),
-		[](const Dish& a, const Dish& b) { return a.name < b.name; });
+	Sorter<ByName<Asc>>::sort(dishes);
 }
 
-// Сортирует блюда по убыванию цены
+// Сортирует блюда по убыванию цены, при равной цене - по алфавиту
 void MenuSorter::sortByPriceDesc(std::vector<Dish>& dishes) const {
-	std::sort(dishes.begin(), dishes.end(),
-		[](const Dish& a, const Dish& b) { return a.price > b.price; });
+	Sorter<ByPrice<Desc>, ByName<Asc>>::sort(dishes);
 }
 
-// Сортирует блюда по возрастанию времени приготовления
+// Сортирует блюда по возрастанию времени приготовления, при равном времени - по алфавиту
 void MenuSorter::sortByTimeAsc(std::vector<Dish>& dishes) const {
-	std::sort(dishes.begin(), dishes.end(),
-		[](const Dish& a, const Dish& b) { return a.time < b.time; });
+	Sorter<ByTime<Asc>, ByName<Asc>>::sort(dishes);
 }
 
 // ==================== MENU FILTER ====================
 
-// Конструктор с инъекцией зависимости сортировщика
-MenuFilter::MenuFilter(std::unique_ptr<IMenuSorter> sorter)
-	: sorter_(std::move(sorter)) {}
+// Конструктор с инъекцией зависимости сортировщика и хранилища
+MenuFilter::MenuFilter(std::unique_ptr<IMenuSorter> sorter, const IMenuStorage* storage)
+	: sorter_(std::move(sorter)), storage_(storage) {}
+
+// Возвращает столбцы хранилища, если фильтруются его блюда; иначе запрос построит столбцы сам
+const MenuColumns* MenuFilter::columnsFor(const std::vector<Dish>& dishes) const {
+	return storage_ && &dishes == &storage_->getDishes() ? &storage_->getColumns() : nullptr;
+}
+
+// Индексы хранилища описывают только его строки, для чужих блюд запрос обходится без них
+std::vector<const IDishIndex*> MenuFilter::indexesFor(const std::vector<Dish>& dishes) const {
+	return storage_ && &dishes == &storage_->getDishes() ? storage_->getIndexes() : std::vector<const IDishIndex*>();
+}
 
 // Фильтрует блюда по цене и сортирует по убыванию цены
 std::vector<Dish> MenuFilter::filterByPrice(const std::vector<Dish>& dishes, double maxPrice) const {
-	std::vector<Dish> result;
-	for (const auto& dish : dishes) {
-		if (dish.price < maxPrice) result.push_back(dish);
-	}
+	std::vector<Dish> result = MenuQuery().where(DishPredicate::priceBelow(maxPrice)).execute(dishes, indexesFor(dishes), columnsFor(dishes));
 	sorter_->sortByPriceDesc(result);
 	return result;
 }
 
 // Фильтрует блюда по времени и сортирует по возрастанию времени
 std::vector<Dish> MenuFilter::filterByTime(const std::vector<Dish>& dishes, const Time& maxTime) const {
-	std::vector<Dish> result;
-	long long maxTotalMinutes = maxTime.totalMinutes();
-	for (const auto& dish : dishes) {
-		if (dish.totalMinutes() < maxTotalMinutes) result.push_back(dish);
-	}
+	std::vector<Dish> result = MenuQuery().where(DishPredicate::timeBelow(maxTime)).execute(dishes, indexesFor(dishes), columnsFor(dishes));
 	sorter_->sortByTimeAsc(result);
 	return result;
 }
 
 // Фильтрует блюда по цене и времени, сортирует по алфавиту
 std::vector<Dish> MenuFilter::filterByPriceAndTime(const std::vector<Dish>& dishes, double maxPrice, const Time& maxTime) const {
-	std::vector<Dish> result;
-	long long maxTotalMinutes = maxTime.totalMinutes();
-	for (const auto& dish : dishes) {
-		if (dish.price < maxPrice && dish.totalMinutes() < maxTotalMinutes) {
-			result.push_back(dish);
+	std::vector<Dish> result = MenuQuery()
+		.where(DishPredicate::priceBelow(maxPrice) && DishPredicate::timeBelow(maxTime))
+		.execute(dishes, indexesFor(dishes), columnsFor(dishes));
+	sorter_->sortAlphabetically(result);
+	return result;
+}
+
+// ==================== CACHED MENU FILTER ====================
+
+// Виды фильтров в ключе кэша
+enum CachedFilterKind { kByPrice, kByTime, kByPriceAndTime };
+
+// Конструктор: оборачивает фильтр и следит за изменениями указанного хранилища
+CachedMenuFilter::CachedMenuFilter(std::unique_ptr<IMenuFilter> inner, const IMenuStorage& storage, size_t capacity)
+	: inner_(std::move(inner)), storage_(storage), capacity_(capacity), clock_(0), hits_(0), misses_(0) {}
+
+// Фильтрует блюда по цене (через кэш)
+std::vector<Dish> CachedMenuFilter::filterByPrice(const std::vector<Dish>& dishes, double maxPrice) const {
+	return lookup(CacheKey(kByPrice, maxPrice, 0), dishes, DishPredicate::priceBelow(maxPrice),
+		[&] { return inner_->filterByPrice(dishes, maxPrice); });
+}
+
+// Фильтрует блюда по времени (через кэш)
+std::vector<Dish> CachedMenuFilter::filterByTime(const std::vector<Dish>& dishes, const Time& maxTime) const {
+	return lookup(CacheKey(kByTime, 0.0, maxTime.totalMinutes()), dishes, DishPredicate::timeBelow(maxTime),
+		[&] { return inner_->filterByTime(dishes, maxTime); });
+}
+
+// Фильтрует блюда по цене и времени (через кэш)
+std::vector<Dish> CachedMenuFilter::filterByPriceAndTime(const std::vector<Dish>& dishes, double maxPrice, const Time& maxTime) const {
+	return lookup(CacheKey(kByPriceAndTime, maxPrice, maxTime.totalMinutes()), dishes,
+		DishPredicate::priceBelow(maxPrice) && DishPredicate::timeBelow(maxTime),
+		[&] { return inner_->filterByPriceAndTime(dishes, maxPrice, maxTime); });
+}
+
+// Проверяет, остался ли результат записи верным после изменений хранилища
+bool CachedMenuFilter::isStillValid(CacheEntry& entry) const {
+	uint64_t current = storage_.getVersion();
+	if (entry.version == current) return true;
+
+	std::vector<Dish> changed;
+	if (!storage_.getChangesSince(entry.version, changed)) return false;
+	for (const auto& dish : changed) {
+		if (entry.predicate.matches(dish)) return false;
+	}
+	// Изменения не затронули результат - переносим запись на текущую версию
+	entry.version = current;
+	return true;
+}
+
+// Возвращает результат из кэша или вычисляет его через compute
+std::vector<Dish> CachedMenuFilter::lookup(const CacheKey& key, const std::vector<Dish>& dishes, const DishPredicate& predicate,
+	const std::function<std::vector<Dish>()>& compute) const {
+	// Кэш действует только для содержимого отслеживаемого хранилища
+	if (&dishes != &storage_.getDishes()) {
+		return compute();
+	}
+
+	auto it = entries_.find(key);
+	if (it != entries_.end() && isStillValid(it->second)) {
+		hits_++;
+		it->second.lastUsed = ++clock_;
+		return it->second.result;
+	}
+
+	misses_++;
+	std::vector<Dish> result = compute();
+	if (it == entries_.end()) {
+		if (entries_.size() >= capacity_) {
+			// Вытесняем запись, к которой дольше всего не обращались
+			auto oldest = std::min_element(entries_.begin(), entries_.end(),
+				[](const std::pair<const CacheKey, CacheEntry>& a, const std::pair<const CacheKey, CacheEntry>& b) {
+				return a.second.lastUsed < b.second.lastUsed;
+			});
+			if (oldest != entries_.end()) entries_.erase(oldest);
 		}
+		if (capacity_ == 0) return result;
+		it = entries_.emplace(key, CacheEntry{ predicate, 0, 0, {} }).first;
 	}
-	sorter_->sortAlphabetically(result);
+	it->second.version = storage_.getVersion();
+	it->second.lastUsed = ++clock_;
+	it->second.result = result;
 	return result;
 }
 
 // ==================== MENU STORAGE ====================
 
+// Максимальное количество изменений в журнале хранилища; столько изменений
+// может накопиться между разностными сохранениями, не вынуждая полную запись
+static const size_t kJournalCapacity = 1 << 16;
+
+MenuStorage::MenuStorage() : version_(0), journalBase_(0), sortedRows_(0) {}
+
+// Записывает изменение в журнал и увеличивает версию
+void MenuStorage::recordChange(const Dish& dish, bool added) {
+	journal_.push_back(JournalEntry{ ++version_, dish, added });
+	if (journal_.size() > kJournalCapacity) {
+		journalBase_ = journal_.front().version;
+		journal_.pop_front();
+	}
+}
+
 // Добавляет блюдо в контейнер
 void MenuStorage::addDish(const std::string& name, double price, const Time& time) {
 	dishes_.emplace_back(name, price, time);
+	nameIndex_.add(name);
+	columns_.add(dishes_.back());
+	recordChange(dishes_.back(), true);
+	stats_.add(dishes_.back());
+	for (auto& view : views_) {
+		view.second.onAdded(dishes_.back());
+	}
+}
+
+// Добавляет блюда пакетом: ключи сопоставления берутся из блюд, журнал сбрасывается вместо записи каждого блюда
+void MenuStorage::addDishes(std::vector<Dish> dishes) {
+	if (dishes.empty()) return;
+
+	const size_t first = dishes_.size();
+	dishes_.reserve(first + dishes.size());
+	columns_.prices.reserve(first + dishes.size());
+	columns_.minutes.reserve(first + dishes.size());
+	nameIndex_.reserve(dishes.size());
+	std::move(dishes.begin(), dishes.end(), std::back_inserter(dishes_));
+	for (size_t i = first; i < dishes_.size(); ++i) {
+		const Dish& dish = dishes_[i];
+		nameIndex_.add(dish.name, dish.sortKey);
+		columns_.add(dish);
+		for (auto& view : views_) {
+			view.second.onAdded(dish);
+		}
+	}
+	stats_.addAll(dishes_, first);
+	journal_.clear();
+	journalBase_ = ++version_;
 }
 
 // Возвращает константную ссылку на вектор блюд
@@ -84,41 +208,263 @@ size_t MenuStorage::getDishesCount() const {
 // Полностью очищает хранилище
 void MenuStorage::clear() {
 	dishes_.clear();
+	nameIndex_.clear();
+	columns_.resize(0);
+	sortedRows_ = 0;
+	// Очистка затрагивает все блюда: журнал начинается заново
+	journal_.clear();
+	journalBase_ = ++version_;
+	stats_.clear();
+	for (auto& view : views_) {
+		view.second.clear();
+	}
 }
 
 // Удаляет конкретное блюдо по точному совпадению всех параметров
 bool MenuStorage::removeDish(const std::string& name, double price, const Time& time) {
 	const double epsilon = 0.001;
 
-	size_t initialSize = dishes_.size();
-
-	// Используем публичные методы для сравнения
-	dishes_.erase(
-		std::remove_if(dishes_.begin(), dishes_.end(),
-			[&](const Dish& dish) {
-		// Сравниваем по имени, цене и полному времени
+	// Сравниваем по имени, цене и полному времени
+	auto matches = [&](const Dish& dish) {
 		return dish.name == name &&
 			std::fabs(dish.price - price) < epsilon &&
 			dish.time == time; // Используем оператор == для Time
-	}),
-		dishes_.end()
-		);
+	};
+
+	// Удаленные блюда попадают в журнал изменений
+	std::vector<Dish> removed;
+	for (const auto& dish : dishes_) {
+		if (matches(dish)) removed.push_back(dish);
+	}
+	if (removed.empty()) return false;
 
-	return dishes_.size() < initialSize;
+	// Уплотнение переносит строки блюд и столбцов вместе
+	size_t kept = 0;
+	size_t sortedRemoved = 0;
+	for (size_t i = 0; i < dishes_.size(); ++i) {
+		if (matches(dishes_[i])) {
+			if (i < sortedRows_) sortedRemoved++;
+			continue;
+		}
+		if (kept != i) {
+			dishes_[kept] = std::move(dishes_[i]);
+			columns_.moveRow(i, kept);
+		}
+		kept++;
+	}
+	dishes_.erase(dishes_.begin() + kept, dishes_.end());
+	columns_.resize(kept);
+	sortedRows_ -= sortedRemoved;
+	nameIndex_.remove(name, removed.size());
+	for (const auto& dish : removed) {
+		recordChange(dish, false);
+		stats_.remove(dish);
+		for (auto& view : views_) {
+			view.second.onRemoved(dish);
+		}
+	}
+	return true;
 }
 
-// Сохраняет все блюда в файл
+// Применяет пакет изменений: удаляемые блюда вычеркиваются из индексов при уплотнении вектора,
+// добавленные сортируются отдельно и сливаются с остальными - O(n + k log k) вместо сортировки на каждое добавление
+size_t MenuStorage::applyBatch(std::vector<Dish> added, const std::function<bool(const Dish&)>& removes) {
+	sortByName();
+	size_t kept = dishes_.size();
+	if (removes) {
+		kept = 0;
+		for (size_t i = 0; i < dishes_.size(); ++i) {
+			const Dish& dish = dishes_[i];
+			if (removes(dish)) {
+				nameIndex_.remove(dish.name);
+				recordChange(dish, false);
+				stats_.remove(dish);
+				for (auto& view : views_) {
+					view.second.onRemoved(dish);
+				}
+				continue;
+			}
+			if (kept != i) dishes_[kept] = std::move(dishes_[i]);
+			kept++;
+		}
+	}
+	const size_t removedCount = dishes_.size() - kept;
+	dishes_.erase(dishes_.begin() + kept, dishes_.end());
+
+	Sorter<ByName<Asc>>::sort(added);
+	dishes_.reserve(kept + added.size());
+	for (auto& dish : added) {
+		nameIndex_.add(dish.name);
+		recordChange(dish, true);
+		stats_.add(dish);
+		for (auto& view : views_) {
+			view.second.onAdded(dish);
+		}
+		dishes_.push_back(std::move(dish));
+	}
+	std::inplace_merge(dishes_.begin(), dishes_.begin() + kept, dishes_.end(), Sorter<ByName<Asc>>::Less());
+	// Слияние переставляет строки: столбцы заполняются заново тем же линейным проходом
+	columns_ = MenuColumns::build(dishes_, true, true);
+	sortedRows_ = dishes_.size();
+	return removedCount;
+}
+
+// Упорядочивает блюда по алфавиту: досортировывается только хвост, добавленный после прошлого упорядочивания,
+// и сливается с началом. Одно добавленное блюдо переносится на место сдвигом вместе со строками столбцов
+void MenuStorage::sortByName() {
+	Sorter<ByName<Asc>>::Less less;
+	// Уже упорядоченный хвост (например, блюда упорядоченного снимка) продолжает начало без сортировки
+	auto tail = std::is_sorted_until(dishes_.begin() + (sortedRows_ > 0 ? sortedRows_ - 1 : 0), dishes_.end(), less);
+	sortedRows_ = dishes_.size();
+	if (tail == dishes_.end()) return;
+
+	if (dishes_.end() - tail == 1) {
+		auto position = std::upper_bound(dishes_.begin(), tail, *tail, less);
+		size_t row = position - dishes_.begin();
+		std::rotate(position, tail, dishes_.end());
+		std::rotate(columns_.prices.begin() + row, columns_.prices.end() - 1, columns_.prices.end());
+		std::rotate(columns_.minutes.begin() + row, columns_.minutes.end() - 1, columns_.minutes.end());
+		return;
+	}
+
+	std::sort(tail, dishes_.end(), less);
+	std::inplace_merge(dishes_.begin(), tail, dishes_.end(), less);
+	columns_ = MenuColumns::build(dishes_, true, true);
+}
+
+// Сохраняет все блюда в файл атомарно: при сбое остается прежнее содержимое файла
 void MenuStorage::saveToFile(const std::string& filename) const {
-	std::ofstream file(filename);
-	if (!file.is_open()) {
-		throw std::runtime_error("Не удалось открыть файл для сохранения: " + filename);
+	MenuTextFile::save(dishes_, filename);
+}
+
+// Возвращает различные названия с указанным префиксом
+std::vector<std::string> MenuStorage::findNamesByPrefix(const std::string& prefix, size_t limit) const {
+	return nameIndex_.findByPrefix(prefix, limit);
+}
+
+// Возвращает различные названия, содержащие фрагмент
+std::vector<std::string> MenuStorage::findNamesBySubstring(const std::string& fragment, size_t limit) const {
+	return nameIndex_.findBySubstring(fragment, limit);
+}
+
+// Возвращает названия, похожие на текст с учетом опечаток
+std::vector<std::string> MenuStorage::findSimilarNames(const std::string& text, size_t maxDistance, size_t limit) const {
+	return nameIndex_.findSimilar(text, maxDistance, limit);
+}
+
+// Возвращает версию содержимого
+uint64_t MenuStorage::getVersion() const {
+	return version_;
+}
+
+// Собирает блюда, добавленные или удаленные после версии
+bool MenuStorage::getChangesSince(uint64_t version, std::vector<Dish>& changed) const {
+	if (version < journalBase_) return false;
+
+	// Версии в журнале возрастают - пропускаем уже учтенные изменения с конца
+	auto it = journal_.end();
+	while (it != journal_.begin() && std::prev(it)->version > version) --it;
+	for (; it != journal_.end(); ++it) {
+		changed.push_back(it->dish);
 	}
+	return true;
+}
 
-	for (const auto& dish : dishes_) {
-		file << "\"" << dish.name << "\" "
-			<< std::fixed << std::setprecision(2) << dish.price << " "
-			<< dish.getTimeString() << std::endl;
+// Собирает итоговые добавления и удаления: удаление сокращает более раннее добавление того же блюда
+bool MenuStorage::getChangeSetSince(uint64_t version, std::vector<Dish>& added, std::vector<Dish>& removed) const {
+	if (version < journalBase_) return false;
+
+	auto it = journal_.end();
+	while (it != journal_.begin() && std::prev(it)->version > version) --it;
+
+	// Добавления в порядке журнала; удаленные позже отмечаются пустыми
+	std::vector<const Dish*> addedDishes;
+	std::multimap<std::string, size_t> addedByName;
+	for (; it != journal_.end(); ++it) {
+		const Dish& dish = it->dish;
+		if (it->added) {
+			addedByName.emplace(dish.name, addedDishes.size());
+			addedDishes.push_back(&dish);
+			continue;
+		}
+
+		bool cancelled = false;
+		auto range = addedByName.equal_range(dish.name);
+		for (auto match = range.first; match != range.second; ++match) {
+			const Dish* candidate = addedDishes[match->second];
+			if (candidate->price == dish.price && candidate->time == dish.time) {
+				addedDishes[match->second] = nullptr;
+				addedByName.erase(match);
+				cancelled = true;
+				break;
+			}
+		}
+		if (!cancelled) removed.push_back(dish);
+	}
+
+	for (const Dish* dish : addedDishes) {
+		if (dish != nullptr) added.push_back(*dish);
+	}
+	return true;
+}
+
+// Создает или заменяет представление, заполняя его один раз по текущему меню
+void MenuStorage::defineView(const std::string& name, const DishPredicate& predicate) {
+	views_.erase(name);
+	views_.emplace(name, MaterializedView(name, predicate, dishes_));
+}
+
+// Удаляет представление
+bool MenuStorage::dropView(const std::string& name) {
+	return views_.erase(name) > 0;
+}
+
+// Возвращает строки представления
+bool MenuStorage::getView(const std::string& name, std::vector<Dish>& rows) const {
+	auto it = views_.find(name);
+	if (it == views_.end()) return false;
+	rows = it->second.getRows();
+	return true;
+}
+
+// Возвращает количество строк представления
+bool MenuStorage::getViewSize(const std::string& name, size_t& size) const {
+	auto it = views_.find(name);
+	if (it == views_.end()) return false;
+	size = it->second.size();
+	return true;
+}
+
+// Возвращает страницу строк представления
+bool MenuStorage::getViewRows(const std::string& name, size_t offset, size_t count, std::vector<Dish>& rows) const {
+	auto it = views_.find(name);
+	if (it == views_.end()) return false;
+	rows.clear();
+	it->second.getRows(offset, count, rows);
+	return true;
+}
+
+// Возвращает имена всех представлений
+std::vector<std::string> MenuStorage::getViewNames() const {
+	std::vector<std::string> names;
+	for (const auto& view : views_) {
+		names.push_back(view.first);
 	}
+	return names;
+}
+
+// Возвращает агрегаты меню
+const MenuStats& MenuStorage::getStats() const {
+	return stats_;
+}
+
+// Возвращает столбцы цен и времени
+const MenuColumns& MenuStorage::getColumns() const {
+	return columns_;
+}
 
-	file.close();
+// Индекс названий находит строки двоичным поиском, поэтому годится только для отсортированного меню
+std::vector<const IDishIndex*> MenuStorage::getIndexes() const {
+	if (sortedRows_ < dishes_.size()) return {};
+	return { &nameIndex_ };
 }
\ No newline at end of file
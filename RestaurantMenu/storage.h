@@ -2,9 +2,19 @@
 #ifndef STORAGE_H
 #define STORAGE_H
 
+#include "filter_kernels.h"
 #include "interfaces.h"
+#include "menu_stats.h"
 #include "models.h"
+#include "name_index.h"
+#include "query.h"
+#include "views.h"
+#include <deque>
+#include <functional>
+#include <map>
 #include <memory>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 /// Реализация алгоритмов сортировки меню
@@ -24,10 +34,17 @@ public:
 class MenuFilter : public IMenuFilter {
 private:
 	std::unique_ptr<IMenuSorter> sorter_;   ///< Сортировщик для упорядочивания результатов
+	const IMenuStorage* storage_;           ///< Хранилище, чьи столбцы используются при фильтрации его блюд (может отсутствовать)
+
+	/// Возвращает столбцы хранилища, если dishes - его блюда
+	const MenuColumns* columnsFor(const std::vector<Dish>& dishes) const;
+
+	/// Возвращает индексы хранилища, если dishes - его блюда
+	std::vector<const IDishIndex*> indexesFor(const std::vector<Dish>& dishes) const;
 
 public:
-	/// Конструктор с инъекцией зависимости сортировщика
-	MenuFilter(std::unique_ptr<IMenuSorter> sorter);
+	/// Конструктор с инъекцией зависимости сортировщика и, при наличии, хранилища
+	MenuFilter(std::unique_ptr<IMenuSorter> sorter, const IMenuStorage* storage = nullptr);
 
 	/// Фильтрует блюда по цене и сортирует по убыванию цены
 	std::vector<Dish> filterByPrice(const std::vector<Dish>& dishes, double maxPrice) const override;
@@ -39,15 +56,92 @@ public:
 	std::vector<Dish> filterByPriceAndTime(const std::vector<Dish>& dishes, double maxPrice, const Time& maxTime) const override;
 };
 
+/// Декоратор фильтра с кэшем результатов, привязанным к версии хранилища.
+/// Ключ - нормализованные параметры фильтра; после изменений хранилища запись сбрасывается,
+/// только если добавленные или удаленные блюда подходят под ее условие.
+class CachedMenuFilter : public IMenuFilter {
+private:
+	/// Вид фильтра, нормализованная цена и время в минутах
+	using CacheKey = std::tuple<int, double, long long>;
+
+	/// Закэшированный результат
+	struct CacheEntry {
+		DishPredicate predicate;    ///< Условие фильтра для проверки изменений
+		uint64_t version;           ///< Версия хранилища, для которой результат актуален
+		uint64_t lastUsed;          ///< Момент последнего обращения (для вытеснения)
+		std::vector<Dish> result;   ///< Отфильтрованные и отсортированные блюда
+	};
+
+	std::unique_ptr<IMenuFilter> inner_;                    ///< Фильтр, выполняющий запросы при промахе
+	const IMenuStorage& storage_;                           ///< Хранилище, за версией которого следит кэш
+	size_t capacity_;                                       ///< Максимальное количество записей
+	mutable std::map<CacheKey, CacheEntry> entries_;        ///< Записи кэша
+	mutable uint64_t clock_;                                ///< Счетчик обращений
+	mutable size_t hits_;                                   ///< Количество попаданий
+	mutable size_t misses_;                                 ///< Количество промахов
+
+	/// Возвращает результат из кэша или вычисляет его через compute
+	std::vector<Dish> lookup(const CacheKey& key, const std::vector<Dish>& dishes, const DishPredicate& predicate,
+		const std::function<std::vector<Dish>()>& compute) const;
+
+	/// Проверяет, остался ли результат записи верным после изменений хранилища
+	bool isStillValid(CacheEntry& entry) const;
+
+public:
+	/// Конструктор: оборачивает фильтр и следит за изменениями указанного хранилища
+	CachedMenuFilter(std::unique_ptr<IMenuFilter> inner, const IMenuStorage& storage, size_t capacity = 64);
+
+	/// Фильтрует блюда по цене (через кэш)
+	std::vector<Dish> filterByPrice(const std::vector<Dish>& dishes, double maxPrice) const override;
+
+	/// Фильтрует блюда по времени (через кэш)
+	std::vector<Dish> filterByTime(const std::vector<Dish>& dishes, const Time& maxTime) const override;
+
+	/// Фильтрует блюда по цене и времени (через кэш)
+	std::vector<Dish> filterByPriceAndTime(const std::vector<Dish>& dishes, double maxPrice, const Time& maxTime) const override;
+
+	/// Возвращает количество попаданий в кэш
+	size_t hits() const { return hits_; }
+
+	/// Возвращает количество промахов кэша
+	size_t misses() const { return misses_; }
+
+	/// Возвращает количество записей в кэше
+	size_t size() const { return entries_.size(); }
+};
+
 /// Контейнер для хранения блюд меню с возможностью сохранения в файл
 class MenuStorage : public IMenuStorage {
 private:
 	std::vector<Dish> dishes_;  ///< Вектор для хранения блюд
+	NameIndex nameIndex_;       ///< Индекс названий для поиска по префиксу и подстроке
+	uint64_t version_;          ///< Версия содержимого
+	uint64_t journalBase_;      ///< Журнал содержит все изменения после этой версии
+	/// Запись журнала: версия, блюдо и вид изменения
+	struct JournalEntry {
+		uint64_t version;
+		Dish dish;
+		bool added;             ///< true - блюдо добавлено, false - удалено
+	};
+
+	std::deque<JournalEntry> journal_; ///< Последние изменения
+	std::map<std::string, MaterializedView> views_; ///< Именованные представления
+	MenuStats stats_;           ///< Агрегаты меню
+	MenuColumns columns_;       ///< Столбцы цен и времени в порядке dishes_
+	size_t sortedRows_;         ///< Длина начала dishes_, упорядоченного по алфавиту
+
+	/// Записывает изменение в журнал и увеличивает версию
+	void recordChange(const Dish& dish, bool added);
 
 public:
+	MenuStorage();
+
 	/// Добавляет блюдо в контейнер
 	void addDish(const std::string& name, double price, const Time& time) override;
 
+	/// Добавляет блюда пакетом без журнала изменений
+	void addDishes(std::vector<Dish> dishes) override;
+
 	/// Возвращает константную ссылку на вектор блюд
 	const std::vector<Dish>& getDishes() const override;
 
@@ -60,8 +154,59 @@ public:
 	/// Удаляет конкретное блюдо по точному совпадению всех параметров
 	bool removeDish(const std::string& name, double price, const Time& time) override;
 
-	/// Сохраняет все блюда в файл в формате "Название" цена время
+	/// Удаляет блюда по условию и вливает добавленные за один проход
+	size_t applyBatch(std::vector<Dish> added, const std::function<bool(const Dish&)>& removes) override;
+
+	/// Упорядочивает блюда по алфавиту, сливая отсортированное начало с досортированным хвостом
+	void sortByName() override;
+
+	/// Сохраняет все блюда в файл в формате "Название" цена ч:мм
 	void saveToFile(const std::string& filename) const override;
+
+	/// Возвращает различные названия с указанным префиксом
+	std::vector<std::string> findNamesByPrefix(const std::string& prefix, size_t limit) const override;
+
+	/// Возвращает различные названия, содержащие фрагмент
+	std::vector<std::string> findNamesBySubstring(const std::string& fragment, size_t limit) const override;
+
+	/// Возвращает названия, похожие на текст с учетом опечаток
+	std::vector<std::string> findSimilarNames(const std::string& text, size_t maxDistance, size_t limit) const override;
+
+	/// Возвращает версию содержимого
+	uint64_t getVersion() const override;
+
+	/// Собирает блюда, добавленные или удаленные после версии
+	bool getChangesSince(uint64_t version, std::vector<Dish>& changed) const override;
+
+	/// Собирает итоговые добавления и удаления после версии
+	bool getChangeSetSince(uint64_t version, std::vector<Dish>& added, std::vector<Dish>& removed) const override;
+
+	/// Создает или заменяет представление
+	void defineView(const std::string& name, const DishPredicate& predicate) override;
+
+	/// Удаляет представление
+	bool dropView(const std::string& name) override;
+
+	/// Возвращает строки представления
+	bool getView(const std::string& name, std::vector<Dish>& rows) const override;
+
+	/// Возвращает количество строк представления
+	bool getViewSize(const std::string& name, size_t& size) const override;
+
+	/// Возвращает страницу строк представления
+	bool getViewRows(const std::string& name, size_t offset, size_t count, std::vector<Dish>& rows) const override;
+
+	/// Возвращает имена всех представлений
+	std::vector<std::string> getViewNames() const override;
+
+	/// Возвращает агрегаты меню
+	const MenuStats& getStats() const override;
+
+	/// Возвращает столбцы цен и времени
+	const MenuColumns& getColumns() const override;
+
+	/// Возвращает индекс названий, если меню отсортировано
+	std::vector<const IDishIndex*> getIndexes() const override;
 };
 
 #endif // STORAGE_H
\ No newline at end of file
@@ -0,0 +1,54 @@
+﻿#include "views.h"
+#include <iterator>
+
+// Создает представление и заполняет его по текущему содержимому меню
+MaterializedView::MaterializedView(const std::string& name, const DishPredicate& predicate, const std::vector<Dish>& dishes)
+	: name_(name), predicate_(predicate) {
+	for (const auto& dish : dishes) {
+		onAdded(dish);
+	}
+}
+
+// Учитывает добавленное блюдо
+void MaterializedView::onAdded(const Dish& dish) {
+	if (predicate_.matches(dish)) {
+		rows_.insert(dish);
+	}
+}
+
+// Учитывает удаленное блюдо: убирается ровно одна равная строка
+void MaterializedView::onRemoved(const Dish& dish) {
+	if (!predicate_.matches(dish)) return;
+
+	auto it = rows_.find(dish);
+	if (it != rows_.end()) {
+		rows_.erase(it);
+	}
+}
+
+// Очищает строки представления
+void MaterializedView::clear() {
+	rows_.clear();
+}
+
+// Возвращает строки представления по порядку
+std::vector<Dish> MaterializedView::getRows() const {
+	return std::vector<Dish>(rows_.begin(), rows_.end());
+}
+
+// Возвращает страницу строк представления
+void MaterializedView::getRows(size_t offset, size_t count, std::vector<Dish>& rows) const {
+	if (offset >= rows_.size()) return;
+	auto it = rows_.begin();
+	// Со стороны конца дерева к дальним страницам ближе
+	if (offset > rows_.size() / 2) {
+		it = rows_.end();
+		std::advance(it, -static_cast<std::ptrdiff_t>(rows_.size() - offset));
+	}
+	else {
+		std::advance(it, offset);
+	}
+	for (; it != rows_.end() && count > 0; ++it, --count) {
+		rows.push_back(*it);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+﻿#pragma once
+#ifndef VIEWS_H
+#define VIEWS_H
+
+#include "models.h"
+#include "query.h"
+#include "sorter.h"
+#include <set>
+#include <string>
+#include <vector>
+
+/// Материализованное представление: именованный фильтр, результат которого хранится постоянно
+/// и обновляется приращениями при каждом добавлении и удалении блюда (O(log n) на изменение)
+class MaterializedView {
+private:
+	/// Порядок строк представления: по алфавиту, затем по цене и времени
+	using RowOrder = Sorter<ByName<Asc>, ByPrice<Asc>, ByTime<Asc>>::Less;
+
+	std::string name_;                      ///< Имя представления
+	CompiledPredicate predicate_;           ///< Условие отбора
+	std::multiset<Dish, RowOrder> rows_;    ///< Блюда, удовлетворяющие условию
+
+public:
+	/// Создает представление и заполняет его по текущему содержимому меню
+	MaterializedView(const std::string& name, const DishPredicate& predicate, const std::vector<Dish>& dishes);
+
+	/// Учитывает добавленное блюдо
+	void onAdded(const Dish& dish);
+
+	/// Учитывает удаленное блюдо
+	void onRemoved(const Dish& dish);
+
+	/// Очищает строки представления (условие сохраняется)
+	void clear();
+
+	/// Возвращает имя представления
+	const std::string& getName() const { return name_; }
+
+	/// Возвращает количество строк
+	size_t size() const { return rows_.size(); }
+
+	/// Возвращает строки представления по порядку
+	std::vector<Dish> getRows() const;
+
+	/// Добавляет в rows не более count строк, начиная с offset; проход по дереву без копирования пропущенных строк
+	void getRows(size_t offset, size_t count, std::vector<Dish>& rows) const;
+};
+
+#endif // VIEWS_H
\ No newline at end of file
@@ -0,0 +1,304 @@
+﻿#include "write_ahead_log.h"
+#include "menu_files.h"
+#include "menu_snapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+// Размер заголовка записи: длина тела и контрольная сумма
+static const size_t kRecordHeaderSize = sizeof(uint32_t) + sizeof(uint64_t);
+// Размер тела без названия: тип, цена, минуты, длина названия
+static const size_t kRecordFixedSize = sizeof(uint8_t) + sizeof(double) + sizeof(int64_t) + sizeof(uint32_t);
+
+// Путь файла поколения: base.snap.N или base.wal.N
+static std::string generationPath(const std::string& base, const char* kind, uint64_t generation) {
+	return base + kind + std::to_string(generation);
+}
+
+// Возвращает отсортированные номера поколений, для которых есть файлы base + kind + N
+static std::vector<uint64_t> listGenerations(const std::string& base, const char* kind) {
+	namespace fs = std::filesystem;
+	fs::path basePath(base);
+	fs::path directory = basePath.has_parent_path() ? basePath.parent_path() : fs::path(".");
+	const std::string prefix = basePath.filename().string() + kind;
+
+	std::vector<uint64_t> generations;
+	std::error_code error;
+	for (fs::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+		std::string name = it->path().filename().string();
+		if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) continue;
+		std::string suffix = name.substr(prefix.size());
+		if (suffix.size() > 18 || !std::all_of(suffix.begin(), suffix.end(), [](char c) { return c >= '0' && c <= '9'; })) continue;
+		generations.push_back(std::stoull(suffix));
+	}
+	std::sort(generations.begin(), generations.end());
+	return generations;
+}
+
+// Удаляет снимки и журналы поколений младше generation
+static void removeGenerationsBefore(const std::string& base, uint64_t generation) {
+	for (const char* kind : { ".snap.", ".wal." }) {
+		for (uint64_t old : listGenerations(base, kind)) {
+			if (old < generation) std::remove(generationPath(base, kind, old).c_str());
+		}
+	}
+}
+
+// ==================== WRITE AHEAD LOG ====================
+
+// Применяет записи одного журнала; возвращает false, если встретилась оборванная или поврежденная запись
+bool WriteAheadLog::replayFile(const std::string& path, IMenuStorage& storage, size_t& replayed) {
+	std::ifstream file(path, std::ios::binary);
+	std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return replayRecords(data.data(), data.size(), storage, replayed);
+}
+
+// Применяет записи из памяти по одной, проверяя длину и контрольную сумму каждой
+bool WriteAheadLog::replayRecords(const char* data, size_t size, IMenuStorage& storage, size_t& replayed) {
+	size_t offset = 0;
+	while (offset < size) {
+		if (size - offset < kRecordHeaderSize) return false;
+		uint32_t length;
+		uint64_t checksum;
+		std::memcpy(&length, data + offset, sizeof(length));
+		std::memcpy(&checksum, data + offset + sizeof(length), sizeof(checksum));
+		const char* body = data + offset + kRecordHeaderSize;
+		if (length < kRecordFixedSize || size - offset - kRecordHeaderSize < length ||
+			MenuSnapshot::checksum(body, length) != checksum) {
+			return false;
+		}
+
+		uint8_t type;
+		double price;
+		int64_t minutes;
+		uint32_t nameLength;
+		std::memcpy(&type, body, sizeof(type));
+		std::memcpy(&price, body + 1, sizeof(price));
+		std::memcpy(&minutes, body + 1 + sizeof(price), sizeof(minutes));
+		std::memcpy(&nameLength, body + 1 + sizeof(price) + sizeof(minutes), sizeof(nameLength));
+		if (nameLength != length - kRecordFixedSize) return false;
+		std::string name(body + kRecordFixedSize, nameLength);
+		Time time = MenuSnapshot::timeFromMinutes(minutes);
+
+		switch (static_cast<WalRecordType>(type)) {
+		case WalRecordType::Add:
+			storage.addDish(name, price, time);
+			break;
+		case WalRecordType::Remove:
+			storage.removeDish(name, price, time);
+			break;
+		case WalRecordType::RemoveName: {
+			std::vector<std::pair<double, Time>> variants;
+			for (const auto& dish : storage.getDishes()) {
+				if (dish.name == name) variants.emplace_back(dish.price, dish.time);
+			}
+			for (const auto& variant : variants) storage.removeDish(name, variant.first, variant.second);
+			break;
+		}
+		default:
+			return false;
+		}
+		replayed++;
+		offset += kRecordHeaderSize + length;
+	}
+	return true;
+}
+
+void WriteAheadLog::encodeRecord(std::string& out, WalRecordType type, const std::string& name, double price, long long minutes) {
+	const uint32_t length = static_cast<uint32_t>(kRecordFixedSize + name.size());
+	const size_t start = out.size();
+	out.resize(start + kRecordHeaderSize + kRecordFixedSize);
+	char* body = &out[start + kRecordHeaderSize];
+	const uint8_t typeByte = static_cast<uint8_t>(type);
+	const int64_t minutesValue = minutes;
+	const uint32_t nameLength = static_cast<uint32_t>(name.size());
+	std::memcpy(body, &typeByte, sizeof(typeByte));
+	std::memcpy(body + 1, &price, sizeof(price));
+	std::memcpy(body + 1 + sizeof(price), &minutesValue, sizeof(minutesValue));
+	std::memcpy(body + 1 + sizeof(price) + sizeof(minutesValue), &nameLength, sizeof(nameLength));
+	out.append(name);
+
+	const uint64_t checksum = MenuSnapshot::checksum(out.data() + start + kRecordHeaderSize, length);
+	std::memcpy(&out[start], &length, sizeof(length));
+	std::memcpy(&out[start + sizeof(length)], &checksum, sizeof(checksum));
+}
+
+bool WriteAheadLog::exists(const std::string& base) {
+	return !listGenerations(base, ".snap.").empty();
+}
+
+// Самый новый снимок плюс журналы его и следующих поколений
+WriteAheadLog::Recovery WriteAheadLog::recover(const std::string& base, IMenuStorage& storage) {
+	Recovery recovery;
+	std::vector<uint64_t> snapshots = listGenerations(base, ".snap.");
+	if (snapshots.empty()) return recovery;
+
+	recovery.found = true;
+	recovery.generation = snapshots.back();
+	storage.clear();
+	recovery.snapshotDishes = MenuSnapshot::load(generationPath(base, ".snap.", recovery.generation), storage);
+
+	for (uint64_t generation : listGenerations(base, ".wal.")) {
+		if (generation < recovery.generation) continue;
+		if (!replayFile(generationPath(base, ".wal.", generation), storage, recovery.replayed)) {
+			// Дальше оборванной записи применять нельзя: последующие изменения опирались бы на потерянные
+			recovery.tornTail = true;
+			break;
+		}
+	}
+	return recovery;
+}
+
+// Восстановленное (или текущее) состояние сразу записывается снимком нового поколения,
+// поэтому журнал всегда начинается с чистого файла, а старые поколения можно удалить
+WriteAheadLog::WriteAheadLog(const std::string& base, IMenuStorage& storage, Recovery& recovery)
+	: base_(base)
+	, generation_(0)
+	, file_(nullptr)
+	, appended_(0)
+	, committed_(0)
+	, records_(0)
+	, bytes_(0)
+	, commits_(0)
+	, stop_(false)
+	, compacting_(false) {
+	recovery = recover(base, storage);
+
+	std::vector<uint64_t> logs = listGenerations(base, ".wal.");
+	uint64_t latest = std::max(recovery.generation, logs.empty() ? 0 : logs.back());
+	generation_ = latest + 1;
+	MenuSnapshot::save(storage.getDishes(), generationPath(base_, ".snap.", generation_));
+	removeGenerationsBefore(base_, generation_);
+	openGeneration(generation_);
+
+	writer_ = std::thread(&WriteAheadLog::writerLoop, this);
+}
+
+WriteAheadLog::~WriteAheadLog() {
+	sync();
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	ready_.notify_one();
+	writer_.join();
+	if (compactor_.joinable()) compactor_.join();
+	if (file_ != nullptr) std::fclose(file_);
+}
+
+void WriteAheadLog::openGeneration(uint64_t generation) {
+	std::string path = generationPath(base_, ".wal.", generation);
+	file_ = AtomicFile::openFile(path, "wb");
+	if (file_ == nullptr) {
+		throw std::runtime_error("Не удалось открыть журнал: " + path);
+	}
+	AtomicFile::syncDirectory(path);
+	records_ = 0;
+	bytes_ = 0;
+}
+
+// Групповая фиксация: все записи, накопившиеся пока шел предыдущий fsync, уходят одним блоком
+void WriteAheadLog::writerLoop() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		ready_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+		if (pending_.empty()) return;
+
+		writing_.swap(pending_);
+		std::FILE* file = file_;
+		lock.unlock();
+		bool written = file != nullptr && std::fwrite(writing_.data(), 1, writing_.size(), file) == writing_.size() && AtomicFile::syncFile(file);
+		lock.lock();
+
+		if (!written) error_ = "Ошибка записи журнала " + generationPath(base_, ".wal.", generation_);
+		committed_ += writing_.size();
+		writing_.clear();
+		commits_++;
+		done_.notify_all();
+	}
+}
+
+void WriteAheadLog::append(WalRecordType type, const std::string& name, double price, long long minutes) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		const size_t before = pending_.size();
+		encodeRecord(pending_, type, name, price, minutes);
+		const size_t size = pending_.size() - before;
+		appended_ += size;
+		bytes_ += size;
+		records_++;
+	}
+	ready_.notify_one();
+}
+
+void WriteAheadLog::logAdd(const std::string& name, double price, const Time& time) {
+	append(WalRecordType::Add, name, price, time.totalMinutes());
+}
+
+void WriteAheadLog::logRemove(const std::string& name, double price, const Time& time) {
+	append(WalRecordType::Remove, name, price, time.totalMinutes());
+}
+
+void WriteAheadLog::logRemoveName(const std::string& name) {
+	append(WalRecordType::RemoveName, name, 0.0, 0);
+}
+
+bool WriteAheadLog::sync() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	const uint64_t target = appended_;
+	done_.wait(lock, [this, target] { return committed_ >= target; });
+	return error_.empty();
+}
+
+// Поколение переключается синхронно (после sync() поток фиксации простаивает),
+// а снимок пишется в фоне: до его готовности восстановление использует прежний снимок и все журналы
+void WriteAheadLog::compact(std::vector<Dish> dishes) {
+	if (compactor_.joinable()) compactor_.join();
+	sync();
+
+	uint64_t generation;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		std::fclose(file_);
+		file_ = nullptr;
+		generation = generation_ + 1;
+		openGeneration(generation);
+		generation_ = generation;
+		compacting_ = true;
+	}
+
+	compactor_ = std::thread([this, generation](std::vector<Dish> rows) {
+		std::string error;
+		try {
+			MenuSnapshot::save(rows, generationPath(base_, ".snap.", generation));
+			removeGenerationsBefore(base_, generation);
+		}
+		catch (const std::exception& e) {
+			error = e.what();
+		}
+		std::lock_guard<std::mutex> lock(mutex_);
+		compactionError_ = error;
+		compacting_ = false;
+	}, std::move(dishes));
+}
+
+bool WriteAheadLog::needsCompaction() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return !compacting_ && bytes_ >= kCompactionThreshold;
+}
+
+WriteAheadLog::Status WriteAheadLog::getStatus() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return Status{ generation_, records_, bytes_, commits_, compacting_ };
+}
+
+std::string WriteAheadLog::takeError() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::string error = error_.empty() ? compactionError_ : error_;
+	error_.clear();
+	compactionError_.clear();
+	return error;
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+﻿#pragma once
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include "interfaces.h"
+#include "models.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Тип записи журнала
+enum class WalRecordType : uint8_t {
+	Add = 1,            ///< Добавлено блюдо
+	Remove = 2,         ///< Удалены блюда с точным совпадением названия, цены и времени
+	RemoveName = 3      ///< Удалены все блюда с названием
+};
+
+/// Журнал изменений меню (write-ahead log). Состояние хранится поколениями:
+///   base.snap.N - двоичный снимок (MenuSnapshot) состояния перед журналом поколения N,
+///   base.wal.N  - записи изменений поколения N.
+/// Восстановление загружает самый новый снимок и применяет журналы от его поколения по порядку.
+/// Запись: длина тела (u32), FNV-1a тела (u64), тело: тип (u8), цена (double), минуты (i64),
+/// длина названия (u32), название. Оборванная последняя запись после сбоя отбрасывается.
+/// Изменения попадают в память за микросекунды; поток записи сбрасывает на диск все,
+/// что накопилось, одним fsync (групповая фиксация). Запись считается надежной только
+/// после sync(): приложение вызывает его перед ответом на каждую изменяющую команду.
+class WriteAheadLog {
+public:
+	/// Итог восстановления
+	struct Recovery {
+		bool found = false;             ///< Найдены файлы журнала
+		uint64_t generation = 0;        ///< Поколение загруженного снимка
+		size_t snapshotDishes = 0;      ///< Блюд в снимке
+		size_t replayed = 0;            ///< Применено записей журнала
+		bool tornTail = false;          ///< В конце журнала была оборванная или поврежденная запись
+	};
+
+	/// Состояние журнала
+	struct Status {
+		uint64_t generation;            ///< Текущее поколение
+		uint64_t records;               ///< Записей в текущем поколении
+		uint64_t bytes;                 ///< Байт в текущем поколении
+		uint64_t commits;               ///< Выполнено групповых фиксаций (fsync)
+		bool compacting;                ///< Идет фоновое уплотнение
+	};
+
+	static constexpr uint64_t kCompactionThreshold = 16u << 20;   ///< Размер поколения, после которого стоит уплотнить журнал
+
+private:
+	std::string base_;                  ///< Путь без суффиксов .snap.N / .wal.N
+	uint64_t generation_;               ///< Поколение, в которое идут записи
+	std::FILE* file_;                   ///< Файл текущего поколения
+	std::string pending_;               ///< Записи, ожидающие фиксации
+	std::string writing_;               ///< Записи, которые сейчас пишет поток фиксации
+	uint64_t appended_;                 ///< Всего добавлено байт
+	uint64_t committed_;                ///< Всего зафиксировано байт
+	uint64_t records_;                  ///< Записей в текущем поколении
+	uint64_t bytes_;                    ///< Байт в текущем поколении
+	uint64_t commits_;                  ///< Количество fsync
+	std::string error_;                 ///< Последняя ошибка записи
+	bool stop_;
+	std::mutex mutex_;
+	std::condition_variable ready_;     ///< Появились записи или запрошена остановка
+	std::condition_variable done_;      ///< Завершилась фиксация
+	std::thread compactor_;             ///< Поток фонового уплотнения
+	bool compacting_;                   ///< Уплотнение выполняется
+	std::string compactionError_;       ///< Ошибка последнего уплотнения
+	std::thread writer_;                ///< Поток фиксации (объявлен последним)
+
+	/// Цикл потока фиксации
+	void writerLoop();
+
+	/// Добавляет запись в очередь фиксации
+	void append(WalRecordType type, const std::string& name, double price, long long minutes);
+
+	/// Открывает файл поколения для дозаписи
+	void openGeneration(uint64_t generation);
+
+public:
+	/// Открывает журнал: если по base есть снимки, хранилище очищается и восстанавливается
+	/// (recovery заполняется итогом), иначе текущее содержимое хранилища становится снимком поколения 1.
+	/// Записи всегда продолжаются в новом поколении. Бросает std::runtime_error при ошибке файлов
+	WriteAheadLog(const std::string& base, IMenuStorage& storage, Recovery& recovery);
+
+	/// Фиксирует оставшиеся записи, дожидается уплотнения и закрывает файл
+	~WriteAheadLog();
+
+	WriteAheadLog(const WriteAheadLog&) = delete;
+	WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+	/// Записывает добавление блюда
+	void logAdd(const std::string& name, double price, const Time& time);
+
+	/// Записывает удаление блюд с точным совпадением параметров
+	void logRemove(const std::string& name, double price, const Time& time);
+
+	/// Записывает удаление всех блюд с названием одной записью
+	void logRemoveName(const std::string& name);
+
+	/// Ждет, пока все добавленные записи будут на диске; возвращает false при ошибке записи
+	bool sync();
+
+	/// Начинает новое поколение и в фоне записывает копию блюд как его снимок;
+	/// после успешной записи файлы прежних поколений удаляются. dishes - состояние на момент вызова
+	void compact(std::vector<Dish> dishes);
+
+	/// Текущее поколение настолько велико, что его стоит уплотнить
+	bool needsCompaction();
+
+	/// Возвращает состояние журнала
+	Status getStatus();
+
+	/// Забирает текст последней ошибки записи или уплотнения (пустой, если ошибок не было)
+	std::string takeError();
+
+	/// Проверяет, есть ли по base снимки журнала
+	static bool exists(const std::string& base);
+
+	/// Загружает самый новый снимок и применяет журналы в хранилище, не открывая журнал на запись
+	static Recovery recover(const std::string& base, IMenuStorage& storage);
+
+	/// Применяет к хранилищу записи файла в формате журнала; replayed увеличивается на число
+	/// примененных записей. Возвращает false, если файл заканчивается оборванной или поврежденной записью
+	static bool replayFile(const std::string& path, IMenuStorage& storage, size_t& replayed);
+
+	/// То же для записей, уже прочитанных в память
+	static bool replayRecords(const char* data, size_t size, IMenuStorage& storage, size_t& replayed);
+
+	/// Кодирует запись журнала (используется также разностными файлами)
+	static void encodeRecord(std::string& out, WalRecordType type, const std::string& name, double price, long long minutes);
+};
+
+#endif // WRITE_AHEAD_LOG_H
\ No newline at end of file
@@ -0,0 +1,257 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/app.h"
+#include "../RestaurantMenu/builder.h"
+#include "../RestaurantMenu/delta_saver.h"
+#include "../RestaurantMenu/storage.h"
+#include "../RestaurantMenu/write_ahead_log.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+// Читает файл целиком
+static std::string readAll(const std::string& filename) {
+	std::ifstream in(filename, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Перенаправляет std::cout в строку на время жизни объекта
+class CaptureOutput {
+private:
+	std::ostringstream text_;
+	std::streambuf* previous_;
+
+public:
+	CaptureOutput() : previous_(std::cout.rdbuf(text_.rdbuf())) {}
+	~CaptureOutput() { std::cout.rdbuf(previous_); }
+
+	std::string text() const { return text_.str(); }
+};
+
+// Создает приложение, не выводя журнал сборки
+static std::unique_ptr<RestaurantMenuApp> createApp() {
+	CaptureOutput output;
+	return RestaurantMenuAppBuilder::createDefault();
+}
+
+// Выполняет сценарий и возвращает код завершения
+static int runScript(RestaurantMenuApp& app, const std::string& script, std::string* output = nullptr) {
+	CaptureOutput capture;
+	std::istringstream input(script);
+	int code = app.runBatch(input);
+	if (output) *output = capture.text();
+	return code;
+}
+
+/// Тестирование отбрасывания транзакции при загрузке другого меню
+TEST(RestaurantMenuAppTest, LoadDiscardsOpenTransaction) {
+	std::ofstream("test_app_first.txt") << "\"Суп\" 5.00 0:10\n\"Чай\" 1.00 0:05\n";
+	std::ofstream("test_app_second.txt") << "\"Чай\" 1.00 0:05\n";
+	auto app = createApp();
+
+	std::string output;
+	EXPECT_EQ(runScript(*app,
+		"load test_app_first.txt\n"
+		"begin\n"
+		"delete Чай\n"
+		"load test_app_second.txt\n"
+		"commit\n"
+		"save test_app_out.txt\n", &output), 1);
+	EXPECT_NE(output.find("отброшено изменений: 1"), std::string::npos);
+	EXPECT_NE(output.find("транзакция не начата"), std::string::npos);
+	// Удаление из прежнего меню не применилось к новому
+	EXPECT_EQ(readAll("test_app_out.txt"), "\"Чай\" 1.00 0:05\n");
+
+	CaptureOutput capture;
+	EXPECT_TRUE(app->beginTransaction());
+	EXPECT_FALSE(app->beginTransaction());
+	app->clearMenu();
+	EXPECT_FALSE(app->inTransaction());
+	EXPECT_FALSE(app->commitTransaction());
+
+	std::remove("test_app_first.txt");
+	std::remove("test_app_second.txt");
+	std::remove("test_app_out.txt");
+}
+
+/// Тестирование кодов завершения пакетного режима и пропуска комментариев
+TEST(RestaurantMenuAppTest, BatchExitCodes) {
+	auto app = createApp();
+	std::string output;
+	// Строка-комментарий, выполненная как команда, была бы ошибкой
+	EXPECT_EQ(runScript(*app,
+		"# сценарий\n"
+		"\n"
+		"add \"Суп\" 5.00 0:10\r\n"
+		"  # отступ перед комментарием\n"
+		"find Суп\n", &output), 0);
+	EXPECT_NE(output.find("Блюдо добавлено: Суп"), std::string::npos);
+	EXPECT_EQ(output.find("ERROR"), std::string::npos);
+
+	EXPECT_EQ(runScript(*app, "add \"Чай\" 0.00 0:05\nfind Суп\n", &output), 1);
+	EXPECT_NE(output.find("ERROR: цена должна быть положительной"), std::string::npos);
+
+	// Команды после exit не выполняются, счетчик ошибок сбрасывается для каждого сценария
+	EXPECT_EQ(runScript(*app, "find Суп\nexit\nнеизвестная команда\n"), 0);
+
+	// Нераспознанный ввод и пустые критерии фильтрации - тоже ошибки сценария
+	EXPECT_EQ(runScript(*app, "неизвестная команда\n", &output), 1);
+	EXPECT_EQ(output.compare(0, 7, "ERROR: "), 0);
+	EXPECT_EQ(runScript(*app, "0\n", &output), 1);
+	EXPECT_NE(output.find("ERROR: некорректные критерии фильтрации"), std::string::npos);
+}
+
+/// Тестирование опции --format: внутри кавычек это часть названия блюда
+TEST(RestaurantMenuAppTest, FormatOptionOutsideQuotes) {
+	auto app = createApp();
+	std::string output;
+	EXPECT_EQ(runScript(*app, "add \"Суп --format=csv\" 5.00 0:10\n", &output), 0);
+	EXPECT_NE(output.find("Блюдо добавлено: Суп --format=csv"), std::string::npos);
+
+	EXPECT_EQ(runScript(*app, "find Суп --format=csv\n", &output), 0);
+	EXPECT_NE(output.find("name,price,minutes\n"), std::string::npos);
+
+	EXPECT_EQ(runScript(*app, "find Суп --format=xml\n", &output), 1);
+	EXPECT_NE(output.find("ERROR: неизвестный формат \"xml\""), std::string::npos);
+}
+
+/// Тестирование постраничного вывода представления: страницы нумеруются по всему представлению
+TEST(RestaurantMenuAppTest, ViewPaging) {
+	std::ofstream("test_app_view.txt") << "\"Блюдо a\" 1.00 0:10\n\"Блюдо b\" 2.00 0:10\n\"Блюдо c\" 3.00 0:10\n"
+		"\"Блюдо d\" 40.00 0:10\n\"Блюдо e\" 5.00 0:10\n";
+	auto app = createApp();
+	std::string output;
+	EXPECT_EQ(runScript(*app,
+		"load test_app_view.txt\n"
+		"view дешевые <10\n"
+		"view\n"
+		"pagesize 2\n"
+		"print дешевые 2\n"
+		"next\n", &output), 0);
+	EXPECT_NE(output.find("дешевые (4 блюд)"), std::string::npos);
+	EXPECT_NE(output.find("3. Блюдо c"), std::string::npos);
+	EXPECT_NE(output.find("Страница 2 из 2 (блюда 3-4 из 4)"), std::string::npos);
+	EXPECT_EQ(output.find("Блюдо d"), std::string::npos);
+	EXPECT_NE(output.find("Страница 3 не существует"), std::string::npos);
+
+	std::remove("test_app_view.txt");
+}
+
+/// Тестирование журнала: подтвержденное изменение уже на диске, пока приложение работает
+TEST(RestaurantMenuAppTest, WalAcknowledgesAfterSync) {
+	const std::string base = "test_app_wal";
+	auto removeWalFiles = [&base]() {
+		for (const auto& entry : std::filesystem::directory_iterator(".")) {
+			std::string name = entry.path().filename().string();
+			if (name.compare(0, base.size() + 1, base + ".") == 0) std::filesystem::remove(entry.path());
+		}
+	};
+	removeWalFiles();
+
+	std::ofstream("test_app_wal.txt") << "\"Борщ\" 12.00 0:45\n";
+	auto app = createApp();
+	EXPECT_EQ(runScript(*app,
+		"load test_app_wal.txt\n"
+		"wal " + base + "\n"
+		"add \"Чай\" 2.50 0:05\n"
+		"delete Борщ\n"
+		"begin\n"
+		"add \"Суп\" 8.00 0:30\n"
+		"commit\n"), 0);
+
+	// Журнал читается без закрытия: все три команды должны быть зафиксированы
+	MenuStorage recovered;
+	WriteAheadLog::Recovery recovery = WriteAheadLog::recover(base, recovered);
+	EXPECT_TRUE(recovery.found);
+	EXPECT_EQ(recovery.replayed, 3u);
+	EXPECT_FALSE(recovery.tornTail);
+	ASSERT_EQ(recovered.getDishesCount(), 2u);
+	recovered.sortByName();
+	EXPECT_EQ(recovered.getDishes()[0].name, "Суп");
+	EXPECT_EQ(recovered.getDishes()[1].name, "Чай");
+
+	app.reset();
+	removeWalFiles();
+	std::remove("test_app_wal.txt");
+}
+
+/// Тестирование разностных сохранений вперемешку с полными в тот же файл: ни одно изменение не теряется
+TEST(RestaurantMenuAppTest, DeltaAfterFullSaveKeepsChanges) {
+	const std::string path = "test_app_delta.bin";
+	auto removeFiles = [&path]() {
+		std::remove(path.c_str());
+		for (size_t i = 1; i <= 3; ++i) std::remove(DeltaSaver::deltaPath(path, i).c_str());
+	};
+	removeFiles();
+
+	auto app = createApp();
+	EXPECT_EQ(runScript(*app,
+		"add \"Блюдо A\" 1.00 0:10\n"
+		"save " + path + " --delta\n"
+		"add \"Блюдо B\" 2.00 0:10\n"
+		"save " + path + " --binary\n"
+		"add \"Блюдо C\" 3.00 0:10\n"
+		"save " + path + " --delta\n"), 0);
+
+	MenuStorage loaded;
+	DeltaSaver().load(path, loaded);
+	std::vector<std::string> names;
+	for (const auto& dish : loaded.getDishes()) names.push_back(dish.name);
+	for (const char* name : { "Блюдо A", "Блюдо B", "Блюдо C" }) {
+		EXPECT_NE(std::find(names.begin(), names.end(), name), names.end()) << name;
+	}
+
+	removeFiles();
+}
+
+/// Тестирование merge --out в отслеживаемый файл: результат слияния не применяется к меню как правка файла
+TEST(RestaurantMenuAppTest, MergeIntoWatchedFile) {
+	std::ofstream("test_app_merge_a.txt") << "\"Борщ\" 12.00 0:45\n";
+	std::ofstream("test_app_merge_b.txt") << "\"Чай\" 2.50 0:05\n";
+
+	auto app = createApp();
+	std::string output;
+	EXPECT_EQ(runScript(*app,
+		"load test_app_merge_a.txt\n"
+		"watch\n"
+		"merge test_app_merge_a.txt test_app_merge_b.txt --out=test_app_merge_a.txt\n"
+		"print\n", &output), 0);
+	const size_t saved = output.find("Меню успешно сохранено в файл: test_app_merge_a.txt");
+	ASSERT_NE(saved, std::string::npos);
+	EXPECT_EQ(output.find("test_app_merge_a.txt изменен"), std::string::npos);
+	// Загруженное меню осталось прежним: в выводе print после слияния нет блюда второго файла
+	EXPECT_EQ(output.find(". Чай", saved), std::string::npos);
+
+	app.reset();
+	std::remove("test_app_merge_a.txt");
+	std::remove("test_app_merge_b.txt");
+}
+
+/// Тестирование того, что пакетный режим не запрашивает подтверждений
+TEST(RestaurantMenuAppTest, BatchSkipsConfirmations) {
+	// menu.txt в рабочем каталоге сохраняется и восстанавливается
+	std::ifstream existing("menu.txt", std::ios::binary);
+	const bool hadMenu = existing.is_open();
+	const std::string saved = hadMenu ? readAll("menu.txt") : std::string();
+	existing.close();
+
+	auto app = createApp();
+	std::string output;
+	EXPECT_EQ(runScript(*app,
+		"add \"Борщ\" 7.00 0:40\n"
+		"delete Борш\n"
+		"save menu.txt\n", &output), 0);
+
+	// Похожее название только предлагается: без подтверждения ничего не удаляется
+	EXPECT_NE(output.find("Возможно, вы имели в виду"), std::string::npos);
+	EXPECT_EQ(output.find("Введите номер"), std::string::npos);
+	// Перезапись menu.txt не спрашивается
+	EXPECT_EQ(output.find("Продолжить?"), std::string::npos);
+	EXPECT_EQ(readAll("menu.txt"), "\"Борщ\" 7.00 0:40\n");
+
+	if (hadMenu) std::ofstream("menu.txt", std::ios::binary) << saved;
+	else std::remove("menu.txt");
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/async_output.h"
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+/// Медленный приемник: каждая запись блока занимает заметное время
+class SlowStreamBuf : public std::streambuf {
+public:
+	std::string data;
+	size_t writes = 0;
+
+protected:
+	int_type overflow(int_type ch) override {
+		data.push_back(traits_type::to_char_type(ch));
+		return ch;
+	}
+
+	std::streamsize xsputn(const char* s, std::streamsize count) override {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		writes++;
+		data.append(s, static_cast<size_t>(count));
+		return count;
+	}
+};
+
+/// Тестирование порядка и полноты вывода через поток-писатель
+TEST(AsyncOutputTest, PreservesOrder) {
+	std::ostringstream sink;
+	std::string expected;
+	{
+		AsyncOutput output(sink, 64);
+		for (int i = 0; i < 1000; ++i) {
+			sink << "строка " << i << std::endl;
+			expected += "строка " + std::to_string(i) + "\n";
+		}
+		output.drain();
+	}
+	EXPECT_EQ(sink.str(), expected);
+}
+
+/// Тестирование того, что медленный приемник не задерживает поток команд
+TEST(AsyncOutputTest, SlowSinkDoesNotBlockWriter) {
+	SlowStreamBuf slow;
+	std::ostream stream(&slow);
+	{
+		AsyncOutput output(stream);
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < 20; ++i) {
+			stream << "ответ " << i << std::endl;
+		}
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		// Синхронно 20 записей заняли бы не меньше 400 мс
+		EXPECT_LT(elapsed, std::chrono::milliseconds(200));
+
+		output.drain();
+		EXPECT_NE(slow.data.find("ответ 19\n"), std::string::npos);
+		// Пока писатель спал, записи копились и ушли меньшим числом блоков
+		EXPECT_LT(slow.writes, 20u);
+	}
+	EXPECT_EQ(stream.rdbuf(), static_cast<std::streambuf*>(&slow));
+}
+
+/// Тестирование того, что std::endl не передает текст писателю: строки копятся до drain()
+TEST(AsyncOutputTest, EndlDoesNotWakeWriter) {
+	SlowStreamBuf sink;
+	std::ostream stream(&sink);
+	{
+		AsyncOutput output(stream);
+		for (int i = 0; i < 100; ++i) {
+			stream << "строка " << i << std::endl;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		EXPECT_EQ(sink.writes, 0u);
+		EXPECT_TRUE(sink.data.empty());
+
+		output.drain();
+		EXPECT_EQ(sink.writes, 1u);
+		EXPECT_NE(sink.data.find("строка 99\n"), std::string::npos);
+	}
+}
\ No newline at end of file
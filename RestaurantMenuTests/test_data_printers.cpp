@@ -0,0 +1,74 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/data_printers.h"
+#include <sstream>
+
+/// Тестирование экранирования полей CSV
+TEST(DataPrintersTest, CsvEscaping) {
+	std::ostringstream out;
+	CsvMenuPrinter printer(out);
+	std::vector<Dish> dishes = {
+		Dish("Чай", 2.5, Time(0, 5)),
+		Dish("Суп \"Дня\", большой", 12.0, Time(1, 30))
+	};
+
+	printer.printFilteredDishes(dishes, "");
+	EXPECT_EQ(out.str(), "name,price,minutes\nЧай,2.50,5\n\"Суп \"\"Дня\"\", большой\",12.00,90\n");
+}
+
+/// Тестирование JSON-массива и экранирования строк
+TEST(DataPrintersTest, JsonArray) {
+	std::ostringstream out;
+	JsonMenuPrinter printer(out);
+
+	printer.printFilteredDishes({}, "");
+	EXPECT_EQ(out.str(), "[]\n");
+
+	out.str("");
+	printer.printFilteredDishes({ Dish("A\"b\\c\td", 1.0, Time(0, 10)), Dish("\xD0\xA7\xD0\xB0\xD0\xB9", 2.5, Time(0, 5)) }, "");
+	EXPECT_EQ(out.str(),
+		"[\n  {\"name\":\"A\\\"b\\\\c\\td\",\"price\":1.00,\"minutes\":10},\n"
+		"  {\"name\":\"\xD0\xA7\xD0\xB0\xD0\xB9\",\"price\":2.50,\"minutes\":5}\n]\n");
+
+	std::string control;
+	JsonMenuPrinter::appendString(control, std::string("\x01"));
+	EXPECT_EQ(control, "\"\\u0001\"");
+}
+
+/// Тестирование перекодировки названий CP1251 в UTF-8 (Чай, Ёж, №)
+TEST(DataPrintersTest, JsonTranscodesCp1251) {
+	std::string out;
+	JsonMenuPrinter::appendString(out, std::string("\xD7\xE0\xE9"));
+	EXPECT_EQ(out, "\"\xD0\xA7\xD0\xB0\xD0\xB9\"");
+
+	out.clear();
+	JsonMenuPrinter::appendString(out, std::string("\xA8\xE6 \xB9"));
+	EXPECT_EQ(out, "\"\xD0\x81\xD0\xB6 \xE2\x84\x96\"");
+}
+
+/// Тестирование NDJSON: одна запись на строку, страница выводит только свои блюда
+TEST(DataPrintersTest, NdjsonPage) {
+	std::ostringstream out;
+	NdjsonMenuPrinter printer(out);
+	std::vector<Dish> dishes;
+	for (int i = 0; i < 5; ++i) {
+		dishes.push_back(Dish("D" + std::to_string(i), 1.0 + i, Time(0, 10)));
+	}
+
+	printer.printPage(dishes, 2, 2, "");
+	EXPECT_EQ(out.str(),
+		"{\"name\":\"D2\",\"price\":3.00,\"minutes\":10}\n"
+		"{\"name\":\"D3\",\"price\":4.00,\"minutes\":10}\n");
+
+	out.str("");
+	printer.printPage(dishes, 9, 2, "");
+	EXPECT_EQ(out.str(), "");
+}
+
+/// Тестирование выбора принтера по названию формата
+TEST(DataPrintersTest, Formats) {
+	EXPECT_NE(PrinterFormats::create("table"), nullptr);
+	EXPECT_NE(PrinterFormats::create("csv"), nullptr);
+	EXPECT_NE(PrinterFormats::create("json"), nullptr);
+	EXPECT_NE(PrinterFormats::create("ndjson"), nullptr);
+	EXPECT_EQ(PrinterFormats::create("xml"), nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/delta_saver.h"
+#include "../RestaurantMenu/storage.h"
+#include <cstdio>
+#include <fstream>
+
+// Удаляет базу и наборы изменений
+static void removeDeltaFiles(const std::string& path) {
+	std::remove(path.c_str());
+	for (size_t number = 1; number <= 40; ++number) {
+		std::remove(DeltaSaver::deltaPath(path, number).c_str());
+	}
+}
+
+/// Тестирование итогового набора изменений хранилища
+TEST(DeltaSaverTest, ChangeSetCancelsAddThenRemove) {
+	MenuStorage storage;
+	storage.addDish("Борщ", 12.0, Time(0, 45));
+	uint64_t version = storage.getVersion();
+
+	storage.addDish("Чай", 2.5, Time(0, 5));
+	storage.addDish("Суп", 8.0, Time(0, 30));
+	storage.removeDish("Суп", 8.0, Time(0, 30));
+	storage.removeDish("Борщ", 12.0, Time(0, 45));
+
+	std::vector<Dish> added, removed;
+	ASSERT_TRUE(storage.getChangeSetSince(version, added, removed));
+	ASSERT_EQ(added.size(), 1u);
+	EXPECT_EQ(added[0].name, "Чай");
+	ASSERT_EQ(removed.size(), 1u);
+	EXPECT_EQ(removed[0].name, "Борщ");
+}
+
+/// Тестирование записи наборов изменений и загрузки базы вместе с ними
+TEST(DeltaSaverTest, SaveDeltasAndLoad) {
+	const std::string path = "test_delta_menu.bin";
+	removeDeltaFiles(path);
+
+	MenuStorage storage;
+	storage.addDish("Борщ", 12.0, Time(0, 45));
+	storage.addDish("Чай", 2.5, Time(0, 5));
+
+	DeltaSaver saver;
+	size_t written = 0;
+	EXPECT_EQ(saver.save(storage, path, written), DeltaSaver::Result::Full);
+	EXPECT_EQ(saver.save(storage, path, written), DeltaSaver::Result::Unchanged);
+
+	storage.addDish("Кофе", 3.0, Time(0, 10));
+	EXPECT_EQ(saver.save(storage, path, written), DeltaSaver::Result::Delta);
+	EXPECT_EQ(written, 1u);
+	storage.removeDish("Чай", 2.5, Time(0, 5));
+	storage.addDish("Чай", 2.5, Time(0, 5));
+	EXPECT_EQ(saver.save(storage, path, written), DeltaSaver::Result::Delta);
+	EXPECT_EQ(written, 2u);
+	EXPECT_TRUE(std::ifstream(DeltaSaver::deltaPath(path, 2)).is_open());
+
+	MenuStorage loaded;
+	DeltaSaver loader;
+	EXPECT_EQ(loader.load(path, loaded), 2u);
+	EXPECT_EQ(loaded.getDishesCount(), 3u);
+
+	// После загрузки тот же объект продолжает нумерацию наборов
+	loaded.addDish("Сок", 4.0, Time(0, 2));
+	EXPECT_EQ(loader.save(loaded, path, written), DeltaSaver::Result::Delta);
+	EXPECT_TRUE(std::ifstream(DeltaSaver::deltaPath(path, 3)).is_open());
+
+	// Объединение переписывает базу и удаляет наборы
+	EXPECT_EQ(DeltaSaver::consolidate(path), 3u);
+	EXPECT_FALSE(std::ifstream(DeltaSaver::deltaPath(path, 1)).is_open());
+	MenuStorage merged;
+	EXPECT_EQ(DeltaSaver().load(path, merged), 0u);
+	EXPECT_EQ(merged.getDishesCount(), 4u);
+	removeDeltaFiles(path);
+}
+
+/// Тестирование автоматического объединения и игнорирования наборов от прежней базы
+TEST(DeltaSaverTest, ConsolidatesAndIgnoresStaleDeltas) {
+	const std::string path = "test_delta_consolidate.bin";
+	removeDeltaFiles(path);
+
+	MenuStorage storage;
+	DeltaSaver saver;
+	size_t written = 0;
+	saver.save(storage, path, written);
+	for (size_t i = 0; i < DeltaSaver::kMaxDeltas; ++i) {
+		storage.addDish("Блюдо " + std::to_string(i), 1.0 + i, Time(0, 10));
+		EXPECT_EQ(saver.save(storage, path, written), DeltaSaver::Result::Delta);
+	}
+	storage.addDish("Последнее", 100.0, Time(1, 0));
+	EXPECT_EQ(saver.save(storage, path, written), DeltaSaver::Result::Consolidated);
+	EXPECT_FALSE(std::ifstream(DeltaSaver::deltaPath(path, 1)).is_open());
+
+	// Набор, записанный для другой базы, не применяется
+	MenuStorage other;
+	other.addDish("Чужое", 1.0, Time(0, 1));
+	DeltaSaver otherSaver;
+	otherSaver.save(other, "test_delta_other.bin", written);
+	other.addDish("Еще", 2.0, Time(0, 2));
+	otherSaver.save(other, "test_delta_other.bin", written);
+	std::rename(DeltaSaver::deltaPath("test_delta_other.bin", 1).c_str(), DeltaSaver::deltaPath(path, 1).c_str());
+
+	MenuStorage loaded;
+	EXPECT_EQ(DeltaSaver().load(path, loaded), 0u);
+	EXPECT_EQ(loaded.getDishesCount(), DeltaSaver::kMaxDeltas + 1);
+	removeDeltaFiles(path);
+	removeDeltaFiles("test_delta_other.bin");
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/filter_kernels.h"
+#include "../RestaurantMenu/query.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+/// Эталонный отбор обычным циклом
+template <typename T>
+static std::vector<uint32_t> referenceSelect(const std::vector<T>& values, T minValue, T maxValue) {
+	std::vector<uint32_t> result;
+	for (size_t i = 0; i < values.size(); ++i) {
+		if (values[i] >= minValue && values[i] < maxValue) result.push_back(static_cast<uint32_t>(i));
+	}
+	return result;
+}
+
+/// Запускает ядро с указанным набором инструкций и обрезает вектор выбора по результату
+template <typename T>
+static std::vector<uint32_t> kernelSelect(const std::vector<T>& values, T minValue, T maxValue, KernelIsa isa) {
+	std::vector<uint32_t> selection(values.size() + FilterKernels::kSelectionSlack);
+	size_t count = FilterKernels::selectRange(values.data(), values.size(), minValue, maxValue, selection.data(), isa);
+	selection.resize(count);
+	return selection;
+}
+
+/// Тестирование совпадения всех ядер с эталоном, включая хвосты не кратные ширине вектора
+TEST(FilterKernelsTest, AllIsaMatchReference) {
+	std::mt19937 random(42);
+	std::uniform_real_distribution<double> priceDistribution(0.0, 100.0);
+	std::uniform_int_distribution<int32_t> minutesDistribution(0, 600);
+
+	for (size_t size : { 0, 1, 3, 7, 8, 9, 17, 1000 }) {
+		std::vector<double> prices(size);
+		std::vector<int32_t> minutes(size);
+		for (size_t i = 0; i < size; ++i) {
+			prices[i] = priceDistribution(random);
+			minutes[i] = minutesDistribution(random);
+		}
+
+		auto expectedPrices = referenceSelect(prices, 20.0, 60.0);
+		auto expectedMinutes = referenceSelect<int32_t>(minutes, 30, 240);
+		for (KernelIsa isa : { KernelIsa::Scalar, KernelIsa::Sse2, KernelIsa::Avx2 }) {
+			EXPECT_EQ(kernelSelect(prices, 20.0, 60.0, isa), expectedPrices) << FilterKernels::isaName(isa) << " " << size;
+			EXPECT_EQ(kernelSelect<int32_t>(minutes, 30, 240, isa), expectedMinutes) << FilterKernels::isaName(isa) << " " << size;
+		}
+	}
+}
+
+/// Тестирование сужения вектора выбора на месте
+TEST(FilterKernelsTest, RefineInPlace) {
+	std::vector<double> prices = { 5.0, 15.0, 25.0, 35.0, 45.0, 55.0 };
+	std::vector<int32_t> minutes = { 10, 20, 30, 40, 50, 60 };
+
+	std::vector<uint32_t> selection(prices.size() + FilterKernels::kSelectionSlack);
+	size_t count = FilterKernels::selectRange(prices.data(), prices.size(), 10.0, 50.0, selection.data());
+	ASSERT_EQ(count, 4);
+
+	count = FilterKernels::refineRange(minutes.data(), selection.data(), count, 25, 100, selection.data());
+	ASSERT_EQ(count, 3);
+	EXPECT_EQ(selection[0], 2);
+	EXPECT_EQ(selection[1], 3);
+	EXPECT_EQ(selection[2], 4);
+}
+
+/// Тестирование запроса через ядра: результат совпадает с построчной проверкой
+TEST(FilterKernelsTest, QueryMatchesCompiledPredicate) {
+	std::mt19937 random(7);
+	std::uniform_real_distribution<double> priceDistribution(1.0, 50.0);
+	std::uniform_int_distribution<int> minutesDistribution(0, 300);
+
+	std::vector<Dish> dishes;
+	for (int i = 0; i < 500; ++i) {
+		int total = minutesDistribution(random);
+		dishes.push_back(Dish(i % 3 == 0 ? "Суп" : "Салат", priceDistribution(random), Time(total / 60, total % 60)));
+	}
+
+	DishPredicate predicate = DishPredicate::priceBetween(10.0, 30.0) &&
+		DishPredicate::timeBelow(Time(2, 0)) && DishPredicate::nameEquals("Суп");
+	CompiledPredicate compiled(predicate);
+
+	std::vector<size_t> expected;
+	for (size_t i = 0; i < dishes.size(); ++i) {
+		if (compiled.matches(dishes[i])) expected.push_back(i);
+	}
+
+	EXPECT_EQ(MenuQuery().where(predicate).selectRows(dishes), expected);
+}
+
+/// Микробенчмарк: исходный цикл по блюдам против ядер над столбцами - с построением столбцов
+/// на каждый запрос и над готовыми столбцами хранилища.
+/// Запуск: --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST(FilterKernelsTest, DISABLED_Benchmark) {
+	const size_t size = 1 << 20;
+	const int repeats = 20;
+	std::mt19937 random(1);
+	std::uniform_real_distribution<double> priceDistribution(1.0, 100.0);
+	std::uniform_int_distribution<int> minutesDistribution(0, 600);
+
+	std::vector<Dish> dishes;
+	dishes.reserve(size);
+	for (size_t i = 0; i < size; ++i) {
+		int total = minutesDistribution(random);
+		dishes.push_back(Dish("Блюдо", priceDistribution(random), Time(total / 60, total % 60)));
+	}
+	MenuColumns stored = MenuColumns::build(dishes, true, true);
+	std::vector<uint32_t> selection(size + FilterKernels::kSelectionSlack);
+
+	auto report = [&](const std::string& name, size_t selected, std::chrono::steady_clock::duration elapsed) {
+		double seconds = std::chrono::duration<double>(elapsed).count();
+		std::cout << name << ": " << selected << " строк, "
+			<< static_cast<long long>(size * repeats / seconds) << " строк/с" << std::endl;
+	};
+
+	// Исходный путь фильтра: сравнение полей каждого блюда
+	const long long maxMinutes = Time(4, 0).totalMinutes();
+	size_t selected = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < repeats; ++r) {
+		selected = 0;
+		for (const auto& dish : dishes) {
+			if (dish.price >= 20.0 && dish.price < 60.0 && dish.totalMinutes() < maxMinutes) selected++;
+		}
+	}
+	report("Исходный цикл", selected, std::chrono::steady_clock::now() - start);
+
+	for (KernelIsa isa : { KernelIsa::Scalar, KernelIsa::Sse2, KernelIsa::Avx2 }) {
+		start = std::chrono::steady_clock::now();
+		for (int r = 0; r < repeats; ++r) {
+			MenuColumns columns = MenuColumns::build(dishes, true, true);
+			selected = FilterKernels::selectRange(columns.prices.data(), size, 20.0, 60.0, selection.data(), isa);
+			selected = FilterKernels::refineRange(columns.minutes.data(), selection.data(), selected, 0, 240, selection.data());
+		}
+		report(std::string("Построение + ") + FilterKernels::isaName(isa), selected, std::chrono::steady_clock::now() - start);
+
+		start = std::chrono::steady_clock::now();
+		for (int r = 0; r < repeats; ++r) {
+			selected = FilterKernels::selectRange(stored.prices.data(), size, 20.0, 60.0, selection.data(), isa);
+			selected = FilterKernels::refineRange(stored.minutes.data(), selection.data(), selected, 0, 240, selection.data());
+		}
+		report(std::string("Готовые столбцы + ") + FilterKernels::isaName(isa), selected, std::chrono::steady_clock::now() - start);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/formatting.h"
+
+/// Тестирование ширины на экране: UTF-8 считается по символам, однобайтовая кодировка - по байтам
+TEST(DishFormatTest, DisplayWidth) {
+	std::string utf8 = "\xD0\x91\xD0\xBE\xD1\x80\xD1\x89";   // "Борщ" в UTF-8
+	std::string cp1251 = "\xC1\xEE\xF0\xF9";                   // "Борщ" в CP1251
+	EXPECT_EQ(DishFormat::displayWidth(utf8.data(), utf8.size()), 4);
+	EXPECT_EQ(DishFormat::displayWidth(cp1251.data(), cp1251.size()), 4);
+	EXPECT_EQ(DishFormat::displayWidth("Pizza", 5), 5);
+}
+
+/// Тестирование форматирования времени и цены: совпадает с прежним выводом через потоки
+TEST(DishFormatTest, TimeAndPrice) {
+	char buffer[DishFormat::kMaxTimeLength];
+	EXPECT_EQ(std::string(buffer, DishFormat::formatTime(Time(2, 30), buffer)), "2ч 30м");
+	EXPECT_EQ(std::string(buffer, DishFormat::formatTime(Time(2, 30, 3, 1), buffer)), "1г. 3д. 2ч 30м");
+	EXPECT_EQ(std::string(buffer, DishFormat::formatTime(Time(0, 0, 1), buffer)), "1д. 0ч 0м");
+	EXPECT_EQ(std::string(buffer, DishFormat::formatTime(Time(), buffer)), "0м");
+
+	EXPECT_EQ(std::string(buffer, DishFormat::formatPrice(12.5, buffer)), "12.50");
+	EXPECT_EQ(std::string(buffer, DishFormat::formatPrice(0.125, buffer)), "0.12");
+	EXPECT_EQ(std::string(buffer, DishFormat::formatPrice(1999.999, buffer)), "2000.00");
+}
+
+/// Тестирование выравнивания строк: колонка цены начинается с одной позиции для любых названий
+TEST(DishFormatTest, RowsAlignByDisplayWidth) {
+	std::string ascii;
+	std::string cyrillic;
+	DishFormat::appendRow(ascii, Dish("Soup", 5.0, Time(0, 20)));
+	DishFormat::appendRow(cyrillic, Dish("Борщ", 5.0, Time(0, 20)));
+
+	size_t asciiColumn = DishFormat::displayWidth(ascii.data(), ascii.find("5.00"));
+	size_t cyrillicColumn = DishFormat::displayWidth(cyrillic.data(), cyrillic.find("5.00"));
+	EXPECT_EQ(asciiColumn, DishFormat::kNameWidth);
+	EXPECT_EQ(cyrillicColumn, DishFormat::kNameWidth);
+
+	std::string line;
+	DishFormat::appendFileLine(line, Dish("Суп", 5.0, Time(0, 20)));
+	EXPECT_EQ(line, "\"Суп\" 5.00 0:20");
+}
+
+/// Тестирование строки файла меню: точная цена и время в часах и минутах
+TEST(DishFormatTest, FileLine) {
+	std::string line;
+	DishFormat::appendFileLine(line, Dish("Чай", 0.125, Time(2, 5, 1)));
+	EXPECT_EQ(line, "\"Чай\" 0.125 26:05");
+
+	line.clear();
+	DishFormat::appendFilePrice(line, 1e20);
+	EXPECT_EQ(line, "100000000000000000000.00");
+}
@@ -0,0 +1,74 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/mapped_snapshot.h"
+#include "../RestaurantMenu/menu_snapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+/// Тестирование чтения колонок и названий прямо из отображенного снимка
+TEST(MappedSnapshotTest, ReadsColumnsInPlace) {
+	std::vector<Dish> dishes = {
+		Dish("Борщ", 12.34, Time(0, 45)),
+		Dish("", 0.5, Time(0, 1)),
+		Dish("Пицца Маргарита", 25.0, Time(5, 7, 3, 2))
+	};
+	const std::string filename = "test_mapped.bin";
+	MenuSnapshot::save(dishes, filename);
+
+	{
+		MappedSnapshot snapshot(filename);
+		ASSERT_EQ(snapshot.size(), 3u);
+		EXPECT_TRUE(snapshot.verify());
+		for (size_t i = 0; i < dishes.size(); ++i) {
+			EXPECT_EQ(snapshot.name(i), dishes[i].name);
+			EXPECT_EQ(snapshot.price(i), dishes[i].price);
+			EXPECT_EQ(snapshot.minutes(i), dishes[i].totalMinutes());
+			EXPECT_TRUE(snapshot.dish(i).time == dishes[i].time);
+		}
+
+		EXPECT_EQ(snapshot.select(DishPredicate::priceBelow(20.0)), (std::vector<size_t>{ 0, 1 }));
+		EXPECT_EQ(snapshot.select(DishPredicate::timeAbove(Time(0, 30)) && DishPredicate::priceBelow(20.0)),
+			(std::vector<size_t>{ 0 }));
+		EXPECT_EQ(snapshot.select(DishPredicate::namePrefix("пицца")), (std::vector<size_t>{ 2 }));
+		EXPECT_EQ(snapshot.select(DishPredicate::any(), 2).size(), 2u);
+
+		std::vector<Dish> copies = snapshot.dishes({ 2 });
+		ASSERT_EQ(copies.size(), 1u);
+		EXPECT_EQ(copies[0].name, "Пицца Маргарита");
+	}
+	std::remove(filename.c_str());
+}
+
+/// Тестирование отказа отображать файл, который не является снимком или обрезан
+TEST(MappedSnapshotTest, RejectsInvalidFiles) {
+	const std::string filename = "test_mapped_bad.bin";
+	EXPECT_THROW(MappedSnapshot("test_mapped_missing.bin"), std::runtime_error);
+
+	std::ofstream(filename) << "\"Чай\" 2.50 0:05\n";
+	EXPECT_THROW(MappedSnapshot snapshot(filename), std::runtime_error);
+
+	MenuSnapshot::save({ Dish("Чай", 2.5, Time(0, 5)) }, filename);
+	std::string bytes;
+	{
+		std::ifstream in(filename, std::ios::binary);
+		bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+	std::ofstream(filename, std::ios::binary).write(bytes.data(), bytes.size() - 1);
+	EXPECT_THROW(MappedSnapshot snapshot(filename), std::runtime_error);
+
+	// Огромный размер таблицы названий в заголовке: name() иначе читал бы за пределами отображения
+	std::string oversized = bytes;
+	std::fill(oversized.begin() + 24, oversized.begin() + 32, '\xFF');
+	std::ofstream(filename, std::ios::binary).write(oversized.data(), oversized.size());
+	EXPECT_THROW(MappedSnapshot snapshot(filename), std::runtime_error);
+
+	// Испорченная цена открытию не мешает, но обнаруживается проверкой
+	bytes[MenuSnapshot::kHeaderSize] ^= 0x40;
+	std::ofstream(filename, std::ios::binary).write(bytes.data(), bytes.size());
+	{
+		MappedSnapshot snapshot(filename);
+		EXPECT_FALSE(snapshot.verify());
+	}
+	std::remove(filename.c_str());
+}
\ No newline at end of file
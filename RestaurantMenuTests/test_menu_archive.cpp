@@ -0,0 +1,120 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/menu_archive.h"
+#include "../RestaurantMenu/menu_files.h"
+#include "../RestaurantMenu/storage.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+/// Тестирование сохранения и загрузки архива без потерь, включая цены не в целых копейках
+TEST(MenuArchiveTest, RoundTrip) {
+	MenuStorage source;
+	source.addDish("Пицца Маргарита", 12.34, Time(0, 45));
+	source.addDish("Пицца Пепперони", 0.1, Time(5, 7, 3, 2));
+	source.addDish("Пицца", 1.0 / 3.0, Time(0, 0));
+	source.addDish("", 99999.99, Time(1, 0));
+	source.addDish("Чай", -2.5, Time(0, 5));
+
+	const std::string filename = "test_archive.rma";
+	// Блоки по две строки: несколько блоков, один из них с ценой double без округления
+	MenuArchive::save(source.getDishes(), filename, 2);
+	EXPECT_TRUE(MenuArchive::isArchive(filename));
+
+	MenuStorage loaded;
+	MenuArchive::LoadStats stats = MenuArchive::load(filename, loaded);
+	EXPECT_EQ(stats.blocks, 3u);
+	EXPECT_EQ(stats.rowsLoaded, 5u);
+	ASSERT_EQ(loaded.getDishesCount(), 5u);
+	for (const auto& dish : source.getDishes()) {
+		bool found = false;
+		for (const auto& other : loaded.getDishes()) {
+			found = found || (other.name == dish.name && other.price == dish.price && other.time == dish.time);
+		}
+		EXPECT_TRUE(found) << dish.name;
+	}
+	std::remove(filename.c_str());
+}
+
+/// Тестирование пропуска блоков, границы которых исключают условие
+TEST(MenuArchiveTest, SkipsBlocksByStatistics) {
+	// Цена растет вместе с названием, поэтому у каждого блока свой диапазон цен
+	std::vector<Dish> dishes;
+	for (int i = 0; i < 1000; ++i) {
+		char name[16];
+		std::snprintf(name, sizeof(name), "Блюдо %04d", i);
+		dishes.emplace_back(name, 1.0 + i, Time(0, i % 60));
+	}
+	const std::string filename = "test_archive_filter.rma";
+	MenuArchive::save(dishes, filename, 100);
+
+	MenuStorage loaded;
+	MenuArchive::LoadStats stats = MenuArchive::load(filename, loaded,
+		DishPredicate::priceBelow(151.0) && DishPredicate::timeBelow(Time(0, 10)));
+	EXPECT_EQ(stats.blocks, 10u);
+	EXPECT_EQ(stats.blocksRead, 2u);
+	EXPECT_EQ(stats.rowsScanned, 200u);
+	EXPECT_EQ(stats.rowsLoaded, 30u);
+	EXPECT_EQ(loaded.getDishesCount(), 30u);
+
+	// Условие по названию границами блока не отсекается
+	MenuStorage named;
+	stats = MenuArchive::load(filename, named, DishPredicate::namePrefix("Блюдо 09"));
+	EXPECT_EQ(stats.blocksRead, 10u);
+	EXPECT_EQ(stats.rowsLoaded, 100u);
+	std::remove(filename.c_str());
+}
+
+/// Тестирование сжатия: общие начала названий и небольшие разности чисел
+TEST(MenuArchiveTest, SmallerThanText) {
+	std::vector<Dish> dishes;
+	for (int i = 0; i < 5000; ++i) {
+		dishes.emplace_back("Салат овощной сезонный №" + std::to_string(i), 5.0 + (i % 100) * 0.25, Time(0, 10 + i % 30));
+	}
+	const std::string textFile = "test_archive_text.txt";
+	const std::string archiveFile = "test_archive_size.rma";
+	MenuTextFile::save(dishes, textFile);
+	MenuArchive::save(dishes, archiveFile);
+
+	std::ifstream text(textFile, std::ios::binary | std::ios::ate);
+	std::ifstream archive(archiveFile, std::ios::binary | std::ios::ate);
+	EXPECT_LT(archive.tellg() * 4, text.tellg());
+	text.close();
+	archive.close();
+	std::remove(textFile.c_str());
+	std::remove(archiveFile.c_str());
+}
+
+/// Тестирование отказа загружать поврежденный архив без изменения хранилища
+TEST(MenuArchiveTest, RejectsCorruption) {
+	std::vector<Dish> dishes = { Dish("Чай", 2.5, Time(0, 5)), Dish("Кофе", 3.0, Time(0, 7)) };
+	const std::string filename = "test_archive_bad.rma";
+	MenuArchive::save(dishes, filename, 1);
+
+	std::string bytes;
+	{
+		std::ifstream in(filename, std::ios::binary);
+		bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	// Испорчен последний байт данных второго блока
+	std::string corrupted = bytes;
+	corrupted[corrupted.size() - 1] ^= 0x01;
+	std::ofstream(filename, std::ios::binary).write(corrupted.data(), corrupted.size());
+	MenuStorage storage;
+	EXPECT_THROW(MenuArchive::load(filename, storage), std::runtime_error);
+	EXPECT_EQ(storage.getDishesCount(), 0u);
+
+	// Испорчен каталог
+	corrupted = bytes;
+	corrupted[MenuArchive::kHeaderSize + 20] ^= 0x01;
+	std::ofstream(filename, std::ios::binary).write(corrupted.data(), corrupted.size());
+	EXPECT_THROW(MenuArchive::load(filename, storage), std::runtime_error);
+
+	// Обрезанный файл
+	std::ofstream(filename, std::ios::binary).write(bytes.data(), bytes.size() - 1);
+	EXPECT_THROW(MenuArchive::load(filename, storage), std::runtime_error);
+
+	std::ofstream(filename) << "\"Чай\" 2.50 0:05\n";
+	EXPECT_FALSE(MenuArchive::isArchive(filename));
+	std::remove(filename.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/menu_diff.h"
+#include "../RestaurantMenu/storage.h"
+#include <cstdio>
+#include <fstream>
+
+// Сортирует копию меню по алфавиту, как loadSorted
+static std::vector<Dish> sorted(std::vector<Dish> dishes) {
+	MenuSorter().sortAlphabetically(dishes);
+	return dishes;
+}
+
+/// Тестирование классификации: неизменные, добавленные, удаленные и изменившиеся блюда
+TEST(MenuDiffTest, Compare) {
+	std::vector<Dish> before = sorted({
+		Dish("Борщ", 12.5, Time(0, 45)),
+		Dish("Чай", 2.0, Time(0, 5)),
+		Dish("Чай", 2.0, Time(0, 5)),
+		Dish("Суп", 5.0, Time(0, 20))
+	});
+	std::vector<Dish> after = sorted({
+		Dish("Чай", 2.0, Time(0, 5)),
+		Dish("Борщ", 13.0, Time(0, 45)),
+		Dish("Кофе", 3.5, Time(0, 7)),
+		Dish("Суп", 5.0, Time(0, 20))
+	});
+
+	MenuDiff::Result diff = MenuDiff::compare(before, after);
+	EXPECT_EQ(diff.unchanged, 2u);
+	ASSERT_EQ(diff.added.size(), 1u);
+	EXPECT_EQ(after[diff.added[0]].name, "Кофе");
+	ASSERT_EQ(diff.removed.size(), 1u);
+	EXPECT_EQ(before[diff.removed[0]].name, "Чай");
+	ASSERT_EQ(diff.changed.size(), 1u);
+	EXPECT_EQ(before[diff.changed[0].first].price, 12.5);
+	EXPECT_EQ(after[diff.changed[0].second].price, 13.0);
+}
+
+/// Тестирование политик слияния и порядка результата без пересортировки
+TEST(MenuDiffTest, MergePolicies) {
+	std::vector<Dish> first = sorted({ Dish("Борщ", 12.5, Time(0, 45)), Dish("Суп", 5.0, Time(0, 20)) });
+	std::vector<Dish> second = sorted({ Dish("Борщ", 11.0, Time(0, 40)), Dish("Кофе", 3.5, Time(0, 7)), Dish("Суп", 5.0, Time(0, 20)) });
+	MenuDiff::Result diff = MenuDiff::compare(first, second);
+
+	auto names = [](const std::vector<Dish>& dishes) {
+		std::vector<std::string> result;
+		for (const auto& dish : dishes) result.push_back(dish.name);
+		return result;
+	};
+
+	std::vector<Dish> merged = MenuDiff::merge(first, second, diff, MenuDiff::Policy::First);
+	EXPECT_EQ(names(merged), (std::vector<std::string>{ "Борщ", "Кофе", "Суп" }));
+	EXPECT_EQ(merged[0].price, 12.5);
+
+	merged = MenuDiff::merge(first, second, diff, MenuDiff::Policy::Second);
+	EXPECT_EQ(merged[0].price, 11.0);
+
+	merged = MenuDiff::merge(first, second, diff, MenuDiff::Policy::Cheaper);
+	EXPECT_EQ(merged[0].price, 11.0);
+	EXPECT_EQ(merged.size(), 3u);
+
+	merged = MenuDiff::merge(first, second, diff, MenuDiff::Policy::Both);
+	EXPECT_EQ(names(merged), (std::vector<std::string>{ "Борщ", "Борщ", "Кофе", "Суп" }));
+
+	MenuDiff::Policy policy;
+	EXPECT_TRUE(MenuDiff::parsePolicy("cheaper", policy));
+	EXPECT_EQ(policy, MenuDiff::Policy::Cheaper);
+	EXPECT_FALSE(MenuDiff::parsePolicy("ours", policy));
+}
+
+/// Тестирование загрузки текстового файла с подсчетом невалидных строк
+TEST(MenuDiffTest, LoadSorted) {
+	const std::string filename = "test_diff.txt";
+	std::ofstream(filename) << "\"Суп\" 5.00 0:20\nмусор\n\"Борщ\" 12.50 0:45\n";
+	int invalid = 0;
+	std::vector<Dish> dishes = MenuDiff::loadSorted(filename, invalid);
+	EXPECT_EQ(invalid, 1);
+	ASSERT_EQ(dishes.size(), 2u);
+	EXPECT_EQ(dishes[0].name, "Борщ");
+	EXPECT_EQ(dishes[1].name, "Суп");
+	std::remove(filename.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/menu_files.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+// Читает файл целиком
+static std::string readAll(const std::string& filename) {
+	std::ifstream in(filename, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+/// Тестирование того, что прерванная запись не портит целевой файл
+TEST(MenuFilesTest, AtomicFileKeepsOldContentUntilCommit) {
+	const std::string filename = "test_atomic.txt";
+	std::ofstream(filename, std::ios::binary) << "old";
+
+	std::string tempPath;
+	{
+		AtomicFile file(filename, true);
+		tempPath = file.tempPath();
+		file.write("new content", 11);
+		// Без commit() - как при исключении посередине сохранения
+	}
+	EXPECT_EQ(readAll(filename), "old");
+	EXPECT_FALSE(std::ifstream(tempPath).is_open());
+
+	{
+		AtomicFile file(filename, true);
+		tempPath = file.tempPath();
+		file.write("new content", 11);
+		file.commit();
+	}
+	EXPECT_EQ(readAll(filename), "new content");
+	EXPECT_FALSE(std::ifstream(tempPath).is_open());
+	std::remove(filename.c_str());
+}
+
+/// Тестирование того, что одновременные записи в один файл не делят временный файл
+TEST(MenuFilesTest, AtomicFileTempPathsAreUnique) {
+	const std::string filename = "test_atomic_unique.txt";
+	{
+		AtomicFile first(filename, true);
+		AtomicFile second(filename, true);
+		EXPECT_NE(first.tempPath(), second.tempPath());
+		first.write("first", 5);
+		second.write("second", 6);
+		first.commit();
+		second.commit();
+	}
+	EXPECT_EQ(readAll(filename), "second");
+	std::remove(filename.c_str());
+}
+
+/// Тестирование фонового сохранения и сообщения об ошибке
+TEST(MenuFilesTest, BackgroundSaver) {
+	BackgroundSaver saver;
+	std::vector<Dish> dishes = { Dish("Чай", 2.5, Time(0, 5)), Dish("Борщ", 12.0, Time(0, 45)) };
+
+	saver.start(dishes, "test_background.txt", false);
+	saver.start(dishes, "no_such_directory/menu.txt", true);
+	saver.wait();
+	EXPECT_EQ(saver.pending(), 0u);
+	EXPECT_FALSE(saver.isSaving("test_background.txt"));
+
+	auto results = saver.takeResults();
+	ASSERT_EQ(results.size(), 2u);
+	EXPECT_EQ(results[0].filename, "test_background.txt");
+	EXPECT_EQ(results[0].count, 2u);
+	EXPECT_TRUE(results[0].error.empty());
+	EXPECT_FALSE(results[1].error.empty());
+	EXPECT_TRUE(saver.takeResults().empty());
+
+	EXPECT_EQ(readAll("test_background.txt"), "\"Чай\" 2.50 0:05\n\"Борщ\" 12.00 0:45\n");
+	std::remove("test_background.txt");
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/menu_snapshot.h"
+#include "../RestaurantMenu/storage.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+/// Тестирование сохранения и загрузки снимка без потерь
+TEST(MenuSnapshotTest, RoundTrip) {
+	MenuStorage source;
+	source.addDish("Борщ", 12.34, Time(0, 45));
+	source.addDish("Суп \"Дня\"", 0.1, Time(5, 7, 3, 2));
+	source.addDish("", 99999.99, Time(0, 0));
+
+	const std::string filename = "test_snapshot.bin";
+	MenuSnapshot::save(source.getDishes(), filename);
+	EXPECT_TRUE(MenuSnapshot::isSnapshot(filename));
+
+	MenuStorage loaded;
+	EXPECT_EQ(MenuSnapshot::load(filename, loaded), 3u);
+	ASSERT_EQ(loaded.getDishesCount(), 3u);
+	for (size_t i = 0; i < 3; ++i) {
+		EXPECT_EQ(loaded.getDishes()[i].name, source.getDishes()[i].name);
+		EXPECT_EQ(loaded.getDishes()[i].price, source.getDishes()[i].price);
+		EXPECT_TRUE(loaded.getDishes()[i].time == source.getDishes()[i].time);
+	}
+	std::remove(filename.c_str());
+}
+
+/// Тестирование отказа загружать поврежденный или обрезанный снимок
+TEST(MenuSnapshotTest, RejectsCorruption) {
+	MenuStorage source;
+	source.addDish("Чай", 2.5, Time(0, 5));
+	const std::string filename = "test_snapshot_bad.bin";
+	MenuSnapshot::save(source.getDishes(), filename);
+
+	std::string bytes;
+	{
+		std::ifstream in(filename, std::ios::binary);
+		bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+
+	// Испорченный байт цены
+	std::string corrupted = bytes;
+	corrupted[MenuSnapshot::kHeaderSize] ^= 0x40;
+	std::ofstream(filename, std::ios::binary).write(corrupted.data(), corrupted.size());
+	MenuStorage storage;
+	EXPECT_THROW(MenuSnapshot::load(filename, storage), std::runtime_error);
+	EXPECT_EQ(storage.getDishesCount(), 0u);
+
+	// Обрезанный файл
+	std::ofstream(filename, std::ios::binary).write(bytes.data(), bytes.size() - 1);
+	EXPECT_THROW(MenuSnapshot::load(filename, storage), std::runtime_error);
+
+	// Огромный размер таблицы названий в заголовке (контрольная сумма заголовок не покрывает)
+	corrupted = bytes;
+	std::fill(corrupted.begin() + 24, corrupted.begin() + 32, '\xFF');
+	std::ofstream(filename, std::ios::binary).write(corrupted.data(), corrupted.size());
+	EXPECT_THROW(MenuSnapshot::load(filename, storage), std::runtime_error);
+	EXPECT_EQ(storage.getDishesCount(), 0u);
+
+	// Текстовый файл меню снимком не считается
+	std::ofstream(filename) << "\"Чай\" 2.50 0:05\n";
+	EXPECT_FALSE(MenuSnapshot::isSnapshot(filename));
+	std::remove(filename.c_str());
+}
+
+/// Тестирование загрузки снимка версии 1 с длинами названий вместо концов
+TEST(MenuSnapshotTest, LoadsVersion1) {
+	const std::string name = "Чай";
+	const double price = 2.5;
+	const int64_t minutes = 5;
+	const uint32_t length = static_cast<uint32_t>(name.size());
+	std::string payload;
+	payload.append(reinterpret_cast<const char*>(&price), sizeof(price));
+	payload.append(reinterpret_cast<const char*>(&minutes), sizeof(minutes));
+	payload.append(reinterpret_cast<const char*>(&length), sizeof(length));
+	payload.append(name);
+
+	const uint32_t version = 1;
+	const uint32_t byteOrderMark = 0x01020304;
+	const uint64_t count = 1;
+	const uint64_t namesSize = name.size();
+	const uint64_t checksum = MenuSnapshot::checksum(payload.data(), payload.size());
+	std::string header("RMENUSNP");
+	header.append(reinterpret_cast<const char*>(&version), sizeof(version));
+	header.append(reinterpret_cast<const char*>(&byteOrderMark), sizeof(byteOrderMark));
+	header.append(reinterpret_cast<const char*>(&count), sizeof(count));
+	header.append(reinterpret_cast<const char*>(&namesSize), sizeof(namesSize));
+	header.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+
+	const std::string filename = "test_snapshot_v1.bin";
+	std::ofstream(filename, std::ios::binary) << header << payload;
+	MenuStorage loaded;
+	EXPECT_EQ(MenuSnapshot::load(filename, loaded), 1u);
+	ASSERT_EQ(loaded.getDishesCount(), 1u);
+	EXPECT_EQ(loaded.getDishes()[0].name, name);
+	EXPECT_EQ(loaded.getDishes()[0].price, price);
+	EXPECT_EQ(loaded.getDishes()[0].totalMinutes(), minutes);
+	std::remove(filename.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/menu_stats.h"
+#include <algorithm>
+#include <random>
+
+/// Тестирование агрегатов при добавлении и удалении блюд
+TEST(MenuStatsTest, AddAndRemove) {
+	MenuStats stats;
+	Dish soup("Суп", 5.0, Time(0, 20));
+	Dish steak("Стейк", 60.0, Time(0, 50));
+	Dish tea("Чай", 2.5, Time(0, 5));
+	stats.add(soup);
+	stats.add(steak);
+	stats.add(tea);
+
+	EXPECT_EQ(stats.count(), 3);
+	EXPECT_DOUBLE_EQ(stats.minPrice(), 2.5);
+	EXPECT_DOUBLE_EQ(stats.maxPrice(), 60.0);
+	EXPECT_DOUBLE_EQ(stats.meanPrice(), 67.5 / 3);
+	EXPECT_EQ(stats.minMinutes(), 5);
+	EXPECT_EQ(stats.maxMinutes(), 50);
+
+	// После удаления максимума минимум и максимум пересчитываются без просмотра меню
+	stats.remove(steak);
+	EXPECT_EQ(stats.count(), 2);
+	EXPECT_DOUBLE_EQ(stats.maxPrice(), 5.0);
+	EXPECT_EQ(stats.maxMinutes(), 20);
+	EXPECT_DOUBLE_EQ(stats.meanMinutes(), 12.5);
+
+	// Гистограмма цен: корзины "< 5" и "5 - 10"
+	EXPECT_EQ(stats.priceHistogram().counts()[0], 1);
+	EXPECT_EQ(stats.priceHistogram().counts()[1], 1);
+
+	stats.clear();
+	EXPECT_EQ(stats.count(), 0);
+	EXPECT_DOUBLE_EQ(stats.maxPrice(), 0.0);
+}
+
+/// Тестирование объединения частей: результат совпадает с агрегатами всего меню
+TEST(MenuStatsTest, MergeShards) {
+	std::mt19937 random(3);
+	std::uniform_int_distribution<int> centsDistribution(100, 20000);
+	std::uniform_int_distribution<int> minutesDistribution(1, 300);
+
+	MenuStats whole;
+	MenuStats shards[4];
+	for (int i = 0; i < 1000; ++i) {
+		int minutes = minutesDistribution(random);
+		Dish dish("Блюдо", centsDistribution(random) / 100.0, Time(minutes / 60, minutes % 60));
+		whole.add(dish);
+		shards[i % 4].add(dish);
+	}
+	for (int i = 1; i < 4; ++i) {
+		shards[0].merge(shards[i]);
+	}
+
+	EXPECT_EQ(shards[0].count(), whole.count());
+	EXPECT_DOUBLE_EQ(shards[0].meanPrice(), whole.meanPrice());
+	EXPECT_DOUBLE_EQ(shards[0].minPrice(), whole.minPrice());
+	EXPECT_EQ(shards[0].maxMinutes(), whole.maxMinutes());
+	EXPECT_EQ(shards[0].priceHistogram().counts(), whole.priceHistogram().counts());
+	EXPECT_DOUBLE_EQ(shards[0].priceQuantile(0.9), whole.priceQuantile(0.9));
+}
+
+/// Тестирование точности эскиза квантилей: относительная ошибка не больше заданной
+TEST(MenuStatsTest, QuantileSketchAccuracy) {
+	QuantileSketch sketch(0.01);
+	std::vector<double> values;
+	for (int i = 1; i <= 10000; ++i) {
+		values.push_back(i * 0.37);
+		sketch.add(i * 0.37);
+	}
+	std::sort(values.begin(), values.end());
+
+	for (double q : { 0.1, 0.5, 0.9, 0.99 }) {
+		double exact = values[static_cast<size_t>(q * (values.size() - 1))];
+		EXPECT_NEAR(sketch.quantile(q), exact, exact * 0.01) << q;
+	}
+
+	// Удаление возвращает эскиз к прежнему состоянию
+	sketch.add(1e6);
+	sketch.remove(1e6);
+	EXPECT_EQ(sketch.count(), values.size());
+	EXPECT_LT(sketch.quantile(1.0), 1e6);
+}
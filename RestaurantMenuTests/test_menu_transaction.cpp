@@ -0,0 +1,48 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/menu_transaction.h"
+
+/// Тестирование отмены отложенных добавлений удалениями той же транзакции
+TEST(MenuTransactionTest, RemoveCancelsPendingAdds) {
+	MenuTransaction transaction;
+	EXPECT_TRUE(transaction.empty());
+
+	transaction.add("Суп", 5.0, Time(0, 10));
+	transaction.add("Суп", 5.0, Time(0, 10));
+	transaction.add("Суп", 6.0, Time(0, 10));
+	transaction.add("Чай", 1.0, Time(0, 5));
+	EXPECT_EQ(transaction.size(), 4u);
+
+	// Удаление по точному совпадению отменяет обе копии, но не суп с другой ценой
+	EXPECT_EQ(transaction.remove("Суп", 5.0004, Time(0, 10)), 2u);
+	// Удаление по названию отменяет оставшиеся добавления с этим названием
+	EXPECT_EQ(transaction.removeName("Суп"), 1u);
+	EXPECT_EQ(transaction.removeName("Суп"), 0u);
+
+	// Добавление после удаления остается в силе
+	transaction.add("Суп", 7.0, Time(0, 15));
+
+	std::vector<Dish> added = transaction.takeAdded();
+	ASSERT_EQ(added.size(), 2u);
+	EXPECT_EQ(added[0].name, "Чай");
+	EXPECT_DOUBLE_EQ(added[1].price, 7.0);
+	EXPECT_EQ(transaction.removed().size(), 1u);
+	EXPECT_EQ(transaction.removedNames().size(), 1u);
+}
+
+/// Тестирование проверки блюд хранилища отложенными удалениями
+TEST(MenuTransactionTest, RemovesMatchesStorageDishes) {
+	MenuTransaction transaction;
+	EXPECT_FALSE(transaction.hasRemovals());
+	EXPECT_FALSE(transaction.removes(Dish("Суп", 5.0, Time(0, 10))));
+
+	transaction.remove("Суп", 5.0, Time(0, 10));
+	transaction.removeName("Чай");
+	EXPECT_TRUE(transaction.hasRemovals());
+
+	EXPECT_TRUE(transaction.removes(Dish("Суп", 5.0, Time(0, 10))));
+	EXPECT_FALSE(transaction.removes(Dish("Суп", 5.0, Time(0, 11))));
+	EXPECT_FALSE(transaction.removes(Dish("Суп", 5.5, Time(0, 10))));
+	EXPECT_FALSE(transaction.removes(Dish("суп", 5.0, Time(0, 10))));
+	EXPECT_TRUE(transaction.removes(Dish("Чай", 1.0, Time(0, 5))));
+	EXPECT_TRUE(transaction.removes(Dish("Чай", 2.0, Time(1, 0))));
+}
\ No newline at end of file
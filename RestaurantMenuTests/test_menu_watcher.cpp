@@ -0,0 +1,69 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/menu_watcher.h"
+#include <cstdio>
+#include <fstream>
+
+/// Тестирование разницы строк: правка на месте, перестановка и повторяющиеся строки
+TEST(MenuWatcherTest, DiffLines) {
+	std::vector<std::string> removed, added;
+	size_t compared = 0;
+	MenuFileWatcher::diffLines("A\nB\nC\n", "A\nX\nC\n", removed, added, &compared);
+	EXPECT_EQ(removed, (std::vector<std::string>{ "B" }));
+	EXPECT_EQ(added, (std::vector<std::string>{ "X" }));
+	// Общие начало и конец не сравниваются построчно
+	EXPECT_EQ(compared, 2u);
+
+	// Правка в начале строки, конец которой совпадает со следующей
+	removed.clear();
+	added.clear();
+	MenuFileWatcher::diffLines("A\nB\n", "A\nXB\n", removed, added);
+	EXPECT_EQ(removed, (std::vector<std::string>{ "B" }));
+	EXPECT_EQ(added, (std::vector<std::string>{ "XB" }));
+
+	// Перемещенная строка и пустые строки изменением не считаются
+	removed.clear();
+	added.clear();
+	MenuFileWatcher::diffLines("A\nB\nC\n", "C\n\nA\nB\n", removed, added);
+	EXPECT_TRUE(removed.empty());
+	EXPECT_TRUE(added.empty());
+
+	// Удаление одной из двух одинаковых строк и дописывание в конец без перевода строки
+	removed.clear();
+	added.clear();
+	MenuFileWatcher::diffLines("A\nA\nB", "A\nB\nD", removed, added);
+	EXPECT_EQ(removed, (std::vector<std::string>{ "A" }));
+	EXPECT_EQ(added, (std::vector<std::string>{ "D" }));
+
+	removed.clear();
+	added.clear();
+	MenuFileWatcher::diffLines("A\nB\n", "A\nB\n", removed, added, &compared);
+	EXPECT_TRUE(removed.empty() && added.empty());
+	EXPECT_EQ(compared, 0u);
+}
+
+/// Тестирование проверки файла: изменения разбираются в блюда, невалидные строки считаются
+TEST(MenuWatcherTest, PollParsesChangedLines) {
+	const std::string filename = "test_watch.txt";
+	std::ofstream(filename) << "\"Борщ\" 12.50 0:45\n\"Чай\" 2.00 0:05\n";
+
+	MenuFileWatcher watcher;
+	watcher.watch(filename);
+	EXPECT_TRUE(watcher.active());
+	MenuFileWatcher::Changes changes;
+	EXPECT_FALSE(watcher.poll(changes));
+
+	std::ofstream(filename) << "\"Борщ\" 12.50 0:45\n\"Кофе\" 3.50 0:07\nмусор\n";
+	ASSERT_TRUE(watcher.poll(changes));
+	ASSERT_EQ(changes.removed.size(), 1u);
+	EXPECT_EQ(changes.removed[0].name, "Чай");
+	ASSERT_EQ(changes.added.size(), 1u);
+	EXPECT_EQ(changes.added[0].name, "Кофе");
+	EXPECT_EQ(changes.added[0].price, 3.5);
+	EXPECT_EQ(changes.invalidAdded, 1);
+	EXPECT_EQ(changes.invalidRemoved, 0);
+	EXPECT_FALSE(watcher.poll(changes));
+
+	watcher.stop();
+	EXPECT_FALSE(watcher.active());
+	std::remove(filename.c_str());
+}
\ No newline at end of file
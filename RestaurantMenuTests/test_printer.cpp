@@ -0,0 +1,107 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/printer.h"
+#include <sstream>
+
+/// Поток-приемник, считающий количество операций записи
+class CountingStreamBuf : public std::streambuf {
+public:
+	std::string data;
+	size_t writes = 0;
+
+protected:
+	int_type overflow(int_type ch) override {
+		writes++;
+		data.push_back(traits_type::to_char_type(ch));
+		return ch;
+	}
+
+	std::streamsize xsputn(const char* s, std::streamsize count) override {
+		writes++;
+		data.append(s, static_cast<size_t>(count));
+		return count;
+	}
+};
+
+/// Тестирование вывода отфильтрованных блюд в указанный поток
+TEST(MenuPrinterTest, PrintFilteredDishes) {
+	std::ostringstream out;
+	MenuPrinter printer(out);
+	std::vector<Dish> dishes;
+	dishes.push_back(Dish("Суп", 5.0, Time(0, 20)));
+	dishes.push_back(Dish("Чай", 2.5, Time(0, 5)));
+
+	printer.printFilteredDishes(dishes, "Заголовок");
+
+	std::string text = out.str();
+	EXPECT_NE(text.find("Заголовок"), std::string::npos);
+	EXPECT_NE(text.find("1. Суп"), std::string::npos);
+	EXPECT_NE(text.find("2. Чай"), std::string::npos);
+	EXPECT_NE(text.find("2.50"), std::string::npos);
+}
+
+/// Тестирование буферизации: большое меню уходит в поток несколькими крупными блоками
+TEST(MenuPrinterTest, BulkOutputUsesFewWrites) {
+	CountingStreamBuf sink;
+	std::ostream out(&sink);
+	MenuPrinter printer(out);
+
+	std::vector<Dish> dishes(20000, Dish("Блюдо", 10.0, Time(0, 30)));
+	printer.printAllDishes(dishes, 0);
+
+	EXPECT_NE(sink.data.find("20000. Блюдо"), std::string::npos);
+	// Около 1 МБ текста при пороге сброса 1 МБ
+	EXPECT_LE(sink.writes, 4);
+}
+
+/// Тестирование буфера вывода: сброс по порогу и по явному вызову
+TEST(OutputBufferTest, FlushThreshold) {
+	CountingStreamBuf sink;
+	std::ostream out(&sink);
+	OutputBuffer buffer(out, 8);
+
+	buffer.append("abc");
+	EXPECT_EQ(sink.writes, 0);
+	buffer.append("defgh");
+	EXPECT_EQ(sink.writes, 1);
+	EXPECT_EQ(buffer.size(), 0);
+
+	buffer.append('x');
+	buffer.flush();
+	EXPECT_EQ(sink.data, "abcdefghx");
+}
+
+
+/// Тестирование постраничного вывода: форматируются только строки запрошенной страницы
+TEST(MenuPrinterTest, PrintPage) {
+	std::ostringstream out;
+	MenuPrinter printer(out);
+	std::vector<Dish> dishes;
+	for (int i = 0; i < 25; ++i) {
+		dishes.push_back(Dish("Блюдо " + std::to_string(i + 1), 10.0 + i, Time(0, 30)));
+	}
+
+	printer.printPage(dishes, 2, 10, "Меню");
+	std::string text = out.str();
+	EXPECT_EQ(text.find("Блюдо 10 "), std::string::npos);
+	EXPECT_NE(text.find("11. Блюдо 11"), std::string::npos);
+	EXPECT_NE(text.find("20. Блюдо 20"), std::string::npos);
+	EXPECT_EQ(text.find("Блюдо 21"), std::string::npos);
+	EXPECT_NE(text.find("Страница 2 из 3"), std::string::npos);
+
+	// Страница за пределами списка
+	out.str("");
+	printer.printPage(dishes, 4, 10, "Меню");
+	EXPECT_NE(out.str().find("не существует"), std::string::npos);
+
+	// Заранее отобранная страница нумеруется по всему списку
+	out.str("");
+	printer.printPageRows(std::vector<Dish>(dishes.begin() + 20, dishes.end()), 3, 10, dishes.size(), "Меню");
+	text = out.str();
+	EXPECT_NE(text.find("21. Блюдо 21"), std::string::npos);
+	EXPECT_NE(text.find("25. Блюдо 25"), std::string::npos);
+	EXPECT_NE(text.find("Страница 3 из 3 (блюда 21-25 из 25)"), std::string::npos);
+
+	out.str("");
+	printer.printPageRows({}, 4, 10, dishes.size(), "Меню");
+	EXPECT_NE(out.str().find("не существует, всего страниц: 3"), std::string::npos);
+}
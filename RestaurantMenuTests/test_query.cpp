@@ -0,0 +1,105 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/query.h"
+#include "../RestaurantMenu/storage.h"
+
+/// Тестовое меню, отсортированное по алфавиту
+static std::vector<Dish> makeSortedMenu() {
+	std::vector<Dish> dishes;
+	dishes.push_back(Dish("Борщ", 12.0, Time(0, 40)));
+	dishes.push_back(Dish("Пельмени", 9.5, Time(0, 25)));
+	dishes.push_back(Dish("Пицца Маргарита", 15.0, Time(0, 30)));
+	dishes.push_back(Dish("Пицца Пепперони", 18.0, Time(0, 35)));
+	dishes.push_back(Dish("Салат Цезарь", 11.0, Time(0, 15)));
+	MenuSorter().sortAlphabetically(dishes);
+	return dishes;
+}
+
+/// Тестирование комбинирования условий через И/ИЛИ
+TEST(MenuQueryTest, ComposedPredicates) {
+	auto dishes = makeSortedMenu();
+
+	// (цена < 12 И время < 0:30) ИЛИ название содержит "пепперони"
+	auto result = MenuQuery()
+		.where((DishPredicate::priceBelow(12.0) && DishPredicate::timeBelow(Time(0, 30))) ||
+			DishPredicate::nameContains("пепперони"))
+		.orderBy(QueryOrder::Name)
+		.execute(dishes);
+
+	ASSERT_EQ(result.size(), 3);
+	EXPECT_EQ(result[0].name, "Пельмени");
+	EXPECT_EQ(result[1].name, "Пицца Пепперони");
+	EXPECT_EQ(result[2].name, "Салат Цезарь");
+}
+
+/// Тестирование диапазонов и пересечения диапазонов внутри И
+TEST(MenuQueryTest, RangesAreIntersected) {
+	auto dishes = makeSortedMenu();
+
+	auto result = MenuQuery()
+		.where(DishPredicate::priceBetween(10.0, 20.0) && DishPredicate::priceBelow(15.0))
+		.orderBy(QueryOrder::PriceDesc)
+		.execute(dishes);
+
+	ASSERT_EQ(result.size(), 2);
+	EXPECT_DOUBLE_EQ(result[0].price, 12.0);
+	EXPECT_DOUBLE_EQ(result[1].price, 11.0);
+}
+
+/// Тестирование ORDER BY с LIMIT
+TEST(MenuQueryTest, OrderByWithLimit) {
+	auto dishes = makeSortedMenu();
+
+	auto result = MenuQuery().orderBy(QueryOrder::TimeAsc).limit(2).execute(dishes);
+
+	ASSERT_EQ(result.size(), 2);
+	EXPECT_EQ(result[0].totalMinutes(), 15);
+	EXPECT_EQ(result[1].totalMinutes(), 25);
+}
+
+/// Тестирование поиска по префиксу без учета регистра
+TEST(MenuQueryTest, NamePrefixIgnoresCase) {
+	auto dishes = makeSortedMenu();
+
+	auto result = MenuQuery().where(DishPredicate::namePrefix("пиццА")).execute(dishes);
+
+	ASSERT_EQ(result.size(), 2);
+	EXPECT_EQ(result[0].name, "Пицца Маргарита");
+	EXPECT_EQ(result[1].name, "Пицца Пепперони");
+}
+
+/// Тестирование планировщика: индекс по отсортированным названиям дает тот же результат, что и просмотр
+TEST(MenuQueryTest, PlannerUsesSortedNameIndex) {
+	auto dishes = makeSortedMenu();
+	SortedNameIndex index;
+
+	// Индекс сам по себе возвращает только строки с нужным префиксом
+	std::vector<size_t> rows;
+	EXPECT_TRUE(index.lookup(DishPredicate::namePrefix("Пицца"), dishes, rows));
+	EXPECT_EQ(rows.size(), 2);
+
+	// Индекс не применим к условиям по цене
+	rows.clear();
+	EXPECT_FALSE(index.lookup(DishPredicate::priceBelow(10.0), dishes, rows));
+
+	MenuQuery query;
+	query.where(DishPredicate::namePrefix("Пицца") && DishPredicate::priceBelow(16.0));
+	auto indexed = query.selectRows(dishes, { &index });
+	auto scanned = query.selectRows(dishes);
+
+	EXPECT_EQ(indexed, scanned);
+	ASSERT_EQ(indexed.size(), 1);
+	EXPECT_EQ(dishes[indexed[0]].name, "Пицца Маргарита");
+}
+
+/// Тестирование совпадения скомпилированного условия с эталонной проверкой
+TEST(MenuQueryTest, CompiledMatchesReference) {
+	auto dishes = makeSortedMenu();
+	DishPredicate predicate =
+		(DishPredicate::nameEquals("Борщ") || DishPredicate::timeBetween(Time(0, 20), Time(0, 31))) &&
+		(DishPredicate::priceBelow(100.0) || DishPredicate::any());
+	CompiledPredicate compiled(predicate);
+
+	for (const auto& dish : dishes) {
+		EXPECT_EQ(compiled.matches(dish), predicate.matches(dish)) << dish.name;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/sorter.h"
+
+/// Тестирование многоключевой сортировки: цена по убыванию, затем название по алфавиту
+TEST(SorterTest, PriceDescThenName) {
+	std::vector<Dish> dishes;
+	dishes.push_back(Dish("Суп", 10.0, Time(0, 20)));
+	dishes.push_back(Dish("Борщ", 12.0, Time(0, 40)));
+	dishes.push_back(Dish("арбуз", 10.0, Time(0, 5)));
+	dishes.push_back(Dish("Компот", 10.0, Time(0, 10)));
+
+	Sorter<ByPrice<Desc>, ByName<Asc>>::sort(dishes);
+
+	ASSERT_EQ(dishes.size(), 4);
+	EXPECT_EQ(dishes[0].name, "Борщ");
+	EXPECT_EQ(dishes[1].name, "арбуз");
+	EXPECT_EQ(dishes[2].name, "Компот");
+	EXPECT_EQ(dishes[3].name, "Суп");
+}
+
+/// Тестирование ключа времени: сравнение совпадает с Time::operator<, включая дни
+TEST(SorterTest, TimeKeyMatchesTotalMinutes) {
+	Dish quick("Салат", 5.0, Time(23, 59));
+	Dish slow("Окорок", 5.0, Time(0, 0, 1));
+
+	EXPECT_LT((Sorter<ByTime<Asc>>::compare(quick, slow)), 0);
+	EXPECT_GT((Sorter<ByTime<Desc>>::compare(quick, slow)), 0);
+	EXPECT_EQ((Sorter<ByTime<Asc>, ByPrice<Asc>>::compare(quick, quick)), 0);
+}
+
+/// Тестирование реестра: известные порядки находятся, неизвестные - нет
+TEST(SorterTest, RegistryLookup) {
+	std::vector<Dish> dishes;
+	dishes.push_back(Dish("Б", 1.0, Time(0, 30)));
+	dishes.push_back(Dish("А", 2.0, Time(0, 30)));
+	dishes.push_back(Dish("В", 3.0, Time(0, 10)));
+
+	SorterRegistry::SortFunction sort = SorterRegistry::find("time");
+	ASSERT_NE(sort, nullptr);
+	sort(dishes);
+	EXPECT_EQ(dishes[0].name, "В");
+	EXPECT_EQ(dishes[1].name, "А");
+	EXPECT_EQ(dishes[2].name, "Б");
+
+	EXPECT_EQ(SorterRegistry::find("unknown"), nullptr);
+}
\ No newline at end of file
@@ -1,5 +1,12 @@
 ﻿#include <gtest/gtest.h>
 #include "../RestaurantMenu/storage.h"
+#include "../RestaurantMenu/collation.h"
+#include "../RestaurantMenu/file_parser.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <random>
 
 /// Тестирование добавления блюд в хранилище
 TEST(MenuStorageTest, AddDishes) {
@@ -82,6 +89,229 @@ TEST(MenuStorageTest, SaveToFile) {
 	// (это лучше делать в интеграционных тестах)
 }
 
+/// Тестирование того, что сохраненный файл загружается обратно без потерь
+TEST(MenuStorageTest, SaveLoadRoundTrip) {
+	MenuStorage storage;
+	storage.addDish("Борщ", 12.5, Time(0, 45));
+	storage.addDish("Чай", 0.125, Time(0, 5));
+	storage.addDish("Утка по-пекински", 1234.56, Time(5, 7, 3, 1));
+	storage.saveToFile("test_roundtrip.txt");
+
+	MenuStorage loaded;
+	MenuFileParser parser;
+	int invalidCount = 0;
+	parser.parseFile("test_roundtrip.txt", loaded, invalidCount);
+	std::remove("test_roundtrip.txt");
+
+	EXPECT_EQ(invalidCount, 0);
+	ASSERT_EQ(loaded.getDishesCount(), storage.getDishesCount());
+	for (size_t i = 0; i < storage.getDishesCount(); ++i) {
+		EXPECT_EQ(loaded.getDishes()[i].name, storage.getDishes()[i].name);
+		EXPECT_EQ(loaded.getDishes()[i].price, storage.getDishes()[i].price);
+		EXPECT_TRUE(loaded.getDishes()[i].time == storage.getDishes()[i].time);
+	}
+}
+
+/// Сравнение с прежним способом сохранения (std::endl и setprecision на каждой строке). Запуск:
+/// RestaurantMenuTests --gtest_also_run_disabled_tests --gtest_filter=*SaveBenchmark*
+TEST(MenuStorageTest, DISABLED_SaveBenchmark) {
+	const size_t size = 10000000;
+	MenuStorage storage;
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> cents(100, 10000);
+	std::uniform_int_distribution<int> minutes(0, 600);
+	for (size_t i = 0; i < size; ++i) {
+		int total = minutes(random);
+		storage.addDish("Блюдо " + std::to_string(i % 1000), cents(random) / 100.0, Time(total / 60, total % 60));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	{
+		std::ofstream file("bench_old.txt");
+		for (const auto& dish : storage.getDishes()) {
+			file << "\"" << dish.name << "\" " << std::fixed << std::setprecision(2) << dish.price
+				<< " " << dish.getTimeString() << std::endl;
+		}
+	}
+	double oldSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	storage.saveToFile("bench_new.txt");
+	double newSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "Прежнее сохранение: " << oldSeconds << " с, буферизованное: " << newSeconds << " с" << std::endl;
+	std::remove("bench_old.txt");
+	std::remove("bench_new.txt");
+}
+
+/// Тестирование поиска названий по префиксу и подстроке
+TEST(MenuStorageTest, FindNames) {
+	MenuStorage storage;
+	storage.addDish("Пицца Маргарита", 12.0, Time(0, 30));
+	storage.addDish("Пицца Пепперони", 14.0, Time(0, 35));
+	storage.addDish("Суп с пиццей", 8.0, Time(0, 20));
+	storage.addDish("Борщ", 9.0, Time(0, 40));
+
+	// Префикс без учета регистра, названия в алфавитном порядке
+	auto byPrefix = storage.findNamesByPrefix("пицца", 10);
+	ASSERT_EQ(byPrefix.size(), 2);
+	EXPECT_EQ(byPrefix[0], "Пицца Маргарита");
+	EXPECT_EQ(byPrefix[1], "Пицца Пепперони");
+
+	// Подстрока находится в любом месте названия
+	auto bySubstring = storage.findNamesBySubstring("ПИЦ", 10);
+	ASSERT_EQ(bySubstring.size(), 3);
+	EXPECT_EQ(bySubstring[2], "Суп с пиццей");
+
+	// Ограничение количества результатов
+	EXPECT_EQ(storage.findNamesBySubstring("пиц", 1).size(), 1);
+}
+
+/// Тестирование инкрементального обновления индекса названий при удалении
+TEST(MenuStorageTest, FindNamesAfterRemove) {
+	MenuStorage storage;
+	storage.addDish("Борщ", 9.0, Time(0, 40));
+	storage.addDish("Борщ", 11.0, Time(0, 45));
+
+	// Название остается в индексе, пока есть хотя бы одно блюдо
+	storage.removeDish("Борщ", 9.0, Time(0, 40));
+	EXPECT_EQ(storage.findNamesBySubstring("орщ", 10).size(), 1);
+
+	storage.removeDish("Борщ", 11.0, Time(0, 45));
+	EXPECT_TRUE(storage.findNamesBySubstring("орщ", 10).empty());
+	EXPECT_TRUE(storage.findNamesByPrefix("бо", 10).empty());
+}
+
+/// Тестирование нечеткого поиска названий с опечатками
+TEST(MenuStorageTest, FindSimilarNames) {
+	MenuStorage storage;
+	storage.addDish("Борщ", 9.0, Time(0, 40));
+	storage.addDish("Пицца Маргарита", 12.0, Time(0, 30));
+	storage.addDish("Пицца Пепперони", 14.0, Time(0, 35));
+
+	// Одна опечатка в коротком названии
+	auto similar = storage.findSimilarNames("борш", 1, 5);
+	ASSERT_EQ(similar.size(), 1);
+	EXPECT_EQ(similar[0], "Борщ");
+
+	// Две опечатки в длинном названии, ближайшее название первым
+	similar = storage.findSimilarNames("пица маргорита", 2, 5);
+	ASSERT_EQ(similar.size(), 1);
+	EXPECT_EQ(similar[0], "Пицца Маргарита");
+
+	// Слишком много отличий
+	EXPECT_TRUE(storage.findSimilarNames("Пельмени", 2, 5).empty());
+}
+
+/// Тестирование перестроения индекса названий после массового удаления
+TEST(NameIndexTest, CompactionKeepsLiveNames) {
+	NameIndex index;
+	for (int i = 0; i < 3000; ++i) {
+		index.add("Блюдо " + std::to_string(i));
+	}
+	for (int i = 0; i < 3000; i += 2) {
+		index.remove("Блюдо " + std::to_string(i));
+	}
+
+	EXPECT_EQ(index.size(), 1500);
+	auto found = index.findBySubstring("до 299", 100);
+	ASSERT_EQ(found.size(), 6);  // 299, 2991, 2993, 2995, 2997, 2999
+	EXPECT_EQ(found[0], "Блюдо 299");
+}
+
+/// Эталонное расстояние Левенштейна
+static size_t referenceEditDistance(const std::string& a, const std::string& b) {
+	std::vector<size_t> row(b.size() + 1);
+	for (size_t j = 0; j <= b.size(); ++j) row[j] = j;
+	for (size_t i = 1; i <= a.size(); ++i) {
+		size_t diagonal = row[0];
+		row[0] = i;
+		for (size_t j = 1; j <= b.size(); ++j) {
+			size_t above = row[j];
+			row[j] = std::min({ row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1) });
+			diagonal = above;
+		}
+	}
+	return row[b.size()];
+}
+
+/// Тестирование нечеткого поиска коротких запросов (окрестности удалений) против полного перебора
+TEST(NameIndexTest, ShortSimilarQueriesMatchFullScan) {
+	std::mt19937 random(7);
+	auto randomWord = [&](size_t minLength, size_t maxLength) {
+		std::string word(std::uniform_int_distribution<size_t>(minLength, maxLength)(random), 'a');
+		for (auto& c : word) c = static_cast<char>('a' + random() % 3);
+		return word;
+	};
+
+	NameIndex index;
+	std::vector<std::string> names;
+	for (int i = 0; i < 400; ++i) {
+		names.push_back(randomWord(1, 11));
+		index.add(names.back());
+	}
+	// Удаленные и снова добавленные названия не должны теряться или находиться дважды
+	for (int i = 0; i < 100; ++i) {
+		index.remove(names[i]);
+	}
+	std::vector<std::string> alive(names.begin() + 100, names.end());
+	for (int i = 0; i < 50; ++i) {
+		alive.push_back(names[i]);
+		index.add(names[i]);
+	}
+
+	for (int i = 0; i < 200; ++i) {
+		const std::string query = randomWord(1, 7);
+		for (size_t distance = 1; distance <= 3; ++distance) {
+			std::vector<std::string> expected;
+			for (const auto& name : alive) {
+				if (referenceEditDistance(name, query) <= distance) expected.push_back(name);
+			}
+			std::sort(expected.begin(), expected.end());
+			expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+			std::vector<std::string> found = index.findSimilar(query, distance, 1000);
+			std::sort(found.begin(), found.end());
+			EXPECT_EQ(found, expected) << query << ", " << distance;
+		}
+	}
+}
+
+/// Тестирование индекса названий хранилища в планировщике: те же строки, что и полный просмотр
+TEST(NameIndexTest, PlannerUsesStorageIndex) {
+	MenuStorage storage;
+	storage.addDish("Суп грибной", 7.0, Time(0, 30));
+	storage.addDish("Борщ", 12.0, Time(0, 45));
+	storage.addDish("Суп гороховый", 6.0, Time(0, 40));
+	storage.addDish("Чай", 2.5, Time(0, 5));
+	storage.addDish("Борщ", 11.0, Time(0, 40));
+	EXPECT_TRUE(storage.getIndexes().empty());
+
+	storage.sortByName();
+	std::vector<const IDishIndex*> indexes = storage.getIndexes();
+	ASSERT_EQ(indexes.size(), 1u);
+
+	const DishPredicate predicates[] = {
+		DishPredicate::nameEquals("Борщ"),
+		DishPredicate::nameEquals("Компот"),
+		DishPredicate::namePrefix("суп"),
+		DishPredicate::nameContains("ГРИБ"),
+		DishPredicate::nameContains("о") && DishPredicate::priceBelow(10.0)
+	};
+	for (const auto& predicate : predicates) {
+		std::vector<size_t> rows;
+		EXPECT_TRUE(indexes[0]->lookup(predicate.kind == PredicateKind::And ? predicate.children[0] : predicate,
+			storage.getDishes(), rows));
+		EXPECT_EQ(MenuQuery().where(predicate).selectRows(storage.getDishes(), indexes),
+			MenuQuery().where(predicate).selectRows(storage.getDishes()));
+	}
+
+	std::vector<size_t> rows;
+	indexes[0]->lookup(DishPredicate::namePrefix("суп"), storage.getDishes(), rows);
+	EXPECT_EQ(rows.size(), 2u);
+	EXPECT_FALSE(indexes[0]->lookup(DishPredicate::priceBelow(10.0), storage.getDishes(), rows));
+}
+
 /// Тестирование алфавитной сортировки
 TEST(MenuSorterTest, AlphabeticalSort) {
 	MenuSorter sorter;
@@ -101,6 +331,41 @@ TEST(MenuSorterTest, AlphabeticalSort) {
 	EXPECT_EQ(dishes[2].name, "Ц");
 }
 
+/// Тестирование русского порядка сортировки: регистр не учитывается, Ё идет после Е
+TEST(MenuSorterTest, AlphabeticalSortRussianCollation) {
+	MenuSorter sorter;
+	std::vector<Dish> dishes;
+
+	// При побайтовом сравнении эти названия упорядочиваются неверно
+	dishes.push_back(Dish("Жаркое", 15.0, Time(0, 30)));
+	dishes.push_back(Dish("ёжики", 10.0, Time(0, 20)));
+	dishes.push_back(Dish("Вареники", 20.0, Time(0, 45)));
+	dishes.push_back(Dish("Ельцы", 12.0, Time(0, 25)));
+	dishes.push_back(Dish("борщ", 9.0, Time(0, 50)));
+
+	sorter.sortAlphabetically(dishes);
+
+	EXPECT_EQ(dishes[0].name, "борщ");
+	EXPECT_EQ(dishes[1].name, "Вареники");
+	EXPECT_EQ(dishes[2].name, "Ельцы");
+	EXPECT_EQ(dishes[3].name, "ёжики");
+	EXPECT_EQ(dishes[4].name, "Жаркое");
+}
+
+/// Тестирование ключей сопоставления для длинных названий и префиксов
+TEST(MenuSorterTest, CollationKeys) {
+	// Префикс всегда раньше своего продолжения
+	EXPECT_TRUE(Collation::less(Collation::makeKey("Суп"), Collation::makeKey("Суп дня")));
+
+	// Длинные латинские названия сравниваются без учета регистра
+	EXPECT_TRUE(Collation::less(Collation::makeKey("apple pie with cinnamon and cream"),
+		Collation::makeKey("APPLE PIE WITH CINNAMON AND HONEY")));
+
+	// При равенстве без учета регистра порядок детерминирован исходными байтами
+	EXPECT_NE(Collation::makeKey("Суп"), Collation::makeKey("СУП"));
+	EXPECT_EQ(Collation::makeKey("Суп"), Dish("Суп", 1.0, Time()).sortKey);
+}
+
 /// Тестирование сортировки по убыванию цены
 TEST(MenuSorterTest, SortByPriceDesc) {
 	MenuSorter sorter;
@@ -201,4 +466,234 @@ TEST(MenuFilterTest, FilterByPriceAndTime) {
 	EXPECT_EQ(filtered[0].name, "А - быстрое и дешевое");
 	EXPECT_DOUBLE_EQ(filtered[0].price, 10.0);
 	EXPECT_EQ(filtered[0].time.totalMinutes(), 15);
+}
+
+/// Тестирование кэша фильтра: повтор запроса попадает в кэш, затрагивающее изменение сбрасывает запись
+TEST(CachedMenuFilterTest, HitsAndSelectiveInvalidation) {
+	MenuStorage storage;
+	storage.addDish("Суп", 5.0, Time(0, 20));
+	storage.addDish("Стейк", 30.0, Time(0, 50));
+	CachedMenuFilter filter(std::make_unique<MenuFilter>(std::make_unique<MenuSorter>()), storage);
+
+	EXPECT_EQ(filter.filterByPrice(storage.getDishes(), 10.0).size(), 1);
+	EXPECT_EQ(filter.filterByPrice(storage.getDishes(), 10.0).size(), 1);
+	EXPECT_EQ(filter.misses(), 1);
+	EXPECT_EQ(filter.hits(), 1);
+
+	// Дорогое блюдо не попадает под условие - запись остается актуальной
+	storage.addDish("Лобстер", 80.0, Time(1, 0));
+	EXPECT_EQ(filter.filterByPrice(storage.getDishes(), 10.0).size(), 1);
+	EXPECT_EQ(filter.hits(), 2);
+
+	// Дешевое блюдо меняет результат - запись пересчитывается
+	storage.addDish("Чай", 2.0, Time(0, 5));
+	auto result = filter.filterByPrice(storage.getDishes(), 10.0);
+	ASSERT_EQ(result.size(), 2);
+	EXPECT_EQ(result[0].name, "Суп");
+	EXPECT_EQ(filter.misses(), 2);
+
+	// Удаление тоже учитывается
+	storage.removeDish("Суп", 5.0, Time(0, 20));
+	EXPECT_EQ(filter.filterByPrice(storage.getDishes(), 10.0).size(), 1);
+	EXPECT_EQ(filter.misses(), 3);
+}
+
+/// Тестирование журнала изменений хранилища: после очистки старые версии недоступны
+TEST(MenuStorageTest, ChangeJournal) {
+	MenuStorage storage;
+	storage.addDish("Суп", 5.0, Time(0, 20));
+	uint64_t version = storage.getVersion();
+	storage.addDish("Чай", 2.0, Time(0, 5));
+
+	std::vector<Dish> changed;
+	ASSERT_TRUE(storage.getChangesSince(version, changed));
+	ASSERT_EQ(changed.size(), 1);
+	EXPECT_EQ(changed[0].name, "Чай");
+
+	storage.clear();
+	changed.clear();
+	EXPECT_FALSE(storage.getChangesSince(version, changed));
+	EXPECT_TRUE(storage.getChangesSince(storage.getVersion(), changed));
+	EXPECT_TRUE(changed.empty());
+}
+
+/// Тестирование представлений: строки поддерживаются при добавлении, удалении и очистке
+TEST(MenuStorageTest, MaterializedViews) {
+	MenuStorage storage;
+	storage.addDish("Суп", 5.0, Time(0, 20));
+	storage.addDish("Стейк", 60.0, Time(0, 50));
+	storage.defineView("премиум", DishPredicate::priceAbove(50.0));
+	storage.defineView("быстрые", DishPredicate::priceBelow(10.0) && DishPredicate::timeBelow(Time(0, 30)));
+
+	std::vector<Dish> rows;
+	ASSERT_TRUE(storage.getView("премиум", rows));
+	ASSERT_EQ(rows.size(), 1);
+	EXPECT_EQ(rows[0].name, "Стейк");
+
+	storage.addDish("Лобстер", 90.0, Time(1, 0));
+	storage.addDish("Чай", 2.0, Time(0, 5));
+	storage.addDish("Чай", 2.0, Time(0, 5));
+	storage.removeDish("Стейк", 60.0, Time(0, 50));
+
+	ASSERT_TRUE(storage.getView("премиум", rows));
+	ASSERT_EQ(rows.size(), 1);
+	EXPECT_EQ(rows[0].name, "Лобстер");
+
+	// Удаление убирает из представления все удаленные копии блюда
+	ASSERT_TRUE(storage.getView("быстрые", rows));
+	EXPECT_EQ(rows.size(), 3);
+	storage.removeDish("Чай", 2.0, Time(0, 5));
+	ASSERT_TRUE(storage.getView("быстрые", rows));
+	ASSERT_EQ(rows.size(), 1);
+	EXPECT_EQ(rows[0].name, "Суп");
+
+	storage.clear();
+	ASSERT_TRUE(storage.getView("быстрые", rows));
+	EXPECT_TRUE(rows.empty());
+	EXPECT_TRUE(storage.dropView("быстрые"));
+	EXPECT_FALSE(storage.getView("быстрые", rows));
+	EXPECT_EQ(storage.getViewNames().size(), 1);
+}
+
+/// Тестирование постраничного доступа к представлению: размер и страницы без копирования всех строк
+TEST(MenuStorageTest, ViewPages) {
+	MenuStorage storage;
+	for (int i = 0; i < 25; ++i) {
+		storage.addDish("Блюдо " + std::string(1, static_cast<char>('a' + i)), 1.0 + i, Time(0, 10));
+	}
+	storage.defineView("дешевые", DishPredicate::priceBelow(21.0));
+
+	size_t size = 0;
+	ASSERT_TRUE(storage.getViewSize("дешевые", size));
+	EXPECT_EQ(size, 20);
+	EXPECT_FALSE(storage.getViewSize("нет", size));
+
+	std::vector<Dish> all;
+	ASSERT_TRUE(storage.getView("дешевые", all));
+	std::vector<Dish> rows;
+	for (size_t offset : { 0, 7, 12, 19 }) {
+		ASSERT_TRUE(storage.getViewRows("дешевые", offset, 5, rows));
+		ASSERT_EQ(rows.size(), std::min<size_t>(5, 20 - offset));
+		for (size_t i = 0; i < rows.size(); ++i) EXPECT_EQ(rows[i].name, all[offset + i].name);
+	}
+	ASSERT_TRUE(storage.getViewRows("дешевые", 20, 5, rows));
+	EXPECT_TRUE(rows.empty());
+	EXPECT_FALSE(storage.getViewRows("нет", 0, 5, rows));
+}
+
+/// Тестирование пакетного применения: удаления уплотняют меню, добавления вливаются по алфавиту
+TEST(MenuStorageTest, ApplyBatch) {
+	MenuStorage storage;
+	storage.addDish("Борщ", 7.0, Time(0, 40));
+	storage.addDish("Суп", 5.0, Time(0, 20));
+	storage.addDish("Суп", 5.0, Time(0, 20));
+	storage.addDish("Чай", 2.0, Time(0, 5));
+	storage.sortByName();
+	storage.defineView("быстрые", DishPredicate::timeBelow(Time(0, 30)));
+	uint64_t version = storage.getVersion();
+
+	std::vector<Dish> added = { Dish("Яблоко", 3.0, Time(0, 1)), Dish("Арбуз", 4.0, Time(0, 2)), Dish("Каша", 3.5, Time(0, 50)) };
+	size_t removed = storage.applyBatch(added, [](const Dish& dish) { return dish.name == "Суп"; });
+	EXPECT_EQ(removed, 2);
+
+	std::vector<std::string> names;
+	for (const auto& dish : storage.getDishes()) names.push_back(dish.name);
+	EXPECT_EQ(names, (std::vector<std::string>{ "Арбуз", "Борщ", "Каша", "Чай", "Яблоко" }));
+
+	// Индексы, статистика, представления и журнал следуют за изменениями
+	EXPECT_EQ(storage.getStats().count(), 5);
+	EXPECT_TRUE(storage.findNamesByPrefix("Су", 10).empty());
+	std::vector<Dish> rows;
+	ASSERT_TRUE(storage.getView("быстрые", rows));
+	EXPECT_EQ(rows.size(), 3);
+	std::vector<Dish> changed;
+	ASSERT_TRUE(storage.getChangesSince(version, changed));
+	EXPECT_EQ(changed.size(), 5);
+
+	// Без условия удаления меню только пополняется
+	EXPECT_EQ(storage.applyBatch({ Dish("Бульон", 4.0, Time(0, 30)) }, nullptr), 0);
+	EXPECT_EQ(storage.getDishes()[2].name, "Бульон");
+}
+
+/// Проверяет, что столбцы хранилища совпадают со строками блюд
+static void expectColumnsMatch(const MenuStorage& storage) {
+	const MenuColumns& columns = storage.getColumns();
+	const std::vector<Dish>& dishes = storage.getDishes();
+	ASSERT_EQ(columns.size(), dishes.size());
+	ASSERT_EQ(columns.minutes.size(), dishes.size());
+	for (size_t i = 0; i < dishes.size(); ++i) {
+		EXPECT_EQ(columns.prices[i], dishes[i].price);
+		EXPECT_EQ(columns.minutes[i], dishes[i].totalMinutes());
+	}
+}
+
+/// Тестирование столбцов цен и времени: следуют за добавлением, удалением, упорядочиванием и пакетами
+TEST(MenuStorageTest, ColumnsFollowChanges) {
+	MenuStorage storage;
+	storage.addDish("Чай", 2.0, Time(0, 5));
+	storage.addDish("Борщ", 7.0, Time(0, 40));
+	storage.addDish("Суп", 5.0, Time(0, 20));
+	expectColumnsMatch(storage);
+
+	storage.sortByName();
+	EXPECT_EQ(storage.getDishes().front().name, "Борщ");
+	expectColumnsMatch(storage);
+
+	// Одно новое блюдо переносится на место сдвигом
+	storage.addDish("Каша", 3.5, Time(0, 50));
+	storage.sortByName();
+	EXPECT_EQ(storage.getDishes()[1].name, "Каша");
+	expectColumnsMatch(storage);
+
+	EXPECT_TRUE(storage.removeDish("Борщ", 7.0, Time(0, 40)));
+	expectColumnsMatch(storage);
+
+	// Неупорядоченный хвост досортировывается перед слиянием пакета
+	storage.addDish("Яблоко", 3.0, Time(0, 1));
+	storage.addDish("Арбуз", 4.0, Time(0, 2));
+	storage.applyBatch({ Dish("Бульон", 4.0, Time(0, 30)) }, [](const Dish& dish) { return dish.name == "Суп"; });
+	std::vector<std::string> names;
+	for (const auto& dish : storage.getDishes()) names.push_back(dish.name);
+	EXPECT_EQ(names, (std::vector<std::string>{ "Арбуз", "Бульон", "Каша", "Чай", "Яблоко" }));
+	expectColumnsMatch(storage);
+
+	// Фильтр, привязанный к хранилищу, отбирает по его столбцам то же, что и без них
+	MenuFilter bound(std::make_unique<MenuSorter>(), &storage);
+	MenuFilter unbound(std::make_unique<MenuSorter>());
+	EXPECT_EQ(bound.filterByPriceAndTime(storage.getDishes(), 4.0, Time(0, 40)).size(), 2);
+	EXPECT_EQ(bound.filterByPrice(storage.getDishes(), 4.0).size(), unbound.filterByPrice(storage.getDishes(), 4.0).size());
+
+	storage.clear();
+	expectColumnsMatch(storage);
+}
+
+/// Тестирование пакетной загрузки: индексы, агрегаты, представления и столбцы заполнены, журнал начат заново
+TEST(MenuStorageTest, AddDishesInBulk) {
+	MenuStorage storage;
+	storage.defineView("дешевые", DishPredicate::priceBelow(4.0));
+	storage.addDish("Чай", 2.0, Time(0, 5));
+	uint64_t version = storage.getVersion();
+
+	storage.addDishes({ Dish("Борщ", 7.0, Time(0, 40)), Dish("Каша", 3.5, Time(0, 50)), Dish("Чай", 2.0, Time(0, 5)) });
+	EXPECT_EQ(storage.getDishesCount(), 4);
+	EXPECT_GT(storage.getVersion(), version);
+	std::vector<Dish> changed;
+	EXPECT_FALSE(storage.getChangesSince(version, changed));
+	EXPECT_TRUE(storage.getChangesSince(storage.getVersion(), changed));
+
+	EXPECT_EQ(storage.findNamesByPrefix("Ча", 10), (std::vector<std::string>{ "Чай" }));
+	EXPECT_EQ(storage.findNamesByPrefix("Бо", 10), (std::vector<std::string>{ "Борщ" }));
+	EXPECT_EQ(storage.getStats().count(), 4);
+	EXPECT_DOUBLE_EQ(storage.getStats().maxPrice(), 7.0);
+	EXPECT_EQ(storage.getStats().maxMinutes(), 50);
+	std::vector<Dish> rows;
+	ASSERT_TRUE(storage.getView("дешевые", rows));
+	EXPECT_EQ(rows.size(), 3);
+	expectColumnsMatch(storage);
+
+	storage.sortByName();
+	EXPECT_EQ(storage.getDishes().front().name, "Борщ");
+	expectColumnsMatch(storage);
+	EXPECT_TRUE(storage.removeDish("Чай", 2.0, Time(0, 5)));
+	EXPECT_TRUE(storage.findNamesByPrefix("Ча", 10).empty());
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+﻿#include <gtest/gtest.h>
+#include "../RestaurantMenu/write_ahead_log.h"
+#include "../RestaurantMenu/storage.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+// Удаляет все файлы журнала с указанным путем
+static void removeWalFiles(const std::string& base) {
+	for (const auto& entry : std::filesystem::directory_iterator(".")) {
+		std::string name = entry.path().filename().string();
+		if (name.compare(0, base.size() + 1, base + ".") == 0) std::filesystem::remove(entry.path());
+	}
+}
+
+// Применяет изменение к хранилищу и записывает его в журнал, как это делает приложение
+static void addLogged(MenuStorage& storage, WriteAheadLog& wal, const std::string& name, double price, const Time& time) {
+	storage.addDish(name, price, time);
+	wal.logAdd(name, price, time);
+}
+
+/// Тестирование восстановления: снимок плюс записи журнала дают то же меню
+TEST(WriteAheadLogTest, RecoverSnapshotAndLog) {
+	const std::string base = "test_wal_menu";
+	removeWalFiles(base);
+
+	MenuStorage storage;
+	storage.addDish("Борщ", 12.0, Time(0, 45));
+	{
+		WriteAheadLog::Recovery recovery;
+		WriteAheadLog wal(base, storage, recovery);
+		EXPECT_FALSE(recovery.found);
+
+		addLogged(storage, wal, "Чай", 2.5, Time(0, 5));
+		addLogged(storage, wal, "Чай", 3.0, Time(0, 5));
+		addLogged(storage, wal, "Суп", 8.0, Time(0, 30));
+		storage.removeDish("Суп", 8.0, Time(0, 30));
+		wal.logRemove("Суп", 8.0, Time(0, 30));
+		storage.removeDish("Чай", 2.5, Time(0, 5));
+		storage.removeDish("Чай", 3.0, Time(0, 5));
+		wal.logRemoveName("Чай");
+		addLogged(storage, wal, "Утка", 40.0, Time(2, 0, 1));
+		EXPECT_TRUE(wal.sync());
+		EXPECT_EQ(wal.getStatus().records, 6u);
+	}
+
+	MenuStorage recovered;
+	WriteAheadLog::Recovery recovery = WriteAheadLog::recover(base, recovered);
+	EXPECT_TRUE(recovery.found);
+	EXPECT_FALSE(recovery.tornTail);
+	EXPECT_EQ(recovery.snapshotDishes, 1u);
+	EXPECT_EQ(recovery.replayed, 6u);
+	ASSERT_EQ(recovered.getDishesCount(), 2u);
+	EXPECT_EQ(recovered.getDishes()[0].name, "Борщ");
+	EXPECT_EQ(recovered.getDishes()[1].name, "Утка");
+	EXPECT_TRUE(recovered.getDishes()[1].time == Time(2, 0, 1));
+	removeWalFiles(base);
+}
+
+/// Тестирование отбрасывания оборванной записи в конце журнала
+TEST(WriteAheadLogTest, TornTail) {
+	const std::string base = "test_wal_torn";
+	removeWalFiles(base);
+
+	MenuStorage storage;
+	uint64_t generation = 0;
+	{
+		WriteAheadLog::Recovery recovery;
+		WriteAheadLog wal(base, storage, recovery);
+		addLogged(storage, wal, "Чай", 2.5, Time(0, 5));
+		generation = wal.getStatus().generation;
+	}
+
+	// Половина следующей записи, как при сбое посередине записи
+	std::string record;
+	WriteAheadLog::encodeRecord(record, WalRecordType::Add, "Кофе", 3.0, 10);
+	std::ofstream(base + ".wal." + std::to_string(generation), std::ios::binary | std::ios::app)
+		.write(record.data(), record.size() / 2);
+
+	MenuStorage recovered;
+	WriteAheadLog::Recovery recovery = WriteAheadLog::recover(base, recovered);
+	EXPECT_TRUE(recovery.tornTail);
+	EXPECT_EQ(recovery.replayed, 1u);
+	ASSERT_EQ(recovered.getDishesCount(), 1u);
+	EXPECT_EQ(recovered.getDishes()[0].name, "Чай");
+
+	// Повторное открытие начинает чистое поколение, и новые записи восстанавливаются
+	{
+		WriteAheadLog::Recovery reopened;
+		WriteAheadLog wal(base, recovered, reopened);
+		EXPECT_TRUE(reopened.tornTail);
+		addLogged(recovered, wal, "Кофе", 3.0, Time(0, 10));
+	}
+	MenuStorage final;
+	EXPECT_FALSE(WriteAheadLog::recover(base, final).tornTail);
+	EXPECT_EQ(final.getDishesCount(), 2u);
+	removeWalFiles(base);
+}
+
+/// Тестирование уплотнения: новое поколение со снимком, старые файлы удаляются
+TEST(WriteAheadLogTest, Compaction) {
+	const std::string base = "test_wal_compact";
+	removeWalFiles(base);
+
+	MenuStorage storage;
+	uint64_t generation = 0;
+	{
+		WriteAheadLog::Recovery recovery;
+		WriteAheadLog wal(base, storage, recovery);
+		addLogged(storage, wal, "Чай", 2.5, Time(0, 5));
+		generation = wal.getStatus().generation;
+
+		wal.compact(storage.getDishes());
+		addLogged(storage, wal, "Кофе", 3.0, Time(0, 10));
+		EXPECT_EQ(wal.getStatus().generation, generation + 1);
+		EXPECT_EQ(wal.getStatus().records, 1u);
+	}
+
+	EXPECT_FALSE(std::ifstream(base + ".wal." + std::to_string(generation)).is_open());
+	EXPECT_FALSE(std::ifstream(base + ".snap." + std::to_string(generation)).is_open());
+
+	MenuStorage recovered;
+	WriteAheadLog::Recovery recovery = WriteAheadLog::recover(base, recovered);
+	EXPECT_EQ(recovery.generation, generation + 1);
+	EXPECT_EQ(recovery.snapshotDishes, 1u);
+	EXPECT_EQ(recovery.replayed, 1u);
+	EXPECT_EQ(recovered.getDishesCount(), 2u);
+	removeWalFiles(base);
+}
\ No newline at end of file